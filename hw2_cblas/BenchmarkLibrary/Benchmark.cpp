@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include "Benchmark.h"
+
+namespace benchmark_library {
+
+    namespace {
+        /**
+         * @brief Квантиль отсортированной выборки с линейной интерполяцией между соседними элементами.
+         * @param sorted Отсортированная по возрастанию выборка.
+         * @param level Уровень квантиля от 0 до 1.
+         * @return Значение квантиля.
+         */
+        double quantile(const std::vector<double>& sorted, double level) {
+            if (sorted.empty()) {
+                return 0.0;
+            }
+            double position = level * static_cast<double>(sorted.size() - 1);
+            auto lower = static_cast<size_t>(std::floor(position));
+            auto upper = static_cast<size_t>(std::ceil(position));
+            double fraction = position - static_cast<double>(lower);
+            return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+        }
+
+        /**
+         * @brief Экранировать строку для записи в JSON.
+         * @param value Исходная строка.
+         * @return Строка в кавычках.
+         */
+        std::string json_string(const std::string& value) {
+            std::string result = "\"";
+            for (char symbol: value) {
+                if (symbol == '"' || symbol == '\\') {
+                    result += '\\';
+                }
+                result += symbol;
+            }
+            return result + "\"";
+        }
+    }
+
+    BenchmarkStatistics BenchmarkStatistics::from_samples(std::vector<double> samples_us) {
+        BenchmarkStatistics statistics;
+        if (samples_us.empty()) {
+            return statistics;
+        }
+        std::sort(samples_us.begin(), samples_us.end());
+
+        statistics.min_us = samples_us.front();
+        statistics.median_us = quantile(samples_us, 0.5);
+        statistics.p90_us = quantile(samples_us, 0.9);
+        statistics.mean_us = std::accumulate(samples_us.begin(), samples_us.end(), 0.0) / static_cast<double>(samples_us.size());
+
+        if (samples_us.size() > 1) {
+            double squares = 0.0;
+            for (auto sample: samples_us) {
+                squares += (sample - statistics.mean_us) * (sample - statistics.mean_us);
+            }
+            statistics.stddev_us = std::sqrt(squares / static_cast<double>(samples_us.size() - 1));
+        }
+        return statistics;
+    }
+
+    double BenchmarkRecord::gflops() const {
+        if (statistics.median_us <= 0.0) {
+            return 0.0;
+        }
+        return flop_count / statistics.median_us / 1e3;
+    }
+
+    double BenchmarkRecord::gbytes_per_second() const {
+        if (statistics.median_us <= 0.0) {
+            return 0.0;
+        }
+        return byte_count / statistics.median_us / 1e3;
+    }
+
+    BenchmarkRunner::BenchmarkRunner(size_t warmup_count, size_t repetition_count) :
+            warmup_count_(warmup_count),
+            repetition_count_(repetition_count) {
+        assert(repetition_count_ > 0);
+    }
+
+    const BenchmarkRecord& BenchmarkRunner::run(const std::string &kernel, size_t size, size_t threads,
+                                                double flop_count, double byte_count,
+                                                const std::function<void()> &workload) {
+        BenchmarkRecord record;
+        record.kernel = kernel;
+        record.size = size;
+        record.threads = threads;
+        record.warmup_count = warmup_count_;
+        record.repetition_count = repetition_count_;
+        record.flop_count = flop_count;
+        record.byte_count = byte_count;
+
+        for (size_t i = 0; i < warmup_count_; ++i) {
+            workload();
+        }
+
+        // счётчики открываются после прогрева, когда пул потоков OMP уже создан
+        std::unique_ptr<PerfCounters> counters;
+        if (perf_counters_enabled_) {
+            counters = std::make_unique<PerfCounters>();
+            counters->start();
+        }
+
+        record.samples_us.reserve(repetition_count_);
+        for (size_t i = 0; i < repetition_count_; ++i) {
+            auto begin = std::chrono::steady_clock::now();
+            workload();
+            auto end = std::chrono::steady_clock::now();
+            record.samples_us.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+        }
+        record.statistics = BenchmarkStatistics::from_samples(record.samples_us);
+
+        if (counters) {
+            counters->stop();
+            auto totals = counters->read();
+            totals.flops = flop_count * static_cast<double>(repetition_count_);
+            totals.duration_us = std::accumulate(record.samples_us.begin(), record.samples_us.end(), 0.0);
+            PerfProfiler::instance().record(kernel, totals);
+
+            record.has_counters = true;
+            record.counters = totals / static_cast<double>(repetition_count_);
+        }
+
+        records_.push_back(std::move(record));
+        return records_.back();
+    }
+
+    void BenchmarkRunner::set_perf_counters_enabled(bool enabled) {
+        perf_counters_enabled_ = enabled;
+    }
+
+    const std::vector<BenchmarkRecord>& BenchmarkRunner::get_records() const {
+        return records_;
+    }
+
+    void BenchmarkRunner::write(std::ostream &stream, OutputFormat format, const std::string &label) const {
+        switch (format) {
+            case OutputFormat::TABLE:
+                write_table(stream);
+                break;
+            case OutputFormat::JSON:
+                write_json(stream, label);
+                break;
+            case OutputFormat::CSV:
+                write_csv(stream);
+                break;
+        }
+    }
+
+    void BenchmarkRunner::write_table(std::ostream &stream) const {
+        std::ios state(nullptr);
+        state.copyfmt(stream);
+
+        stream << std::left << std::setw(16) << "kernel" << std::right
+               << std::setw(8) << "size" << std::setw(8) << "threads"
+               << std::setw(14) << "median, ms" << std::setw(14) << "p90, ms"
+               << std::setw(14) << "min, ms" << std::setw(14) << "stddev, ms"
+               << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s";
+        if (perf_counters_enabled_) {
+            stream << std::setw(8) << "IPC" << std::setw(14) << "LLC misses" << std::setw(14) << "dTLB misses"
+                   << std::setw(10) << "FLOP/B";
+        }
+        stream << std::endl;
+        stream << std::fixed << std::setprecision(3);
+        for (const auto &record: records_) {
+            stream << std::left << std::setw(16) << record.kernel << std::right
+                   << std::setw(8) << record.size << std::setw(8) << record.threads
+                   << std::setw(14) << record.statistics.median_us / 1e3
+                   << std::setw(14) << record.statistics.p90_us / 1e3
+                   << std::setw(14) << record.statistics.min_us / 1e3
+                   << std::setw(14) << record.statistics.stddev_us / 1e3
+                   << std::setw(10) << record.gflops()
+                   << std::setw(10) << record.gbytes_per_second();
+            if (record.has_counters) {
+                stream << std::setw(8) << record.counters.ipc()
+                       << std::setw(14) << record.counters.llc_misses
+                       << std::setw(14) << record.counters.dtlb_misses
+                       << std::setw(10) << record.counters.arithmetic_intensity();
+            }
+            stream << std::endl;
+        }
+
+        stream.copyfmt(state);
+    }
+
+    void BenchmarkRunner::write_json(std::ostream &stream, const std::string &label) const {
+        std::ios state(nullptr);
+        state.copyfmt(stream);
+        stream << std::setprecision(10);
+
+        auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+        stream << "{\n";
+        stream << "  \"label\": " << json_string(label) << ",\n";
+        stream << "  \"timestamp\": " << timestamp << ",\n";
+        stream << "  \"results\": [";
+        for (size_t i = 0; i < records_.size(); ++i) {
+            const auto &record = records_[i];
+            stream << (i == 0 ? "\n" : ",\n");
+            stream << "    {\"kernel\": " << json_string(record.kernel)
+                   << ", \"size\": " << record.size
+                   << ", \"threads\": " << record.threads
+                   << ", \"warmup\": " << record.warmup_count
+                   << ", \"repetitions\": " << record.repetition_count
+                   << ", \"median_us\": " << record.statistics.median_us
+                   << ", \"p90_us\": " << record.statistics.p90_us
+                   << ", \"min_us\": " << record.statistics.min_us
+                   << ", \"mean_us\": " << record.statistics.mean_us
+                   << ", \"stddev_us\": " << record.statistics.stddev_us
+                   << ", \"gflops\": " << record.gflops()
+                   << ", \"gbytes_per_second\": " << record.gbytes_per_second();
+            if (record.has_counters) {
+                stream << ", \"counters\": {\"cycles\": " << record.counters.cycles
+                       << ", \"instructions\": " << record.counters.instructions
+                       << ", \"llc_misses\": " << record.counters.llc_misses
+                       << ", \"dtlb_misses\": " << record.counters.dtlb_misses
+                       << ", \"flops\": " << record.counters.flops
+                       << ", \"ipc\": " << record.counters.ipc()
+                       << ", \"arithmetic_intensity\": " << record.counters.arithmetic_intensity() << "}";
+            }
+            stream << ", \"samples_us\": [";
+            for (size_t j = 0; j < record.samples_us.size(); ++j) {
+                stream << (j == 0 ? "" : ", ") << record.samples_us[j];
+            }
+            stream << "]}";
+        }
+        stream << "\n  ]\n}" << std::endl;
+
+        stream.copyfmt(state);
+    }
+
+    void BenchmarkRunner::write_csv(std::ostream &stream) const {
+        std::ios state(nullptr);
+        state.copyfmt(stream);
+        stream << std::setprecision(10);
+
+        stream << "kernel,size,threads,warmup,repetitions,median_us,p90_us,min_us,mean_us,stddev_us,gflops,gbytes_per_second,"
+                  "cycles,instructions,llc_misses,dtlb_misses,ipc,arithmetic_intensity" << std::endl;
+        for (const auto &record: records_) {
+            stream << record.kernel << ","
+                   << record.size << ","
+                   << record.threads << ","
+                   << record.warmup_count << ","
+                   << record.repetition_count << ","
+                   << record.statistics.median_us << ","
+                   << record.statistics.p90_us << ","
+                   << record.statistics.min_us << ","
+                   << record.statistics.mean_us << ","
+                   << record.statistics.stddev_us << ","
+                   << record.gflops() << ","
+                   << record.gbytes_per_second() << ",";
+            if (record.has_counters) {
+                stream << record.counters.cycles << ","
+                       << record.counters.instructions << ","
+                       << record.counters.llc_misses << ","
+                       << record.counters.dtlb_misses << ","
+                       << record.counters.ipc() << ","
+                       << record.counters.arithmetic_intensity();
+            } else {
+                stream << ",,,,,";
+            }
+            stream << std::endl;
+        }
+
+        stream.copyfmt(state);
+    }
+
+    OutputFormat parse_output_format(const std::string &name) {
+        if (name == "table") {
+            return OutputFormat::TABLE;
+        }
+        if (name == "json") {
+            return OutputFormat::JSON;
+        }
+        if (name == "csv") {
+            return OutputFormat::CSV;
+        }
+        throw std::invalid_argument("Unknown output format: " + name);
+    }
+
+    std::vector<size_t> parse_size_list(const std::string &list) {
+        std::vector<size_t> values;
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            auto range_position = item.find("..");
+            if (range_position == std::string::npos) {
+                values.push_back(std::stoul(item));
+                continue;
+            }
+            size_t first = std::stoul(item.substr(0, range_position));
+            size_t last = std::stoul(item.substr(range_position + 2));
+            for (size_t value = first; value <= last; ++value) {
+                values.push_back(value);
+            }
+        }
+        return values;
+    }
+}
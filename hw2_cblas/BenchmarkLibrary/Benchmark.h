@@ -0,0 +1,174 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_BENCHMARK_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_BENCHMARK_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "PerfCounters.h"
+
+/**
+ * @brief Пространство имён, объединяющее замеры производительности вычислительных ядер.
+ */
+namespace benchmark_library {
+
+    /**
+     * @brief Формат вывода результатов замеров.
+     */
+    enum class OutputFormat {
+        TABLE,  // человекочитаемая таблица
+        JSON,  // для сохранения и сравнения между коммитами
+        CSV  // для таблиц и графиков
+    };
+
+    /**
+     * @brief Статистики по выборке длительностей запусков. Все значения в микросекундах.
+     */
+    struct BenchmarkStatistics {
+        double min_us{0.0};
+        double median_us{0.0};
+        double p90_us{0.0};
+        double mean_us{0.0};
+        double stddev_us{0.0};
+
+        /**
+         * @brief Посчитать статистики по выборке.
+         * @param samples_us Длительности запусков в микросекундах.
+         * @return Статистики выборки.
+         */
+        static BenchmarkStatistics from_samples(std::vector<double> samples_us);
+    };
+
+    /**
+     * @brief Результат замера одного ядра при фиксированных размере задачи и количестве потоков.
+     */
+    struct BenchmarkRecord {
+        std::string kernel;
+        size_t size{0};
+        size_t threads{1};
+        size_t warmup_count{0};
+        size_t repetition_count{0};
+        /**
+         * @brief Количество операций с плавающей точкой за один запуск. Ноль, если неизвестно.
+         */
+        double flop_count{0.0};
+        /**
+         * @brief Минимальный объём данных, передаваемых из памяти за один запуск. Ноль, если неизвестно.
+         */
+        double byte_count{0.0};
+        std::vector<double> samples_us;
+        BenchmarkStatistics statistics;
+        /**
+         * @brief True, если во время замера снимались аппаратные счётчики.
+         */
+        bool has_counters{false};
+        /**
+         * @brief Значения аппаратных счётчиков в среднем на один запуск.
+         */
+        PerfCounterValues counters;
+
+        /**
+         * @brief Производительность по медианному запуску.
+         * @return GFLOP/s или ноль, если количество операций неизвестно.
+         */
+        double gflops() const;
+
+        /**
+         * @brief Пропускная способность по медианному запуску.
+         * @return GB/s или ноль, если объём данных неизвестен.
+         */
+        double gbytes_per_second() const;
+    };
+
+    /**
+     * @brief Запускает вычислительные ядра с прогревом и повторениями, накапливает результаты.
+     */
+    class BenchmarkRunner {
+    public:
+        /**
+         * @brief Конструктор.
+         * @param warmup_count Количество прогревочных запусков, которые не попадают в статистику.
+         * @param repetition_count Количество замеряемых запусков.
+         */
+        explicit BenchmarkRunner(size_t warmup_count = 1, size_t repetition_count = 5);
+
+        /**
+         * @brief Замерить ядро.
+         * @details Подготовку данных нужно сделать до вызова, замеряется только workload целиком.
+         * @param kernel Имя ядра.
+         * @param size Размер задачи.
+         * @param threads Количество потоков, с которым запускается ядро.
+         * @param flop_count Количество операций с плавающей точкой за запуск.
+         * @param byte_count Объём данных, передаваемых из памяти за запуск.
+         * @param workload Замеряемая функция.
+         * @return Ссылка на сохранённый результат замера.
+         */
+        const BenchmarkRecord& run(const std::string& kernel, size_t size, size_t threads,
+                                   double flop_count, double byte_count, const std::function<void()>& workload);
+
+        /**
+         * @brief Снимать аппаратные счётчики во время замеряемых запусков.
+         * @details Значения счётчиков попадают в результаты замеров и в трассу PerfProfiler.
+         * @param enabled True, если счётчики нужны.
+         */
+        void set_perf_counters_enabled(bool enabled);
+
+        /**
+         * @brief Получить все накопленные результаты.
+         * @return Результаты в порядке запуска.
+         */
+        const std::vector<BenchmarkRecord>& get_records() const;
+
+        /**
+         * @brief Напечатать результаты в заданном формате.
+         * @param stream Поток вывода.
+         * @param format Формат вывода.
+         * @param label Метка запуска (например, хэш коммита). Попадает только в JSON.
+         */
+        void write(std::ostream& stream, OutputFormat format, const std::string& label = "") const;
+
+        /**
+         * @brief Напечатать результаты человекочитаемой таблицей.
+         * @param stream Поток вывода.
+         */
+        void write_table(std::ostream& stream = std::cout) const;
+
+        /**
+         * @brief Напечатать результаты в формате JSON.
+         * @param stream Поток вывода.
+         * @param label Метка запуска.
+         */
+        void write_json(std::ostream& stream, const std::string& label = "") const;
+
+        /**
+         * @brief Напечатать результаты в формате CSV. Одна строка - один замер.
+         * @param stream Поток вывода.
+         */
+        void write_csv(std::ostream& stream) const;
+
+    private:
+        size_t warmup_count_;
+        size_t repetition_count_;
+        bool perf_counters_enabled_{false};
+        std::vector<BenchmarkRecord> records_;
+    };
+
+    /**
+     * @brief Разобрать имя формата вывода: table, json или csv.
+     * @param name Имя формата.
+     * @return Формат вывода.
+     */
+    OutputFormat parse_output_format(const std::string& name);
+
+    /**
+     * @brief Разобрать список размеров для перебора.
+     * @details Поддерживаются перечисление через запятую "256,512,1024" и диапазон "1..8".
+     * @details Их можно смешивать: "1..4,8,16".
+     * @param list Строка со списком.
+     * @return Список значений в порядке записи.
+     */
+    std::vector<size_t> parse_size_list(const std::string& list);
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_BENCHMARK_H
@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "PerfCounters.h"
+
+namespace benchmark_library {
+
+    namespace {
+        /**
+         * @brief Размер кэш-линии, которым измеряется трафик по промахам последнего уровня кэша.
+         */
+        const double CACHE_LINE_SIZE = 64.0;
+
+        /**
+         * @brief Сложить значения счётчиков с учётом того, что отрицательное значение означает недоступный счётчик.
+         */
+        void add_counter(int64_t& lhs, int64_t rhs) {
+            if (rhs < 0) {
+                return;
+            }
+            lhs = (lhs < 0) ? rhs : lhs + rhs;
+        }
+
+        /**
+         * @brief Разность значений счётчика с учётом того, что отрицательное значение означает недоступный счётчик.
+         */
+        int64_t subtract_counter(int64_t end, int64_t begin) {
+            if (end < 0 || begin < 0) {
+                return -1;
+            }
+            return std::max<int64_t>(end - begin, 0);
+        }
+
+        int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+#ifdef __linux__
+        /**
+         * @brief Отслеживаемые события в порядке полей PerfCounterValues.
+         */
+        const std::vector<std::pair<uint32_t, uint64_t>> EVENTS = {
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        };
+
+        int open_event(uint32_t type, uint64_t config, pid_t thread_id) {
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            attributes.type = type;
+            attributes.config = config;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, thread_id, -1, -1, 0));
+        }
+#endif
+    }
+
+    double PerfCounterValues::ipc() const {
+        if (cycles <= 0 || instructions < 0) {
+            return -1.0;
+        }
+        return static_cast<double>(instructions) / static_cast<double>(cycles);
+    }
+
+    double PerfCounterValues::arithmetic_intensity() const {
+        if (llc_misses <= 0 || flops <= 0.0) {
+            return -1.0;
+        }
+        return flops / (static_cast<double>(llc_misses) * CACHE_LINE_SIZE);
+    }
+
+    PerfCounterValues &PerfCounterValues::operator+=(const PerfCounterValues &rhs) {
+        add_counter(cycles, rhs.cycles);
+        add_counter(instructions, rhs.instructions);
+        add_counter(llc_misses, rhs.llc_misses);
+        add_counter(dtlb_misses, rhs.dtlb_misses);
+        flops += rhs.flops;
+        duration_us += rhs.duration_us;
+        return *this;
+    }
+
+    PerfCounterValues PerfCounterValues::operator/(double divisor) const {
+        auto divide = [divisor](int64_t counter) {
+            return counter < 0 ? counter : static_cast<int64_t>(static_cast<double>(counter) / divisor);
+        };
+        PerfCounterValues result;
+        result.cycles = divide(cycles);
+        result.instructions = divide(instructions);
+        result.llc_misses = divide(llc_misses);
+        result.dtlb_misses = divide(dtlb_misses);
+        result.flops = flops / divisor;
+        result.duration_us = duration_us / divisor;
+        return result;
+    }
+
+    PerfCounters::PerfCounters() {
+        update_threads();
+    }
+
+    PerfCounters::~PerfCounters() {
+#ifdef __linux__
+        for (const auto &[thread_id, thread_descriptors]: descriptors_) {
+            for (auto descriptor: thread_descriptors) {
+                if (descriptor >= 0) {
+                    close(descriptor);
+                }
+            }
+        }
+#endif
+    }
+
+    void PerfCounters::update_threads() {
+#ifdef __linux__
+        std::vector<int64_t> thread_ids;
+        std::error_code error;
+        for (const auto &entry: std::filesystem::directory_iterator("/proc/self/task", error)) {
+            thread_ids.push_back(std::stoll(entry.path().filename().string()));
+        }
+        std::sort(thread_ids.begin(), thread_ids.end());
+
+        for (auto it = descriptors_.begin(); it != descriptors_.end();) {
+            if (std::binary_search(thread_ids.begin(), thread_ids.end(), it->first)) {
+                ++it;
+                continue;
+            }
+            for (auto descriptor: it->second) {
+                if (descriptor >= 0) {
+                    close(descriptor);
+                }
+            }
+            it = descriptors_.erase(it);
+        }
+
+        for (auto thread_id: thread_ids) {
+            if (descriptors_.count(thread_id) > 0) {
+                continue;
+            }
+            auto &thread_descriptors = descriptors_[thread_id];
+            for (const auto &[type, config]: EVENTS) {
+                int descriptor = open_event(type, config, static_cast<pid_t>(thread_id));
+                if (descriptor >= 0 && running_) {
+                    ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+                }
+                thread_descriptors.push_back(descriptor);
+            }
+        }
+#endif
+    }
+
+    void PerfCounters::start() {
+#ifdef __linux__
+        for (const auto &[thread_id, thread_descriptors]: descriptors_) {
+            for (auto descriptor: thread_descriptors) {
+                if (descriptor >= 0) {
+                    ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+        }
+#endif
+        running_ = true;
+    }
+
+    void PerfCounters::stop() {
+#ifdef __linux__
+        for (const auto &[thread_id, thread_descriptors]: descriptors_) {
+            for (auto descriptor: thread_descriptors) {
+                if (descriptor >= 0) {
+                    ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+        }
+#endif
+        running_ = false;
+    }
+
+    PerfCounterValues PerfCounters::read() const {
+        std::vector<int64_t> totals(4, -1);
+#ifdef __linux__
+        for (const auto &[thread_id, thread_descriptors]: descriptors_) {
+            for (size_t i = 0; i < thread_descriptors.size(); ++i) {
+                uint64_t buffer[3] = {0, 0, 0};  // значение, время включения, время работы
+                if (thread_descriptors[i] < 0 ||
+                    ::read(thread_descriptors[i], buffer, sizeof(buffer)) != sizeof(buffer)) {
+                    continue;
+                }
+                double value = static_cast<double>(buffer[0]);
+                if (buffer[2] > 0 && buffer[2] < buffer[1]) {  // событие мультиплексировалось
+                    value *= static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]);
+                }
+                add_counter(totals[i], static_cast<int64_t>(value));
+            }
+        }
+#endif
+        PerfCounterValues values;
+        values.cycles = totals[0];
+        values.instructions = totals[1];
+        values.llc_misses = totals[2];
+        values.dtlb_misses = totals[3];
+        return values;
+    }
+
+    bool PerfCounters::is_available() const {
+        for (const auto &[thread_id, thread_descriptors]: descriptors_) {
+            for (auto descriptor: thread_descriptors) {
+                if (descriptor >= 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    namespace {
+        /**
+         * @brief Счётчики потока, создающего области.
+         * @details Открываются и запускаются при первой области в потоке и дальше не сбрасываются.
+         */
+        PerfCounters &thread_counters() {
+            thread_local PerfCounters counters;
+            thread_local bool started = false;
+            if (!started) {
+                counters.start();
+                started = true;
+            }
+            return counters;
+        }
+    }
+
+    PerfProfiler &PerfProfiler::instance() {
+        static PerfProfiler profiler;
+        return profiler;
+    }
+
+    PerfProfiler::PerfProfiler() {
+        const char *enabled = std::getenv("HPC_PERF_COUNTERS");
+        enabled_ = (enabled != nullptr) && (std::string(enabled) == "1");
+        const char *trace_path = std::getenv("HPC_PERF_TRACE");
+        if (trace_path != nullptr) {
+            trace_path_ = trace_path;
+        }
+    }
+
+    PerfProfiler::~PerfProfiler() {
+        if (trace_path_.empty() || events_.empty()) {
+            return;
+        }
+        std::ofstream trace(trace_path_);
+        write_trace(trace);
+    }
+
+    void PerfProfiler::set_enabled(bool enabled) {
+        enabled_ = enabled;
+    }
+
+    bool PerfProfiler::is_enabled() const {
+        return enabled_;
+    }
+
+    void PerfProfiler::set_trace_path(const std::string &path) {
+        trace_path_ = path;
+    }
+
+    void PerfProfiler::record(const std::string &name, const PerfCounterValues &values) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.emplace_back(name, values);
+    }
+
+    std::map<std::string, PerfRegionSummary> PerfProfiler::get_summaries() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, PerfRegionSummary> summaries;
+        for (const auto &[name, values]: events_) {
+            auto &summary = summaries[name];
+            ++summary.calls_count;
+            summary.totals += values;
+        }
+        return summaries;
+    }
+
+    void PerfProfiler::write_trace(std::ostream &stream) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stream << "region,duration_us,cycles,instructions,llc_misses,dtlb_misses,flops,ipc,arithmetic_intensity" << std::endl;
+        for (const auto &[name, values]: events_) {
+            stream << name << ","
+                   << values.duration_us << ","
+                   << values.cycles << ","
+                   << values.instructions << ","
+                   << values.llc_misses << ","
+                   << values.dtlb_misses << ","
+                   << values.flops << ","
+                   << values.ipc() << ","
+                   << values.arithmetic_intensity() << std::endl;
+        }
+    }
+
+    void PerfProfiler::write_summary(std::ostream &stream) const {
+        std::ios state(nullptr);
+        state.copyfmt(stream);
+
+        stream << std::left << std::setw(24) << "region" << std::right
+               << std::setw(8) << "calls" << std::setw(14) << "time, ms"
+               << std::setw(16) << "cycles" << std::setw(16) << "instructions"
+               << std::setw(14) << "LLC misses" << std::setw(14) << "dTLB misses"
+               << std::setw(8) << "IPC" << std::setw(10) << "GFLOP/s" << std::setw(10) << "FLOP/B" << std::endl;
+        stream << std::fixed << std::setprecision(3);
+        for (const auto &[name, summary]: get_summaries()) {
+            const auto &totals = summary.totals;
+            double gflops = totals.duration_us > 0.0 ? totals.flops / totals.duration_us / 1e3 : 0.0;
+            stream << std::left << std::setw(24) << name << std::right
+                   << std::setw(8) << summary.calls_count
+                   << std::setw(14) << totals.duration_us / 1e3
+                   << std::setw(16) << totals.cycles
+                   << std::setw(16) << totals.instructions
+                   << std::setw(14) << totals.llc_misses
+                   << std::setw(14) << totals.dtlb_misses
+                   << std::setw(8) << totals.ipc()
+                   << std::setw(10) << gflops
+                   << std::setw(10) << totals.arithmetic_intensity() << std::endl;
+        }
+
+        stream.copyfmt(state);
+    }
+
+    PerfRegion::PerfRegion(std::string name, double flops) :
+            name_(std::move(name)),
+            flops_(flops) {
+        if (!PerfProfiler::instance().is_enabled()) {
+            return;
+        }
+        auto &counters = thread_counters();
+        counters.update_threads();  // потоки OMP могли появиться после предыдущей области
+        active_ = true;
+        begin_ns_ = now_ns();
+        begin_values_ = counters.read();
+    }
+
+    PerfRegion::~PerfRegion() {
+        if (!active_) {
+            return;
+        }
+        const auto end_values = thread_counters().read();
+        PerfCounterValues values;
+        values.cycles = subtract_counter(end_values.cycles, begin_values_.cycles);
+        values.instructions = subtract_counter(end_values.instructions, begin_values_.instructions);
+        values.llc_misses = subtract_counter(end_values.llc_misses, begin_values_.llc_misses);
+        values.dtlb_misses = subtract_counter(end_values.dtlb_misses, begin_values_.dtlb_misses);
+        values.duration_us = static_cast<double>(now_ns() - begin_ns_) / 1e3;
+        values.flops = flops_;
+        PerfProfiler::instance().record(name_, values);
+    }
+
+    void PerfRegion::add_flops(double flops) {
+        flops_ += flops;
+    }
+}
@@ -0,0 +1,202 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_PERFCOUNTERS_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace benchmark_library {
+
+    /**
+     * @brief Значения аппаратных счётчиков производительности.
+     * @details Отрицательное значение счётчика означает, что он недоступен
+     * @details (не Linux, запрещено настройкой perf_event_paranoid или не поддерживается процессором).
+     */
+    struct PerfCounterValues {
+        int64_t cycles{-1};
+        int64_t instructions{-1};
+        int64_t llc_misses{-1};
+        int64_t dtlb_misses{-1};
+        /**
+         * @brief Количество операций с плавающей точкой. Задаётся моделью ядра, а не счётчиком.
+         */
+        double flops{0.0};
+        double duration_us{0.0};
+
+        /**
+         * @brief Инструкций за такт.
+         * @return IPC или -1, если счётчики недоступны.
+         */
+        double ipc() const;
+
+        /**
+         * @brief Арифметическая интенсивность относительно основной памяти для модели Roofline.
+         * @details Каждый промах последнего уровня кэша считается как одна загруженная кэш-линия.
+         * @return FLOP на байт или -1, если счётчик промахов недоступен или модель ядра не задала количество операций.
+         */
+        double arithmetic_intensity() const;
+
+        PerfCounterValues& operator+=(const PerfCounterValues& rhs);
+        PerfCounterValues operator/(double divisor) const;
+    };
+
+    /**
+     * @brief Набор аппаратных счётчиков на основе Linux perf_event_open.
+     * @details Счётчики открываются отдельно для каждого потока процесса, существующего на момент создания объекта,
+     * @details и не наследуются потоками, которые он создаёт. Потоки, появившиеся позже, добавляются вызовом update_threads,
+     * @details поэтому каждый поток учитывается в сумме ровно один раз.
+     * @details Считаются только события пользовательского режима.
+     */
+    class PerfCounters {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        /**
+         * @brief Обнулить и запустить счётчики.
+         */
+        void start();
+
+        /**
+         * @brief Остановить счётчики.
+         */
+        void stop();
+
+        /**
+         * @brief Прочитать значения счётчиков с момента последнего запуска.
+         * @details Если событий больше, чем аппаратных регистров, ядро мультиплексирует их;
+         * @details значения масштабируются на долю времени, в течение которого событие реально считалось.
+         * @return Суммарные значения по всем потокам.
+         */
+        PerfCounterValues read() const;
+
+        /**
+         * @brief Открыть счётчики для потоков процесса, появившихся после создания объекта, и закрыть счётчики завершившихся.
+         * @details Если счётчики запущены, новые тоже запускаются. Значения завершившихся потоков из суммы пропадают.
+         */
+        void update_threads();
+
+        /**
+         * @brief Удалось ли открыть хотя бы один счётчик.
+         * @return True, если счётчики работают.
+         */
+        bool is_available() const;
+
+    private:
+        /**
+         * @brief Файловые дескрипторы событий: [поток][событие], -1 - событие не открылось.
+         */
+        std::map<int64_t, std::vector<int>> descriptors_;
+
+        bool running_{false};
+    };
+
+    /**
+     * @brief Накопленная статистика именованной области кода.
+     */
+    struct PerfRegionSummary {
+        size_t calls_count{0};
+        PerfCounterValues totals;
+    };
+
+    /**
+     * @brief Сборщик значений счётчиков по именованным областям кода.
+     * @details Выключен по умолчанию. Включается вызовом set_enabled или переменной окружения HPC_PERF_COUNTERS=1.
+     * @details Если задана переменная HPC_PERF_TRACE, при завершении программы в этот файл пишется трасса.
+     */
+    class PerfProfiler {
+    public:
+        /**
+         * @brief Получить единственный экземпляр.
+         * @return Ссылка на сборщик.
+         */
+        static PerfProfiler& instance();
+
+        ~PerfProfiler();
+
+        void set_enabled(bool enabled);
+        bool is_enabled() const;
+
+        /**
+         * @brief Задать файл трассы, который будет записан при завершении программы.
+         * @param path Путь к файлу. Пустая строка - не писать трассу.
+         */
+        void set_trace_path(const std::string& path);
+
+        /**
+         * @brief Сохранить измерение области.
+         * @param name Имя области.
+         * @param values Значения счётчиков.
+         */
+        void record(const std::string& name, const PerfCounterValues& values);
+
+        /**
+         * @brief Получить накопленную статистику по всем областям.
+         * @return Статистика по имени области.
+         */
+        std::map<std::string, PerfRegionSummary> get_summaries() const;
+
+        /**
+         * @brief Напечатать трассу: одна строка CSV на каждое измерение области.
+         * @param stream Поток вывода.
+         */
+        void write_trace(std::ostream& stream) const;
+
+        /**
+         * @brief Напечатать сводку по областям человекочитаемой таблицей.
+         * @param stream Поток вывода.
+         */
+        void write_summary(std::ostream& stream = std::cout) const;
+
+    private:
+        PerfProfiler();
+
+        bool enabled_{false};
+        std::string trace_path_;
+        mutable std::mutex mutex_;
+        std::vector<std::pair<std::string, PerfCounterValues>> events_;
+    };
+
+    /**
+     * @brief Именованная область кода, для которой снимаются аппаратные счётчики.
+     * @details RAII: значения счётчиков читаются в конструкторе и в деструкторе, разница сохраняется в PerfProfiler.
+     * @details Счётчики открываются один раз на поток, создавший область, и дальше только дочитываются,
+     * @details поэтому области можно создавать часто и вкладывать друг в друга.
+     * @details Если PerfProfiler выключен, объект ничего не делает.
+     * @details Не предназначена для вложения в параллельные области OMP: счётчики сами охватывают все потоки.
+     */
+    class PerfRegion {
+    public:
+        /**
+         * @brief Начать область.
+         * @param name Имя области.
+         * @param flops Количество операций с плавающей точкой, известное заранее.
+         */
+        explicit PerfRegion(std::string name, double flops = 0.0);
+        ~PerfRegion();
+
+        PerfRegion(const PerfRegion&) = delete;
+        PerfRegion& operator=(const PerfRegion&) = delete;
+
+        /**
+         * @brief Добавить операции с плавающей точкой, если их количество становится известно по ходу работы.
+         * @param flops Количество операций.
+         */
+        void add_flops(double flops);
+
+    private:
+        std::string name_;
+        double flops_;
+        bool active_{false};
+        PerfCounterValues begin_values_;
+        int64_t begin_ns_{0};
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_PERFCOUNTERS_H
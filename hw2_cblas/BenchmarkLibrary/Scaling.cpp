@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "Scaling.h"
+
+namespace benchmark_library {
+
+    namespace {
+        const std::string SCALING_OPTION = "--scaling";
+
+        bool is_environment_set(const char *name) {
+            const char *value = std::getenv(name);
+            return value != nullptr && value[0] != '\0';
+        }
+    }
+
+    std::vector<ScalingPoint> compute_scaling(const std::vector<BenchmarkRecord> &records) {
+        std::map<std::pair<std::string, size_t>, const BenchmarkRecord *> baselines;
+        for (const auto &record: records) {
+            auto &baseline = baselines[{record.kernel, record.size}];
+            if (baseline == nullptr || record.threads < baseline->threads) {
+                baseline = &record;
+            }
+        }
+
+        std::vector<ScalingPoint> points;
+        points.reserve(records.size());
+        for (const auto &record: records) {
+            const auto &baseline = *baselines[{record.kernel, record.size}];
+            ScalingPoint point;
+            point.kernel = record.kernel;
+            point.size = record.size;
+            point.threads = record.threads;
+            point.median_us = record.statistics.median_us;
+
+            double p = static_cast<double>(record.threads) / static_cast<double>(baseline.threads);
+            point.speedup = record.statistics.median_us > 0.0 ? baseline.statistics.median_us / record.statistics.median_us : 0.0;
+            point.efficiency = point.speedup / p;
+            if (p > 1.0 && point.speedup > 0.0) {
+                point.karp_flatt = (1.0 / point.speedup - 1.0 / p) / (1.0 - 1.0 / p);
+            } else {
+                point.karp_flatt = std::numeric_limits<double>::quiet_NaN();
+            }
+            points.push_back(point);
+        }
+        return points;
+    }
+
+    void write_scaling_table(std::ostream &stream, const std::vector<ScalingPoint> &points) {
+        std::ios state(nullptr);
+        state.copyfmt(stream);
+
+        stream << std::left << std::setw(16) << "kernel" << std::right
+               << std::setw(8) << "size" << std::setw(8) << "threads"
+               << std::setw(14) << "median, ms" << std::setw(10) << "speedup"
+               << std::setw(12) << "efficiency" << std::setw(12) << "Karp-Flatt" << std::endl;
+        stream << std::fixed << std::setprecision(3);
+        for (const auto &point: points) {
+            stream << std::left << std::setw(16) << point.kernel << std::right
+                   << std::setw(8) << point.size << std::setw(8) << point.threads
+                   << std::setw(14) << point.median_us / 1e3
+                   << std::setw(10) << point.speedup
+                   << std::setw(12) << point.efficiency;
+            if (std::isnan(point.karp_flatt)) {
+                stream << std::setw(12) << "-";
+            } else {
+                stream << std::setw(12) << point.karp_flatt;
+            }
+            stream << std::endl;
+        }
+
+        stream.copyfmt(state);
+    }
+
+    ScalingStudy::ScalingStudy(ScalingStudy::ThreadsCountSetter set_threads_count, std::vector<size_t> threads_counts,
+                               size_t warmup_count, size_t repetition_count) :
+            set_threads_count_(std::move(set_threads_count)),
+            threads_counts_(std::move(threads_counts)),
+            runner_(warmup_count, repetition_count) {
+        assert(!threads_counts_.empty());
+    }
+
+    void ScalingStudy::run(const std::string &kernel, size_t size, double flop_count, double byte_count,
+                           const std::function<void()> &workload) {
+        for (auto threads_count: threads_counts_) {
+            set_threads_count_(threads_count);
+            runner_.run(kernel, size, threads_count, flop_count, byte_count, workload);
+        }
+    }
+
+    const BenchmarkRunner &ScalingStudy::get_runner() const {
+        return runner_;
+    }
+
+    void ScalingStudy::write(std::ostream &stream) const {
+        write_scaling_table(stream, compute_scaling(runner_.get_records()));
+    }
+
+    std::vector<size_t> default_threads_counts() {
+        size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<size_t> threads_counts;
+        for (size_t threads_count = 1; threads_count <= max_threads; ++threads_count) {
+            threads_counts.push_back(threads_count);
+        }
+        return threads_counts;
+    }
+
+    bool handle_scaling_option(int &argc, char *argv[], std::vector<size_t> &threads_counts) {
+        int position = 1;
+        for (; position < argc; ++position) {
+            std::string argument(argv[position]);
+            if (argument == SCALING_OPTION || argument.rfind(SCALING_OPTION + "=", 0) == 0) {
+                break;
+            }
+        }
+        if (position == argc) {
+            return false;
+        }
+
+#ifdef __linux__
+        if (!is_environment_set("OMP_PROC_BIND") && !is_environment_set("OMP_PLACES")) {
+            setenv("OMP_PROC_BIND", "close", 1);
+            setenv("OMP_PLACES", "cores", 1);
+            execv("/proc/self/exe", argv);
+            std::cerr << "Could not restart with pinned threads: " << std::strerror(errno)
+                      << ". Threads are not pinned." << std::endl;
+        }
+#endif
+
+        std::string argument(argv[position]);
+        threads_counts = argument == SCALING_OPTION
+                         ? default_threads_counts()
+                         : parse_size_list(argument.substr(SCALING_OPTION.size() + 1));
+
+        for (int i = position; i + 1 < argc; ++i) {
+            argv[i] = argv[i + 1];
+        }
+        --argc;
+        argv[argc] = nullptr;
+        return true;
+    }
+
+    std::optional<std::string> take_option(int &argc, char *argv[], const std::string &prefix) {
+        for (int position = 1; position < argc; ++position) {
+            std::string argument(argv[position]);
+            if (argument.rfind(prefix, 0) == 0) {
+                for (int i = position; i + 1 < argc; ++i) {
+                    argv[i] = argv[i + 1];
+                }
+                --argc;
+                argv[argc] = nullptr;
+                return argument.substr(prefix.size());
+            }
+        }
+        return std::nullopt;
+    }
+}
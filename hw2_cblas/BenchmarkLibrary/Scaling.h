@@ -0,0 +1,136 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_SCALING_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_SCALING_H
+
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+namespace benchmark_library {
+
+    /**
+     * @brief Точка кривой масштабирования: одно ядро при одном размере задачи и одном количестве потоков.
+     */
+    struct ScalingPoint {
+        std::string kernel;
+        size_t size{0};
+        size_t threads{1};
+        double median_us{0.0};
+        /**
+         * @brief Ускорение относительно запуска с наименьшим количеством потоков.
+         */
+        double speedup{1.0};
+        /**
+         * @brief Параллельная эффективность: ускорение, делённое на отношение количеств потоков.
+         */
+        double efficiency{1.0};
+        /**
+         * @brief Оценка доли последовательной части по метрике Карпа-Флэтта.
+         * @details e = (1/S - 1/p) / (1 - 1/p). Для базового запуска не определена (NaN).
+         * @details Если e растёт с количеством потоков, то мешают накладные расходы на синхронизацию,
+         * @details а не последовательная часть алгоритма.
+         */
+        double karp_flatt{0.0};
+    };
+
+    /**
+     * @brief Посчитать ускорение, эффективность и метрику Карпа-Флэтта по результатам замеров.
+     * @details Замеры группируются по ядру и размеру задачи,
+     * @details базой в каждой группе служит замер с наименьшим количеством потоков.
+     * @param records Результаты замеров.
+     * @return Точки кривых масштабирования в порядке замеров.
+     */
+    std::vector<ScalingPoint> compute_scaling(const std::vector<BenchmarkRecord>& records);
+
+    /**
+     * @brief Напечатать кривые масштабирования таблицей.
+     * @param stream Поток вывода.
+     * @param points Точки кривых масштабирования.
+     */
+    void write_scaling_table(std::ostream& stream, const std::vector<ScalingPoint>& points);
+
+    /**
+     * @brief Исследование масштабируемости ядра по количеству потоков.
+     * @details Для каждого количества потоков вызывает функцию, которая выставляет его в OMP и BLAS,
+     * @details и замеряет ядро через BenchmarkRunner.
+     */
+    class ScalingStudy {
+    public:
+        /**
+         * @brief Функция, выставляющая количество потоков во всех используемых библиотеках.
+         */
+        using ThreadsCountSetter = std::function<void(size_t)>;
+
+        /**
+         * @brief Конструктор.
+         * @param set_threads_count Функция, выставляющая количество потоков.
+         * @param threads_counts Перебираемые количества потоков.
+         * @param warmup_count Количество прогревочных запусков на каждое количество потоков.
+         * @param repetition_count Количество замеряемых запусков на каждое количество потоков.
+         */
+        ScalingStudy(ThreadsCountSetter set_threads_count, std::vector<size_t> threads_counts,
+                     size_t warmup_count = 1, size_t repetition_count = 3);
+
+        /**
+         * @brief Замерить ядро при всех количествах потоков.
+         * @param kernel Имя ядра.
+         * @param size Размер задачи.
+         * @param flop_count Количество операций с плавающей точкой за запуск.
+         * @param byte_count Объём данных, передаваемых из памяти за запуск.
+         * @param workload Замеряемая функция.
+         */
+        void run(const std::string& kernel, size_t size, double flop_count, double byte_count,
+                 const std::function<void()>& workload);
+
+        /**
+         * @brief Получить сырые результаты замеров.
+         * @return Ссылка на запускатель замеров.
+         */
+        const BenchmarkRunner& get_runner() const;
+
+        /**
+         * @brief Напечатать кривые масштабирования всех замеренных ядер.
+         * @param stream Поток вывода.
+         */
+        void write(std::ostream& stream = std::cout) const;
+
+    private:
+        ThreadsCountSetter set_threads_count_;
+        std::vector<size_t> threads_counts_;
+        BenchmarkRunner runner_;
+    };
+
+    /**
+     * @brief Количества потоков для исследования по умолчанию: от 1 до количества логических ядер.
+     * @return Список количеств потоков.
+     */
+    std::vector<size_t> default_threads_counts();
+
+    /**
+     * @brief Обработать параметр --scaling[=<список_потоков>] командной строки.
+     * @details Если параметр найден, он удаляется из argv, чтобы не мешать разбору остальных параметров.
+     * @details Привязка потоков к ядрам задаётся переменными OMP_PROC_BIND и OMP_PLACES,
+     * @details которые рантайм OMP читает один раз при загрузке. Поэтому, если они не заданы,
+     * @details функция выставляет OMP_PROC_BIND=close и OMP_PLACES=cores и перезапускает программу
+     * @details с теми же аргументами через /proc/self/exe. Заданные пользователем значения не трогаются.
+     * @param argc Количество аргументов. Уменьшается, если параметр найден.
+     * @param argv Аргументы.
+     * @param threads_counts Сюда записываются перебираемые количества потоков.
+     * @return True, если нужно провести исследование масштабируемости.
+     */
+    bool handle_scaling_option(int& argc, char* argv[], std::vector<size_t>& threads_counts);
+
+    /**
+     * @brief Найти опцию вида <prefix><value> и убрать её из аргументов.
+     * @param argc Количество аргументов, уменьшается, если опция найдена.
+     * @param argv Аргументы.
+     * @param prefix Начало опции, например "--seed=". Для флага без значения - сам флаг, например "--stream".
+     * @return Значение опции или std::nullopt, если её нет.
+     */
+    std::optional<std::string> take_option(int& argc, char* argv[], const std::string& prefix);
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_SCALING_H
@@ -0,0 +1,34 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPLITMIX_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPLITMIX_H
+
+#include <cstdint>
+
+namespace benchmark_library {
+
+    /**
+     * @brief Перемешивание splitmix64: соседние входы дают независимые на вид 64-битные выходы.
+     * @details Основа счётных генераторов: число с номером index - splitmix64(key + index), поэтому куски потока
+     * @details чисел генерируются в любом порядке и в любом количестве потоков. Из зерна так же выводятся
+     * @details ключи независимых потоков. Только сложения, сдвиги и умножения - векторизуется внутри simd-циклов.
+     * @param value Вход.
+     * @return Перемешанное значение.
+     */
+    inline uint64_t splitmix64(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Счётный генератор: равномерное число из [0, 1), зависящее только от ключа и номера.
+     * @param key Ключ потока чисел.
+     * @param index Номер числа в потоке.
+     * @return Число из [0, 1) с 24 случайными битами.
+     */
+    inline float uniform(uint64_t key, uint64_t index) {
+        return static_cast<float>(splitmix64(key + index) >> 40) * (1.0f / 16777216.0f);
+    }
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPLITMIX_H
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include <dlfcn.h>
+#include <omp.h>
+
+#include "BlasBackend.h"
+
+namespace matrix_library {
+
+    namespace {
+        /**
+         * @brief Значения перечислений CBLAS из стандартного cblas.h.
+         */
+        const int CBLAS_ROW_MAJOR = 101;
+        const int CBLAS_NO_TRANS = 111;
+        const int CBLAS_TRANS = 112;
+
+        /**
+         * @brief Размеры блоков встроенного умножения.
+         * @details Панель B из BLOCK_K строк ширины BLOCK_N помещается в L2.
+         */
+        const size_t BLOCK_M = 64;
+        const size_t BLOCK_N = 512;
+        const size_t BLOCK_K = 256;
+
+        /**
+         * @brief Размеры плитки C, которая накапливается в регистрах по всей панели k.
+         */
+        const size_t TILE_ROWS = 4;
+        const size_t TILE_COLUMNS = 16;
+
+        /**
+         * @brief Накопить в плитке C произведение строк op(A) на панель строк op(B) с p_begin по p_end.
+         * @details Плитка копится в локальном массиве, который компилятор держит в регистрах,
+         * @details поэтому C читается и пишется один раз на панель, а не на каждое p.
+         * @details Для полной плитки rows и columns равны параметрам шаблона и циклы разворачиваются.
+         */
+        template <size_t ROWS, size_t COLUMNS>
+        void multiply_tile(size_t rows, size_t columns, size_t i, size_t j, size_t p_begin, size_t p_end,
+                           float alpha, const float *a, size_t lda, bool a_is_transposed,
+                           const float *b_rows, size_t b_stride, float *c, size_t ldc) {
+            float tile[ROWS][COLUMNS] = {};
+            for (size_t p = p_begin; p < p_end; ++p) {
+                const float *b_row = b_rows + p * b_stride + j;
+                for (size_t r = 0; r < rows; ++r) {
+                    float a_element = a_is_transposed ? a[p * lda + i + r] : a[(i + r) * lda + p];
+#pragma omp simd
+                    for (size_t q = 0; q < columns; ++q) {
+                        tile[r][q] += a_element * b_row[q];
+                    }
+                }
+            }
+            for (size_t r = 0; r < rows; ++r) {
+                float *c_row = c + (i + r) * ldc + j;
+                for (size_t q = 0; q < columns; ++q) {
+                    c_row[q] += alpha * tile[r][q];
+                }
+            }
+        }
+
+        int to_cblas(BlasTranspose transpose) {
+            return transpose == BlasTranspose::YES ? CBLAS_TRANS : CBLAS_NO_TRANS;
+        }
+
+        /**
+         * @brief Стандартные имена библиотек для каждой реализации в порядке перебора.
+         */
+        std::vector<std::string> library_names(BlasBackendType type) {
+            switch (type) {
+                case BlasBackendType::OPENBLAS:
+                    return {"libopenblas.so.0", "libopenblas.so"};
+                case BlasBackendType::BLIS:
+                    return {"libblis.so.4", "libblis.so.3", "libblis.so"};
+                case BlasBackendType::REFERENCE:
+                    return {"libcblas.so.3", "libblas.so.3", "libblas.so"};
+                case BlasBackendType::BUILTIN:
+                    break;
+            }
+            return {};
+        }
+
+        /**
+         * @brief Стандартные имена библиотеки или заданный путь.
+         */
+        std::vector<std::string> library_candidates(BlasBackendType type, const std::string &library_path) {
+            return library_path.empty() ? library_names(type) : std::vector<std::string>{library_path};
+        }
+    }
+
+    std::string to_string(BlasBackendType type) {
+        switch (type) {
+            case BlasBackendType::BUILTIN:
+                return "builtin";
+            case BlasBackendType::OPENBLAS:
+                return "openblas";
+            case BlasBackendType::BLIS:
+                return "blis";
+            case BlasBackendType::REFERENCE:
+                return "reference";
+        }
+        return "unknown";
+    }
+
+    BlasBackendType parse_blas_backend_type(const std::string &name) {
+        for (auto type: {BlasBackendType::BUILTIN, BlasBackendType::OPENBLAS, BlasBackendType::BLIS, BlasBackendType::REFERENCE}) {
+            if (to_string(type) == name) {
+                return type;
+            }
+        }
+        throw std::invalid_argument("Unknown BLAS backend: " + name);
+    }
+
+    BlasBackend &BlasBackend::instance() {
+        static BlasBackend backend;
+        return backend;
+    }
+
+    BlasBackend::BlasBackend() {
+        const char *library_path = std::getenv("HPC_BLAS_LIBRARY");
+        std::string path = library_path != nullptr ? library_path : "";
+
+        const char *name = std::getenv("HPC_BLAS_BACKEND");
+        if (name != nullptr && name[0] != '\0') {
+            // экземпляр создаётся при первом обращении из любого места программы, поэтому неверное значение
+            // не бросает исключение, а только сообщается: иначе оно повторялось бы при каждом обращении
+            std::optional<BlasBackendType> type;
+            try {
+                type = parse_blas_backend_type(name);
+            } catch (const std::invalid_argument &error) {
+                std::cerr << error.what() << " in HPC_BLAS_BACKEND, expected builtin, openblas, blis or reference." << std::endl;
+            }
+            if (type && select(type.value(), path)) {
+                return;
+            }
+            std::cerr << "BLAS backend " << name << " is not available, falling back to the first available one." << std::endl;
+        }
+
+        for (auto type: {BlasBackendType::OPENBLAS, BlasBackendType::BLIS, BlasBackendType::REFERENCE}) {
+            if (select(type)) {
+                return;
+            }
+        }
+        select(BlasBackendType::BUILTIN);
+    }
+
+    bool BlasBackend::select(BlasBackendType type, const std::string &library_path) {
+        if (type == BlasBackendType::BUILTIN) {
+            type_ = type;
+            sgemm_ = nullptr;
+            sgemv_ = nullptr;
+            set_threads_ = nullptr;
+            set_threads_blis_ = nullptr;
+            apply_threads_count();
+            return true;
+        }
+
+        for (const auto &name: library_candidates(type, library_path)) {
+            void *handle = dlopen(name.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (handle == nullptr) {
+                continue;
+            }
+            auto sgemm = reinterpret_cast<SgemmFunction>(dlsym(handle, "cblas_sgemm"));
+            auto sgemv = reinterpret_cast<SgemvFunction>(dlsym(handle, "cblas_sgemv"));
+            if (sgemm == nullptr || sgemv == nullptr) {  // библиотека собрана без C-интерфейса, пробуем следующее имя
+                dlclose(handle);
+                continue;
+            }
+
+            type_ = type;
+            sgemm_ = sgemm;
+            sgemv_ = sgemv;
+            set_threads_ = reinterpret_cast<SetThreadsFunction>(dlsym(handle, "openblas_set_num_threads"));
+            set_threads_blis_ = reinterpret_cast<SetThreadsBlisFunction>(dlsym(handle, "bli_thread_set_num_threads"));
+            apply_threads_count();
+            return true;
+        }
+        return false;
+    }
+
+    BlasBackendType BlasBackend::get_type() const {
+        return type_;
+    }
+
+    std::string BlasBackend::get_name() const {
+        return to_string(type_);
+    }
+
+    void BlasBackend::set_threads_count(size_t threads_count) {
+        assert(threads_count > 0);
+        threads_count_ = threads_count;
+        apply_threads_count();
+    }
+
+    void set_threads_count(size_t threads_count) {
+        BlasBackend::instance().set_threads_count(threads_count);
+    }
+
+    size_t BlasBackend::get_threads_count() const {
+        return threads_count_;
+    }
+
+    void BlasBackend::apply_threads_count() const {
+        if (threads_count_ == 0) {
+            return;
+        }
+        omp_set_num_threads(static_cast<int>(threads_count_));
+        set_library_threads_count(threads_count_);
+    }
+
+    void BlasBackend::set_library_threads_count(size_t threads_count) const {
+        assert(threads_count > 0);
+        if (set_threads_ != nullptr) {
+            set_threads_(static_cast<int>(threads_count));
+        }
+        if (set_threads_blis_ != nullptr) {
+            set_threads_blis_(static_cast<long>(threads_count));
+        }
+    }
+
+    SingleThreadedBlas::SingleThreadedBlas() {
+        BlasBackend::instance().set_library_threads_count(1);
+    }
+
+    SingleThreadedBlas::~SingleThreadedBlas() {
+        const auto &backend = BlasBackend::instance();
+        const size_t threads_count = backend.get_threads_count();
+        backend.set_library_threads_count(threads_count > 0 ? threads_count : static_cast<size_t>(omp_get_max_threads()));
+    }
+
+    void BlasBackend::sgemm(BlasTranspose transpose_a, BlasTranspose transpose_b, size_t m, size_t n, size_t k,
+                            float alpha, const float *a, size_t lda, const float *b, size_t ldb,
+                            float beta, float *c, size_t ldc) const {
+        if (sgemm_ == nullptr) {
+            builtin_sgemm(transpose_a, transpose_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+            return;
+        }
+        sgemm_(CBLAS_ROW_MAJOR, to_cblas(transpose_a), to_cblas(transpose_b),
+               static_cast<int>(m), static_cast<int>(n), static_cast<int>(k),
+               alpha, a, static_cast<int>(lda), b, static_cast<int>(ldb),
+               beta, c, static_cast<int>(ldc));
+    }
+
+    void BlasBackend::sgemv(BlasTranspose transpose_a, size_t m, size_t n,
+                            float alpha, const float *a, size_t lda, const float *x,
+                            float beta, float *y) const {
+        if (sgemv_ == nullptr) {
+            builtin_sgemv(transpose_a, m, n, alpha, a, lda, x, beta, y);
+            return;
+        }
+        sgemv_(CBLAS_ROW_MAJOR, to_cblas(transpose_a), static_cast<int>(m), static_cast<int>(n),
+               alpha, a, static_cast<int>(lda), x, 1, beta, y, 1);
+    }
+
+    void builtin_sgemm(BlasTranspose transpose_a, BlasTranspose transpose_b, size_t m, size_t n, size_t k,
+                       float alpha, const float *a, size_t lda, const float *b, size_t ldb,
+                       float beta, float *c, size_t ldc) {
+        // Строки op(B) должны лежать в памяти подряд, поэтому транспонированную B переписываем один раз.
+        std::vector<float> transposed_b;
+        const float *b_rows = b;
+        size_t b_stride = ldb;
+        if (transpose_b == BlasTranspose::YES) {
+            transposed_b.resize(k * n);
+#pragma omp parallel for default(none) shared(transposed_b, b, ldb, k, n)
+            for (size_t p = 0; p < k; ++p) {
+                for (size_t j = 0; j < n; ++j) {
+                    transposed_b[p * n + j] = b[j * ldb + p];
+                }
+            }
+            b_rows = transposed_b.data();
+            b_stride = n;
+        }
+
+        const bool a_is_transposed = (transpose_a == BlasTranspose::YES);
+        const size_t row_blocks_count = (m + BLOCK_M - 1) / BLOCK_M;
+
+#pragma omp parallel for schedule(static) default(none) \
+        shared(row_blocks_count, m, n, k, alpha, a, lda, a_is_transposed, b_rows, b_stride, beta, c, ldc, TILE_ROWS, TILE_COLUMNS)
+        for (size_t row_block = 0; row_block < row_blocks_count; ++row_block) {
+            size_t i_begin = row_block * BLOCK_M;
+            size_t i_end = std::min(i_begin + BLOCK_M, m);
+
+            for (size_t i = i_begin; i < i_end; ++i) {
+                float *c_row = c + i * ldc;
+                if (beta == 0.0f) {
+                    std::fill(c_row, c_row + n, 0.0f);
+                } else if (beta != 1.0f) {
+#pragma omp simd
+                    for (size_t j = 0; j < n; ++j) {
+                        c_row[j] *= beta;
+                    }
+                }
+            }
+
+            for (size_t p_begin = 0; p_begin < k; p_begin += BLOCK_K) {
+                size_t p_end = std::min(p_begin + BLOCK_K, k);
+                for (size_t j_begin = 0; j_begin < n; j_begin += BLOCK_N) {
+                    size_t j_end = std::min(j_begin + BLOCK_N, n);
+                    for (size_t i = i_begin; i < i_end; i += TILE_ROWS) {
+                        size_t rows = std::min(TILE_ROWS, i_end - i);
+                        for (size_t j = j_begin; j < j_end; j += TILE_COLUMNS) {
+                            size_t columns = std::min(TILE_COLUMNS, j_end - j);
+                            if (rows == TILE_ROWS && columns == TILE_COLUMNS) {
+                                multiply_tile<TILE_ROWS, TILE_COLUMNS>(
+                                        TILE_ROWS, TILE_COLUMNS, i, j, p_begin, p_end,
+                                        alpha, a, lda, a_is_transposed, b_rows, b_stride, c, ldc);
+                            } else {
+                                multiply_tile<TILE_ROWS, TILE_COLUMNS>(
+                                        rows, columns, i, j, p_begin, p_end,
+                                        alpha, a, lda, a_is_transposed, b_rows, b_stride, c, ldc);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void builtin_sgemv(BlasTranspose transpose_a, size_t m, size_t n,
+                       float alpha, const float *a, size_t lda, const float *x,
+                       float beta, float *y) {
+        if (transpose_a == BlasTranspose::NO) {
+#pragma omp parallel for schedule(static) default(none) shared(m, n, alpha, a, lda, x, beta, y)
+            for (size_t i = 0; i < m; ++i) {
+                const float *a_row = a + i * lda;
+                float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+                for (size_t j = 0; j < n; ++j) {
+                    sum += a_row[j] * x[j];
+                }
+                y[i] = (beta == 0.0f) ? alpha * sum : alpha * sum + beta * y[i];
+            }
+            return;
+        }
+
+        // y = alpha * A^T * x + beta * y: каждый поток идёт по строкам A и накапливает свой отрезок y.
+        const size_t column_blocks_count = (n + BLOCK_N - 1) / BLOCK_N;
+#pragma omp parallel for schedule(static) default(none) \
+        shared(column_blocks_count, m, n, alpha, a, lda, x, beta, y)
+        for (size_t column_block = 0; column_block < column_blocks_count; ++column_block) {
+            size_t j_begin = column_block * BLOCK_N;
+            size_t j_end = std::min(j_begin + BLOCK_N, n);
+            float sums[BLOCK_N] = {};
+            for (size_t i = 0; i < m; ++i) {
+                const float *a_row = a + i * lda;
+                float x_element = x[i];
+#pragma omp simd
+                for (size_t j = j_begin; j < j_end; ++j) {
+                    sums[j - j_begin] += a_row[j] * x_element;
+                }
+            }
+            for (size_t j = j_begin; j < j_end; ++j) {
+                y[j] = (beta == 0.0f) ? alpha * sums[j - j_begin] : alpha * sums[j - j_begin] + beta * y[j];
+            }
+        }
+    }
+}
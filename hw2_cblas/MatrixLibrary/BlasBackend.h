@@ -0,0 +1,214 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_BLASBACKEND_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_BLASBACKEND_H
+
+#include <cstddef>
+#include <string>
+
+namespace matrix_library {
+
+    /**
+     * @brief Реализация BLAS, через которую выполняются матричные операции.
+     */
+    enum class BlasBackendType {
+        BUILTIN,  // собственные блочные ядра на OMP, доступны всегда
+        OPENBLAS,
+        BLIS,
+        REFERENCE  // эталонная реализация netlib (libblas/libcblas)
+    };
+
+    /**
+     * @brief Транспонировать ли матрицу-операнд.
+     */
+    enum class BlasTranspose {
+        NO,
+        YES
+    };
+
+    /**
+     * @brief Получить имя реализации BLAS.
+     * @param type Реализация BLAS.
+     * @return Имя: builtin, openblas, blis или reference.
+     */
+    std::string to_string(BlasBackendType type);
+
+    /**
+     * @brief Разобрать имя реализации BLAS.
+     * @details Бросает std::invalid_argument, если имя неизвестно.
+     * @param name Имя: builtin, openblas, blis или reference.
+     * @return Реализация BLAS.
+     */
+    BlasBackendType parse_blas_backend_type(const std::string& name);
+
+    /**
+     * @brief Диспетчер реализаций BLAS.
+     * @details Библиотеки BLAS не линкуются к программе, а загружаются во время работы через dlopen,
+     * @details поэтому одну и ту же сборку можно запускать с разными реализациями.
+     * @details Реализация выбирается переменной окружения HPC_BLAS_BACKEND=<builtin|openblas|blis|reference>
+     * @details или вызовом select. Путь к библиотеке можно переопределить переменной HPC_BLAS_LIBRARY.
+     * @details Если переменная не задана, берётся первая найденная из OpenBLAS, BLIS, эталонной,
+     * @details а если не найдено ни одной - встроенные ядра. Неизвестное значение HPC_BLAS_BACKEND не бросает исключение:
+     * @details оно сообщается в stderr, и реализация выбирается так же, как без переменной.
+     * @details Загруженные библиотеки не выгружаются до завершения программы: у них есть свои пулы потоков.
+     * @details Все матрицы хранятся по строкам (row-major).
+     */
+    class BlasBackend {
+    public:
+        /**
+         * @brief Получить единственный экземпляр.
+         * @return Ссылка на диспетчер.
+         */
+        static BlasBackend& instance();
+
+        BlasBackend(const BlasBackend&) = delete;
+        BlasBackend& operator=(const BlasBackend&) = delete;
+
+        /**
+         * @brief Выбрать реализацию BLAS.
+         * @details Не потокобезопасно, вызывать вне параллельных областей.
+         * @param type Реализация BLAS.
+         * @details Библиотека без C-интерфейса (cblas_sgemm, cblas_sgemv) выгружается, и пробуется следующее имя.
+         * @param library_path Путь к библиотеке. Если пустой, перебираются стандартные имена.
+         * @return True, если реализация загружена. Иначе остаётся прежняя реализация.
+         */
+        bool select(BlasBackendType type, const std::string& library_path = "");
+
+        /**
+         * @brief Получить текущую реализацию BLAS.
+         * @return Реализация BLAS.
+         */
+        BlasBackendType get_type() const;
+
+        /**
+         * @brief Получить имя текущей реализации BLAS.
+         * @return Имя реализации.
+         */
+        std::string get_name() const;
+
+        /**
+         * @brief Установить количество потоков одновременно для OMP и текущей реализации BLAS.
+         * @details Заменяет вызовы openblas_set_num_threads, которые привязывали программы к OpenBLAS.
+         * @details Запоминается и применяется к реализации, выбранной позже.
+         * @param threads_count Количество потоков.
+         */
+        void set_threads_count(size_t threads_count);
+
+        /**
+         * @brief Получить установленное количество потоков.
+         * @return Количество потоков. Ноль, если не устанавливалось.
+         */
+        size_t get_threads_count() const;
+
+        /**
+         * @brief Установить количество потоков только текущей реализации BLAS.
+         * @details Количество потоков OMP и значение, запомненное set_threads_count, не меняются.
+         * @details Встроенная реализация распараллелена OMP и этим вызовом не ограничивается.
+         * @param threads_count Количество потоков.
+         */
+        void set_library_threads_count(size_t threads_count) const;
+
+        /**
+         * @brief Умножение матриц C = alpha * op(A) * op(B) + beta * C.
+         * @param transpose_a Транспонировать ли A.
+         * @param transpose_b Транспонировать ли B.
+         * @param m Количество строк op(A) и C.
+         * @param n Количество столбцов op(B) и C.
+         * @param k Количество столбцов op(A) и строк op(B).
+         * @param alpha Множитель произведения.
+         * @param a Указатель на первый элемент A.
+         * @param lda Расстояние в элементах между началами соседних строк A.
+         * @param b Указатель на первый элемент B.
+         * @param ldb Расстояние в элементах между началами соседних строк B.
+         * @param beta Множитель C. Если ноль, исходное содержимое C не читается.
+         * @param c Указатель на первый элемент C.
+         * @param ldc Расстояние в элементах между началами соседних строк C.
+         */
+        void sgemm(BlasTranspose transpose_a, BlasTranspose transpose_b, size_t m, size_t n, size_t k,
+                   float alpha, const float *a, size_t lda, const float *b, size_t ldb,
+                   float beta, float *c, size_t ldc) const;
+
+        /**
+         * @brief Умножение матрицы на вектор y = alpha * op(A) * x + beta * y.
+         * @param transpose_a Транспонировать ли A.
+         * @param m Количество строк A.
+         * @param n Количество столбцов A.
+         * @param alpha Множитель произведения.
+         * @param a Указатель на первый элемент A.
+         * @param lda Расстояние в элементах между началами соседних строк A.
+         * @param x Вектор длины n (или m, если A транспонируется).
+         * @param beta Множитель y. Если ноль, исходное содержимое y не читается.
+         * @param y Вектор длины m (или n, если A транспонируется).
+         */
+        void sgemv(BlasTranspose transpose_a, size_t m, size_t n,
+                   float alpha, const float *a, size_t lda, const float *x,
+                   float beta, float *y) const;
+
+    private:
+        BlasBackend();
+
+        /**
+         * @brief Сигнатуры функций C-интерфейса BLAS. Перечисления CBLAS передаются как int.
+         */
+        using SgemmFunction = void (*)(int, int, int, int, int, int, float, const float *, int,
+                                       const float *, int, float, float *, int);
+        using SgemvFunction = void (*)(int, int, int, int, float, const float *, int,
+                                       const float *, int, float, float *, int);
+        using SetThreadsFunction = void (*)(int);
+        using SetThreadsBlisFunction = void (*)(long);
+
+        /**
+         * @brief Применить запомненное количество потоков к текущей реализации.
+         */
+        void apply_threads_count() const;
+
+        BlasBackendType type_{BlasBackendType::BUILTIN};
+        size_t threads_count_{0};
+
+        SgemmFunction sgemm_{nullptr};
+        SgemvFunction sgemv_{nullptr};
+        SetThreadsFunction set_threads_{nullptr};
+        SetThreadsBlisFunction set_threads_blis_{nullptr};
+    };
+
+    /**
+     * @brief Установить количество потоков одновременно для OMP и выбранной реализации BLAS.
+     * @details То же, что BlasBackend::instance().set_threads_count, в виде свободной функции:
+     * @details её можно передать в benchmark_library::ScalingStudy.
+     * @param threads_count Количество потоков.
+     */
+    void set_threads_count(size_t threads_count);
+
+    /**
+     * @brief Ограничение реализации BLAS одним потоком на время жизни объекта.
+     * @details Нужно, когда sgemm вызывается из задач OMP: каждая задача уже занимает поток,
+     * @details и собственные потоки BLAS внутри неё привели бы к переподписке.
+     * @details Количество потоков OMP не меняется. В деструкторе реализации BLAS возвращается количество потоков,
+     * @details установленное set_threads_count, а если оно не задавалось - количество потоков OMP.
+     * @details Создавать вне параллельных областей.
+     */
+    class SingleThreadedBlas {
+    public:
+        SingleThreadedBlas();
+        ~SingleThreadedBlas();
+
+        SingleThreadedBlas(const SingleThreadedBlas&) = delete;
+        SingleThreadedBlas& operator=(const SingleThreadedBlas&) = delete;
+    };
+
+    /**
+     * @brief Встроенное умножение матриц: блочное, распараллеленное OMP, векторизуемое по строкам C.
+     * @details Параметры как у BlasBackend::sgemm.
+     */
+    void builtin_sgemm(BlasTranspose transpose_a, BlasTranspose transpose_b, size_t m, size_t n, size_t k,
+                       float alpha, const float *a, size_t lda, const float *b, size_t ldb,
+                       float beta, float *c, size_t ldc);
+
+    /**
+     * @brief Встроенное умножение матрицы на вектор, распараллеленное OMP.
+     * @details Параметры как у BlasBackend::sgemv.
+     */
+    void builtin_sgemv(BlasTranspose transpose_a, size_t m, size_t n,
+                       float alpha, const float *a, size_t lda, const float *x,
+                       float beta, float *y);
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_BLASBACKEND_H
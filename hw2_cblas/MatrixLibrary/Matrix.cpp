@@ -363,7 +363,7 @@ namespace matrix_library {
 
     Matrix Matrix::operator*(const float factor) const {
         Matrix res = *this;
-#pragma omp parallel for collapse(2) default(none) shared(res)
+#pragma omp parallel for collapse(2) default(none) shared(res, factor)
         for (size_t i = 0; i < row_count_; ++i) {
             for (size_t j = 0; j < column_count_; ++j) {
                 res.get_element(i, j) *= factor;
@@ -373,17 +373,18 @@ namespace matrix_library {
     }
 
     Matrix &Matrix::operator*=(const float factor) {
-#pragma omp parallel for collapse(2) default(none)
+#pragma omp parallel for collapse(2) default(none) shared(factor)
         for (size_t i = 0; i < row_count_; ++i) {
             for (size_t j = 0; j < column_count_; ++j) {
                 get_element(i, j) *= factor;
             }
         }
+        return *this;
     }
 
     Matrix Matrix::operator+(const float addend) const {
         Matrix res = *this;
-#pragma omp parallel for collapse(2) default(none) shared(res)
+#pragma omp parallel for collapse(2) default(none) shared(res, addend)
         for (size_t i = 0; i < row_count_; ++i) {
             for (size_t j = 0; j < column_count_; ++j) {
                 res.get_element(i, j) += addend;
@@ -34,13 +34,13 @@ namespace matrix_library {
 
         Matrix addend_and_result(lhs.get_row_count(), rhs.get_column_count());
 
-        cblas_sgemm(CblasRowMajor,CblasNoTrans,CblasNoTrans,
-                    lhs.get_row_count(),rhs.get_column_count(),lhs.get_column_count(),
-                    1.0,
-                    lhs.get_data(),lhs.get_column_count(),
-                    rhs.get_data(),rhs.get_column_count(),
-                    0.0,
-                    addend_and_result.get_data(),rhs.get_column_count());
+        BlasBackend::instance().sgemm(BlasTranspose::NO, BlasTranspose::NO,
+                                      lhs.get_row_count(), rhs.get_column_count(), lhs.get_column_count(),
+                                      1.0f,
+                                      lhs.get_data(), lhs.get_column_count(),
+                                      rhs.get_data(), rhs.get_column_count(),
+                                      0.0f,
+                                      addend_and_result.get_data(), rhs.get_column_count());
 
         return addend_and_result;
     }
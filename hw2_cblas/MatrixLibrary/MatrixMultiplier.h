@@ -3,8 +3,7 @@
 
 #include <cassert>
 
-#include <cblas.h>  // заголовочный файл C-интерфейса библиотеки BLAS
-
+#include "BlasBackend.h"
 #include "Matrix.h"
 
 namespace matrix_library {
@@ -29,6 +28,7 @@ namespace matrix_library {
 
         /**
          * @brief Умножение матриц с использованием библиотеки cBLAS.
+         * @details Реализация BLAS выбирается во время работы программы, см. BlasBackend.
          * @param lhs Первый множитель.
          * @param rhs Второй множитель.
          * @return Произведение матриц.
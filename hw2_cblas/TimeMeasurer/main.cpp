@@ -1,85 +1,173 @@
 #include <iostream>
-#include <chrono>
-#include <iomanip>
+#include <fstream>
+#include <sstream>
 
+#include <omp.h>
+
+#include "Benchmark.h"
+#include "Scaling.h"
 #include "Matrix.h"
 #include "MatrixMultiplier.h"
 
-std::string convert_us_to_human_readable(uint64_t duration_us){
-    if (duration_us < 1e3) {
-        return std::to_string(duration_us) + " us";
-    }
+int main(int argc, char *argv[]) {
+    std::vector<size_t> sizes{512};
+    std::vector<size_t> threads{1};
+    std::vector<std::string> kernels{"definition", "cblas", "strassen"};
+    std::vector<std::string> backends;
+    size_t warmup_count = 1;
+    size_t repetition_count = 1;
+    auto format = benchmark_library::OutputFormat::TABLE;
+    std::string output_path;
+    std::string label;
+    bool perf_counters = false;
 
-    std::stringstream ss;
-    ss << std::fixed;
-    ss << std::setprecision(2);
-    if (duration_us < 1e6) {
-        ss << static_cast<double>(duration_us) / 1e3 << " ms";
-        return ss.str();
-    }
-    if (duration_us < 1e9) {
-        ss << static_cast<double>(duration_us) / 1e6 << " s";
-        return ss.str();
-    }
-    if (duration_us < 1e9 * 60) {
-        ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
-        return ss.str();
-    }
+    bool scaling = benchmark_library::handle_scaling_option(argc, argv, threads);
 
-    return std::to_string(duration_us) + " us";
-}
-
-int main(int argc, char *argv[]) {
-    if (argc < 2) {
-        std::cout << "Specify the size of the matrices.";
-        return -1;
+    for(int i = 1; i < argc; ++i) {
+        std::string parameter_name(argv[i]);
+        if (parameter_name == "-h") {
+            std::cout << R"str(
+Multiplies random square matrices in different ways and measures the duration.
+Usage:
+TimeMeasurer [-n <sizes>] [-t <threads>] [-k <kernels>] [-b <backends>] [-w <warmup_count>] [-r <repetition_count>] [-f <table|json|csv>] [-o <file>] [-l <label>] [-p] [--scaling[=<threads>]]
+TimeMeasurer matrix_size [repetition_count]
+Parameter -n - the sizes of the matrices, e.g. 256,512 or 256..260.
+Parameter -t - the thread counts for OMP and BLAS, e.g. 1..4.
+Parameter -k - the kernels: definition, cblas, strassen.
+Parameter -b - the BLAS backends for the cblas kernel: builtin, openblas, blis, reference.
+  By default the backend is chosen by HPC_BLAS_BACKEND or the first available one.
+Parameter -w - the count of launches that are not measured.
+Parameter -r - the count of measured launches.
+Parameter -f - the output format.
+Parameter -o - the output file, stdout by default.
+Parameter -l - the label of the launch (for example, the commit hash), it gets into JSON.
+Parameter -p - collect hardware performance counters (Linux perf_event_open).
+Parameter --scaling - sweep the thread counts (1..number of cores by default) with threads pinned to cores
+  and print speedup, parallel efficiency and the Karp-Flatt serial fraction.
+All parameters are optional.
+Default parameters:
+TimeMeasurer -n 512 -t 1 -k definition,cblas,strassen -w 1 -r 1 -f table
+)str" << std::endl;
+            return 0;
+        }
+        if (parameter_name == "-n") {
+            sizes = benchmark_library::parse_size_list(argv[++i]);
+            continue;
+        }
+        if (parameter_name == "-t") {
+            threads = benchmark_library::parse_size_list(argv[++i]);
+            continue;
+        }
+        if (parameter_name == "-k") {
+            kernels.clear();
+            std::stringstream ss(argv[++i]);
+            std::string kernel;
+            while (std::getline(ss, kernel, ',')) {
+                kernels.push_back(kernel);
+            }
+            continue;
+        }
+        if (parameter_name == "-b") {
+            std::stringstream ss(argv[++i]);
+            std::string backend;
+            while (std::getline(ss, backend, ',')) {
+                backends.push_back(backend);
+            }
+            continue;
+        }
+        if (parameter_name == "-w") {
+            warmup_count = std::stoul(argv[++i]);
+            continue;
+        }
+        if (parameter_name == "-r") {
+            repetition_count = std::stoul(argv[++i]);
+            continue;
+        }
+        if (parameter_name == "-f") {
+            format = benchmark_library::parse_output_format(argv[++i]);
+            continue;
+        }
+        if (parameter_name == "-o") {
+            output_path = argv[++i];
+            continue;
+        }
+        if (parameter_name == "-l") {
+            label = argv[++i];
+            continue;
+        }
+        if (parameter_name == "-p") {
+            perf_counters = true;
+            continue;
+        }
+        // старый формат запуска: path_to_program matrix_size experiment_count
+        if (i == 1) {
+            sizes = {std::stoul(parameter_name)};
+            continue;
+        }
+        if (i == 2) {
+            repetition_count = std::stoul(parameter_name);
+            continue;
+        }
     }
-    const size_t matrix_size = std::stoul(argv[1]);
 
-    size_t experiments_count = 1;
-    if (argc >= 3) {
-        experiments_count = std::stoul(argv[2]);
-    }
+    omp_set_dynamic(0);  // отключаем динамический выбор количества потоков
 
-    matrix_library::Matrix a(matrix_size, matrix_size);
-    a.initialize_randomly();
-    matrix_library::Matrix b(matrix_size, matrix_size);
-    b.initialize_randomly();
+    benchmark_library::BenchmarkRunner runner(warmup_count, repetition_count);
+    runner.set_perf_counters_enabled(perf_counters);
+    for (auto matrix_size: sizes) {
+        matrix_library::Matrix a(matrix_size, matrix_size);
+        a.initialize_randomly();
+        matrix_library::Matrix b(matrix_size, matrix_size);
+        b.initialize_randomly();
 
-    std::vector<int64_t> durations_by_definition;
-    for (int i = 0; i < experiments_count; ++i) {
-        auto begin = std::chrono::steady_clock::now();
-        auto c = matrix_library::MatrixMultiplier::multiplication_by_definition(a, b);
-        auto end = std::chrono::steady_clock::now();
-        auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-        durations_by_definition.push_back(elapsed_us.count());
-    }
-    auto average_duration_by_definition = std::accumulate(durations_by_definition.begin(), durations_by_definition.end(), 0.0) / durations_by_definition.size();
+        auto n = static_cast<double>(matrix_size);
+        double flop_count = 2.0 * n * n * n;
+        double byte_count = 3.0 * n * n * sizeof(float);  // прочитать два множителя и записать произведение
 
-    std::vector<int64_t> durations_blas;
-    for (int i = 0; i < experiments_count; ++i) {
-        auto begin = std::chrono::steady_clock::now();
-        auto c = matrix_library::MatrixMultiplier::multiplication_cblas(a, b);
-        auto end = std::chrono::steady_clock::now();
-        auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-        durations_blas.push_back(elapsed_us.count());
+        for (auto threads_count: threads) {
+            matrix_library::set_threads_count(threads_count);
+            for (const auto &kernel: kernels) {
+                if (kernel == "definition") {
+                    runner.run(kernel, matrix_size, threads_count, flop_count, byte_count, [&]() {
+                        auto c = matrix_library::MatrixMultiplier::multiplication_by_definition(a, b);
+                    });
+                } else if (kernel == "cblas" && backends.empty()) {
+                    runner.run(kernel, matrix_size, threads_count, flop_count, byte_count, [&]() {
+                        auto c = matrix_library::MatrixMultiplier::multiplication_cblas(a, b);
+                    });
+                } else if (kernel == "cblas") {
+                    for (const auto &backend: backends) {
+                        if (!matrix_library::BlasBackend::instance().select(matrix_library::parse_blas_backend_type(backend))) {
+                            std::cerr << "BLAS backend is not available: " << backend << std::endl;
+                            continue;
+                        }
+                        runner.run(kernel + "/" + backend, matrix_size, threads_count, flop_count, byte_count, [&]() {
+                            auto c = matrix_library::MatrixMultiplier::multiplication_cblas(a, b);
+                        });
+                    }
+                } else if (kernel == "strassen") {
+                    runner.run(kernel, matrix_size, threads_count, flop_count, byte_count, [&]() {
+                        auto c = matrix_library::MatrixMultiplier::multiplication_strassen(a, b);
+                    });
+                } else {
+                    std::cerr << "Unknown kernel: " << kernel << std::endl;
+                    return -1;
+                }
+            }
+        }
     }
-    auto average_duration_blas = std::accumulate(durations_blas.begin(), durations_blas.end(), 0.0) / durations_blas.size();
 
-    std::vector<int64_t> durations_strassen;
-    for (int i = 0; i < experiments_count; ++i) {
-        auto begin = std::chrono::steady_clock::now();
-        auto c = matrix_library::MatrixMultiplier::multiplication_strassen(a, b);
-        auto end = std::chrono::steady_clock::now();
-        auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-        durations_strassen.push_back(elapsed_us.count());
+    if (output_path.empty()) {
+        runner.write(std::cout, format, label);
+    } else {
+        std::ofstream output(output_path);
+        runner.write(output, format, label);
     }
-    auto average_duration_strassen = std::accumulate(durations_strassen.begin(), durations_strassen.end(), 0.0) / durations_strassen.size();
 
-    std::cout << experiments_count << " launches were carried out.\n";
-    std::cout << "The multiplication by definition average duration of two " << matrix_size << "x" << matrix_size << " square matrices is " << convert_us_to_human_readable(static_cast<uint64_t>(average_duration_by_definition)) << ".\n";
-    std::cout << "The multiplication with BLAS average duration of two " << matrix_size << "x" << matrix_size << " square matrices is " << convert_us_to_human_readable(static_cast<uint64_t>(average_duration_blas)) << ".\n";
-    std::cout << "The multiplication with Strassen's algorithm average duration of two " << matrix_size << "x" << matrix_size << " square matrices is " << convert_us_to_human_readable(static_cast<uint64_t>(average_duration_strassen)) << ".\n";
+    if (scaling && (format == benchmark_library::OutputFormat::TABLE || !output_path.empty())) {
+        std::cout << std::endl;
+        benchmark_library::write_scaling_table(std::cout, benchmark_library::compute_scaling(runner.get_records()));
+    }
 
     return 0;
-}
\ No newline at end of file
+}
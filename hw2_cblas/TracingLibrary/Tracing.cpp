@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Tracing.h"
+
+namespace tracing_library {
+
+    namespace {
+        const char *trace_path_from_environment() {
+            const char *path = std::getenv("HPC_TRACE");
+            return (path != nullptr && path[0] != '\0') ? path : nullptr;
+        }
+
+        int64_t steady_clock_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /**
+         * @brief Момент загрузки программы. От него отсчитываются метки времени в трассе.
+         */
+        const int64_t PROGRAM_START_NS = steady_clock_ns();
+    }
+
+    bool Tracer::enabled_ = (trace_path_from_environment() != nullptr);
+
+    std::string convert_us_to_human_readable(uint64_t duration_us) {
+        if (duration_us < 1e3) {
+            return std::to_string(duration_us) + " us";
+        }
+
+        std::stringstream ss;
+        ss << std::fixed;
+        ss << std::setprecision(2);
+        if (duration_us < 1e6) {
+            ss << static_cast<double>(duration_us) / 1e3 << " ms";
+            return ss.str();
+        }
+        if (duration_us < 1e9) {
+            ss << static_cast<double>(duration_us) / 1e6 << " s";
+            return ss.str();
+        }
+        if (duration_us < 1e9 * 60) {
+            ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
+            return ss.str();
+        }
+
+        return std::to_string(duration_us) + " us";
+    }
+
+    int64_t now_ns() {
+        return steady_clock_ns();
+    }
+
+    Tracer &Tracer::instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    Tracer::Tracer() : origin_ns_(PROGRAM_START_NS) {
+        const char *path = trace_path_from_environment();
+        if (path != nullptr) {
+            output_path_ = path;
+        }
+    }
+
+    Tracer::~Tracer() {
+        flush();
+    }
+
+    void Tracer::set_output_path(const std::string &path) {
+        output_path_ = path;
+        enabled_ = !path.empty();
+    }
+
+    void Tracer::record(const char *name, int64_t begin_ns, int64_t end_ns) {
+        local_buffer().events.push_back({name, begin_ns, end_ns - begin_ns});
+    }
+
+    Tracer::ThreadBuffer &Tracer::local_buffer() {
+        thread_local ThreadBuffer *buffer = nullptr;
+        if (buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            buffers_.push_back(std::make_unique<ThreadBuffer>());
+            buffer = buffers_.back().get();
+            buffer->thread_id = static_cast<uint32_t>(buffers_.size() - 1);
+            buffer->events.reserve(1024);
+        }
+        return *buffer;
+    }
+
+    void Tracer::write_chrome_trace(std::ostream &stream) const {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        std::ios state(nullptr);
+        state.copyfmt(stream);
+        stream << std::fixed << std::setprecision(3);
+
+        stream << "{\"traceEvents\": [";
+        bool first = true;
+        for (const auto &buffer: buffers_) {
+            stream << (first ? "\n" : ",\n");
+            first = false;
+            stream << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << buffer->thread_id
+                   << ", \"args\": {\"name\": \"thread " << buffer->thread_id << "\"}}";
+            for (const auto &event: buffer->events) {
+                stream << ",\n  {\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << buffer->thread_id
+                       << ", \"ts\": " << static_cast<double>(event.begin_ns - origin_ns_) / 1e3
+                       << ", \"dur\": " << static_cast<double>(event.duration_ns) / 1e3 << "}";
+            }
+        }
+        stream << "\n], \"displayTimeUnit\": \"ms\"}" << std::endl;
+
+        stream.copyfmt(state);
+    }
+
+    void Tracer::flush() const {
+        if (output_path_.empty()) {
+            return;
+        }
+        std::ofstream output(output_path_);
+        write_chrome_trace(output);
+    }
+
+    ScopedTimer::ScopedTimer(const char *name) :
+            name_(name),
+            begin_ns_(now_ns()) {
+    }
+
+    ScopedTimer::~ScopedTimer() {
+        stop();
+    }
+
+    uint64_t ScopedTimer::stop() {
+        if (end_ns_ == 0) {
+            end_ns_ = now_ns();
+            if (Tracer::is_enabled()) {
+                Tracer::instance().record(name_, begin_ns_, end_ns_);
+            }
+        }
+        return static_cast<uint64_t>((end_ns_ - begin_ns_) / 1000);
+    }
+
+    std::string ScopedTimer::stop_human_readable() {
+        return convert_us_to_human_readable(stop());
+    }
+}
@@ -0,0 +1,199 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_TRACING_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_TRACING_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Пространство имён, объединяющее замер времени и трассировку этапов вычислений.
+ */
+namespace tracing_library {
+
+    /**
+     * @brief Конвертирует количество микросекунд в человекопонятный формат.
+     * @param duration_us Длительность в микросекундах.
+     * @return Строка с человекопонятной записью.
+     */
+    std::string convert_us_to_human_readable(uint64_t duration_us);
+
+    /**
+     * @brief Текущее время монотонных часов в наносекундах.
+     * @return Количество наносекунд от произвольной точки отсчёта.
+     */
+    int64_t now_ns();
+
+    /**
+     * @brief Завершённый интервал времени (span) на одном потоке.
+     */
+    struct TraceEvent {
+        /**
+         * @brief Имя интервала. Должно жить до конца программы, ожидается строковый литерал.
+         */
+        const char *name;
+        int64_t begin_ns;
+        int64_t duration_ns;
+    };
+
+    /**
+     * @brief Сборщик трассы.
+     * @details Каждый поток пишет события в свой буфер без блокировок,
+     * @details мьютекс берётся только один раз при регистрации буфера нового потока.
+     * @details При завершении программы все буферы сбрасываются в файл в формате Chrome trace-event JSON
+     * @details (открывается в chrome://tracing или https://ui.perfetto.dev).
+     * @details Выключен по умолчанию. Включается переменной окружения HPC_TRACE=<file> или вызовом set_output_path.
+     * @details Буферы не защищены от чтения во время записи, поэтому write_chrome_trace нужно вызывать,
+     * @details когда параллельные области уже завершились.
+     */
+    class Tracer {
+    public:
+        /**
+         * @brief Получить единственный экземпляр.
+         * @return Ссылка на сборщик.
+         */
+        static Tracer& instance();
+
+        ~Tracer();
+
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+        /**
+         * @brief Включена ли трассировка. Единственная проверка, которая выполняется при выключенной трассировке.
+         * @return True, если события нужно записывать.
+         */
+        static bool is_enabled() {
+            return enabled_;
+        }
+
+        /**
+         * @brief Включить трассировку с записью в файл при завершении программы.
+         * @param path Путь к файлу трассы. Пустая строка выключает трассировку.
+         */
+        void set_output_path(const std::string& path);
+
+        /**
+         * @brief Записать завершённый интервал в буфер текущего потока.
+         * @param name Имя интервала.
+         * @param begin_ns Время начала.
+         * @param end_ns Время окончания.
+         */
+        void record(const char *name, int64_t begin_ns, int64_t end_ns);
+
+        /**
+         * @brief Напечатать все накопленные события в формате Chrome trace-event JSON.
+         * @param stream Поток вывода.
+         */
+        void write_chrome_trace(std::ostream& stream) const;
+
+        /**
+         * @brief Записать трассу в файл, если он задан.
+         */
+        void flush() const;
+
+    private:
+        Tracer();
+
+        /**
+         * @brief Буфер событий одного потока.
+         */
+        struct ThreadBuffer {
+            uint32_t thread_id;
+            std::vector<TraceEvent> events;
+        };
+
+        /**
+         * @brief Получить буфер текущего потока, при первом обращении зарегистрировать его.
+         * @return Ссылка на буфер.
+         */
+        ThreadBuffer& local_buffer();
+
+        static bool enabled_;
+
+        std::string output_path_;
+        int64_t origin_ns_;
+        mutable std::mutex registry_mutex_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    };
+
+    /**
+     * @brief Интервал трассы, ограниченный областью видимости.
+     * @details RAII: время начала берётся в конструкторе, событие записывается в деструкторе.
+     * @details Вложенные интервалы на одном потоке отображаются вложенными.
+     * @details Можно использовать внутри параллельных областей OMP: у каждого потока свой буфер.
+     */
+    class TraceSpan {
+    public:
+        /**
+         * @brief Начать интервал.
+         * @param name Имя интервала. Строковый литерал.
+         */
+        explicit TraceSpan(const char *name) : name_(name) {
+            if (Tracer::is_enabled()) {
+                begin_ns_ = now_ns();
+            }
+        }
+
+        ~TraceSpan() {
+            if (begin_ns_ != 0) {
+                Tracer::instance().record(name_, begin_ns_, now_ns());
+            }
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        const char *name_;
+        int64_t begin_ns_{0};
+    };
+
+    /**
+     * @brief Таймер, ограниченный областью видимости.
+     * @details Всегда замеряет время, чтобы его можно было напечатать.
+     * @details Если трассировка включена, дополнительно записывает интервал в трассу.
+     */
+    class ScopedTimer {
+    public:
+        /**
+         * @brief Запустить таймер.
+         * @param name Имя интервала в трассе. Строковый литерал.
+         */
+        explicit ScopedTimer(const char *name);
+
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        /**
+         * @brief Остановить таймер. Повторные вызовы не меняют результат.
+         * @return Длительность в микросекундах.
+         */
+        uint64_t stop();
+
+        /**
+         * @brief Остановить таймер и получить длительность в человекопонятном формате.
+         * @return Строка с длительностью.
+         */
+        std::string stop_human_readable();
+
+    private:
+        const char *name_;
+        int64_t begin_ns_;
+        int64_t end_ns_{0};
+    };
+}
+
+#define TRACING_CONCATENATE_IMPLEMENTATION(lhs, rhs) lhs##rhs
+#define TRACING_CONCATENATE(lhs, rhs) TRACING_CONCATENATE_IMPLEMENTATION(lhs, rhs)
+
+/**
+ * @brief Записать в трассу интервал до конца текущей области видимости.
+ */
+#define TRACE_SCOPE(name) tracing_library::TraceSpan TRACING_CONCATENATE(trace_span_, __LINE__)(name)
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_TRACING_H
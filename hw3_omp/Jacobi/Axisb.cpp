@@ -1,67 +1,385 @@
-#include <chrono>
-#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
 
 #include "Matrix.h"
 #include "LinearSystem.h"
 #include "JacobiSolver.h"
+#include "GaussSeidelSolver.h"
+#include "SORSolver.h"
+#include "ConjugateGradientSolver.h"
+#include "BiCGSTABSolver.h"
+#include "GMRESSolver.h"
+#include "LUSolver.h"
+#include "CholeskySolver.h"
+#include "RefinementSolver.h"
+#include "SparseLinearSystem.h"
+#include "StencilJacobiSolver.h"
+#include "PerfCounters.h"
+#include "Scaling.h"
+#include "Tracing.h"
 
+/**
+ * @brief Максимальное отклонение найденного решения от известного.
+ * @param x Найденное решение.
+ * @param expected Известное решение.
+ * @return max_i |x[i] - expected[i]|.
+ */
+float max_error(const matrix_library::Matrix &x, const matrix_library::Matrix &expected) {
+    float error = 0.0f;
+    for (size_t i = 0; i < expected.get_row_count(); ++i) {
+        error = std::max(error, std::abs(x.get_element(i, 0) - expected.get_element(i, 0)));
+    }
+    return error;
+}
 
 /**
- * @brief Конвертирует количество микросекунд в человекопонятный формат.
- * @param duration_us Длительность в микросекундах.
- * @return Строка с человекопонятной записью.
+ * @brief Напечатать итог итерационного метода.
+ * @details Если метод не сошёлся, вместо времени печатается причина остановки и невязка.
+ * @param result Результат метода.
+ * @param elapsed Время решения в читаемом виде.
  */
-std::string convert_us_to_human_readable(uint64_t duration_us){
-    if (duration_us < 1e3) {
-        return std::to_string(duration_us) + " us";
+void print_result(const linear_systems_library::SolverResult &result, const std::string &elapsed) {
+    if (result.converged()) {
+        std::cout << "x is calculated in " << elapsed << " (" << result.iterations << " iterations)." << std::endl;
+    } else {
+        std::cout << "Stopped with status " << linear_systems_library::to_string(result.status) << " after "
+                  << result.iterations << " iterations, residual " << result.residual << "." << std::endl;
     }
+}
+
+/**
+ * @brief Напечатать итог итерационного метода на разреженной системе и ошибку относительно известного решения.
+ * @param result Результат метода.
+ * @param elapsed Время решения в читаемом виде.
+ * @param system СЛАУ с известным решением.
+ */
+void print_sparse_result(const linear_systems_library::SolverResult &result, const std::string &elapsed,
+                         const linear_systems_library::SparseLinearSystem &system) {
+    print_result(result, elapsed);
+    std::cout << "Max error is " << max_error(result.x, system.get_x()) << "." << std::endl;
+}
 
-    std::stringstream ss;
-    ss << std::fixed;
-    ss << std::setprecision(2);
-    if (duration_us < 1e6) {
-        ss << static_cast<double>(duration_us) / 1e3 << " ms";
-        return ss.str();
+/**
+ * @brief Создать основную СЛАУ: сгенерировать или прочитать из файла.
+ * @details Если файл задан, но его нет, система генерируется сразу в файл и читается из него,
+ * @details так что следующие запуски не тратят время на генерацию.
+ * @details Бросает std::invalid_argument, если в файле система другого размера.
+ * @param size Размер системы.
+ * @param path Путь к файлу системы, если задан.
+ * @param seed Зерно генератора, если задано.
+ * @return СЛАУ с известным решением.
+ */
+linear_systems_library::LinearSystem make_system(size_t size, const std::optional<std::string> &path,
+                                                 std::optional<uint64_t> seed) {
+    if (!path) {
+        return linear_systems_library::LinearSystem(size, true, false, 1, seed);
     }
-    if (duration_us < 1e9) {
-        ss << static_cast<double>(duration_us) / 1e6 << " s";
-        return ss.str();
+    if (!std::ifstream(path.value())) {
+        linear_systems_library::LinearSystem::generate_to_file(path.value(), size, true, false, 1, seed.value_or(0));
+    }
+    auto system = linear_systems_library::LinearSystem::load(path.value());
+    if (system.get_A().get_row_count() != size) {
+        throw std::invalid_argument("The system in " + path.value() + " has size " +
+                                    std::to_string(system.get_A().get_row_count()) + ", not " + std::to_string(size) + ".");
+    }
+    return system;
+}
+
+/**
+ * @brief Решить СЛАУ итерационным уточнением в смешанной точности и напечатать время и достигнутую точность.
+ * @tparam Working Точность внутреннего метода.
+ * @tparam Residual Точность невязки и решения.
+ * @tparam Inner Внутренний метод.
+ * @param description Описание варианта для вывода.
+ * @param A Матрица коэффициентов.
+ * @param b Вектор-столбец свободных членов.
+ * @param reference Решение чистым double-вариантом для сравнения, если есть.
+ * @return Решение, переведённое в double.
+ */
+template<typename Working, typename Residual,
+        linear_systems_library::InnerSolver Inner = linear_systems_library::InnerSolver::LU>
+std::vector<double> run_refinement(const std::string &description, const matrix_library::Matrix &A,
+                                   const matrix_library::Matrix &b, const std::vector<double> *reference = nullptr) {
+    using Solver = linear_systems_library::RefinementSolver<Working, Residual, Inner>;
+    std::cout << "Work in " << omp_get_num_procs() << " thread with iterative refinement: " << description << "." << std::endl;
+    tracing_library::ScopedTimer timer("refinement_solve");
+    Solver solver(A);
+    auto result = solver.solve(b);
+    std::string elapsed = timer.stop_human_readable();
+    std::vector<double> x(result.x.begin(), result.x.end());
+    std::cout << "x is calculated in " << elapsed << " (" << result.refinements << " refinements, "
+              << result.inner_iterations << " inner iterations), relative residual "
+              << Solver::relative_residual(A, b, x);
+    if (result.inner_status != linear_systems_library::SolverStatus::CONVERGED) {
+        std::cout << ", inner solver stopped with status " << linear_systems_library::to_string(result.inner_status);
     }
-    if (duration_us < 1e9 * 60) {
-        ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
-        return ss.str();
+    if (reference != nullptr) {
+        double difference = 0.0;
+        double reference_norm = 0.0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            difference = std::max(difference, std::abs(x[i] - (*reference)[i]));
+            reference_norm = std::max(reference_norm, std::abs((*reference)[i]));
+        }
+        std::cout << ", relative difference from double LU " << difference / reference_norm;
     }
+    std::cout << "." << std::endl;
+    return x;
+}
+
+/**
+ * @brief Решить ту же СЛАУ методом Якоби по шаблону, без хранения матрицы, и сравнить с известным решением.
+ * @tparam Stencil Шаблон, совпадающий с матрицей системы.
+ * @param system СЛАУ на квадратной или кубической сетке.
+ * @param side Количество узлов по стороне сетки.
+ */
+template<typename Stencil>
+void run_stencil(const linear_systems_library::SparseLinearSystem &system, size_t side) {
+    linear_systems_library::StencilJacobiSolver<Stencil> solver(side, side, Stencil::DIMENSIONS == 3 ? side : 1);
+    std::cout << "Work in " << omp_get_num_procs() << " thread with stencil Jacobi (" << Stencil::NEIGHBOURS.size() + 1
+              << "-point, temporal tiling)." << std::endl;
+    tracing_library::ScopedTimer timer("jacobi_solve_stencil");
+    auto result = solver.solve(system.get_b());
+    print_sparse_result(result, timer.stop_human_readable(), system);
+}
+
+/**
+ * @brief Решить разреженную СЛАУ методом Якоби в формате CSR и сравнить с известным решением.
+ * @details Для сеточных систем то же решается StencilJacobiSolver с соответствующим шаблоном.
+ * @details Бросает std::invalid_argument, если вид системы неизвестен.
+ * @param kind Вид системы: poisson1d, poisson2d, poisson3d, stencil27 или random.
+ * @param size Количество неизвестных (для poisson2d, poisson3d и stencil27 - узлов по стороне сетки).
+ * @param seed Зерно генератора, если задано.
+ */
+void run_sparse(const std::string &kind, size_t size, std::optional<uint64_t> seed) {
+    auto system = linear_systems_library::SparseLinearSystem::create(kind, size, seed);
+    const auto &A = system.get_A();
+    std::cout << "Sparse system " << kind << ": " << A.get_row_count() << " unknowns, " << A.get_nonzero_count()
+              << " nonzeros, " << A.get_memory_size() / (1 << 20) << " MB in CSR." << std::endl;
 
-    return std::to_string(duration_us) + " us";
+    std::cout << "Work in " << omp_get_num_procs() << " thread with CSR Jacobi." << std::endl;
+    tracing_library::ScopedTimer timer("jacobi_solve_csr");
+    auto result = linear_systems_library::JacobiSolver::solve_csr(system);
+    print_sparse_result(result, timer.stop_human_readable(), system);
+
+    if (kind == "poisson2d") {
+        run_stencil<linear_systems_library::FivePointStencil>(system, size);
+    } else if (kind == "poisson3d") {
+        run_stencil<linear_systems_library::SevenPointStencil>(system, size);
+    } else if (kind == "stencil27") {
+        run_stencil<linear_systems_library::TwentySevenPointStencil>(system, size);
+    }
 }
 
 int main(int argc, char *argv[]) {
+    std::vector<size_t> threads_counts;
+    bool scaling = benchmark_library::handle_scaling_option(argc, argv, threads_counts);
+    std::optional<std::string> system_path = benchmark_library::take_option(argc, argv, "--system=");
+    std::optional<std::string> seed_option = benchmark_library::take_option(argc, argv, "--seed=");
+    std::optional<uint64_t> seed;
+    if (seed_option) {
+        seed = std::stoull(seed_option.value());
+    }
+
     if (argc < 2) {
-        std::cout << "Specify the size of system.";
+        std::cout << "Specify the size of system and, optionally, the number of right-hand sides for the block solver.";
         return -1;
     }
 
     omp_set_dynamic(0);  // отключаем динамический выбор количества потоков
 
-    linear_systems_library::LinearSystem system(std::stoul(argv[1]));
+    const std::string sparse_option = "--sparse=";
+    std::string first_argument(argv[1]);
+    if (first_argument.rfind(sparse_option, 0) == 0) {
+        if (argc < 3) {
+            std::cout << "Specify the size of sparse system.";
+            return -1;
+        }
+        run_sparse(first_argument.substr(sparse_option.size()), std::stoul(argv[2]), seed);
+        return 0;
+    }
+
+    size_t system_size = std::stoul(argv[1]);
+    size_t rhs_count = argc > 2 ? std::stoul(argv[2]) : 16;
+    tracing_library::ScopedTimer timer_setup("linear_system_setup");
+    linear_systems_library::LinearSystem system = make_system(system_size, system_path, seed);
+    std::cout << "System is " << (system_path ? "loaded" : "generated") << " in " << timer_setup.stop_human_readable() << "." << std::endl;
+
+    if (scaling) {
+        benchmark_library::ScalingStudy study(matrix_library::set_threads_count, threads_counts);
+        study.run("jacobi_omp", system_size, 0.0, 0.0, [&]() {
+            auto x = linear_systems_library::JacobiSolver::solve_omp(system);
+        });
+        study.run("jacobi_matrix_free", system_size, 0.0, 0.0, [&]() {
+            auto x = linear_systems_library::JacobiSolver::solve_matrix_free(system);
+        });
+        study.run("gauss_seidel", system_size, 0.0, 0.0, [&]() {
+            auto x = linear_systems_library::GaussSeidelSolver::solve(system);
+        });
+        study.run("sor", system_size, 0.0, 0.0, [&]() {
+            auto x = linear_systems_library::SORSolver::solve(system);
+        });
+        study.run("bicgstab", system_size, 0.0, 0.0, [&]() {
+            auto x = linear_systems_library::BiCGSTABSolver::solve(system);
+        });
+        study.run("gmres", system_size, 0.0, 0.0, [&]() {
+            auto x = linear_systems_library::GMRESSolver::solve(system);
+        });
+        using Mixed = linear_systems_library::RefinementSolver<float, double>;
+        using Double = linear_systems_library::RefinementSolver<double, double>;
+        std::vector<double> x_mixed;
+        std::vector<double> x_double;
+        study.run("refinement_float_double", system_size, 0.0, 0.0, [&]() {
+            auto result = Mixed::solve(system);
+            x_mixed.assign(result.x.begin(), result.x.end());
+        });
+        study.run("lu_double", system_size, 0.0, 0.0, [&]() {
+            auto result = Double::solve(system);
+            x_double.assign(result.x.begin(), result.x.end());
+        });
+        study.write();
+        std::cout << "Relative residual: refinement_float_double "
+                  << Mixed::relative_residual(system.get_A(), system.get_b(), x_mixed) << ", lu_double "
+                  << Double::relative_residual(system.get_A(), system.get_b(), x_double) << "." << std::endl;
+        return 0;
+    }
 
     std::cout << "Work in 1 thread without omp." << std::endl;
-    omp_set_num_threads(1);
-    openblas_set_num_threads(1);
-
-    auto begin = std::chrono::steady_clock::now();
-    auto x = linear_systems_library::JacobiSolver::solve(system);
-    auto end = std::chrono::steady_clock::now();
-    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "x is calculated in " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
-
-    std::cout << "Work in " << omp_get_num_procs() << " thread with omp and openblas threading." << std::endl;
-    omp_set_num_threads(omp_get_num_procs());
-    openblas_set_num_threads(omp_get_num_procs());
-
-    begin = std::chrono::steady_clock::now();
-    auto x_omp = linear_systems_library::JacobiSolver::solve_omp(system);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "x is calculated in " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    matrix_library::set_threads_count(1);
+
+    tracing_library::ScopedTimer timer("jacobi_solve");
+    auto result = linear_systems_library::JacobiSolver::solve(system);
+    std::cout << "x is calculated in " << timer.stop_human_readable() << " (" << result.iterations << " iterations)." << std::endl;
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with omp and " << matrix_library::BlasBackend::instance().get_name() << " threading." << std::endl;
+    matrix_library::set_threads_count(omp_get_num_procs());
+
+    tracing_library::ScopedTimer timer_omp("jacobi_solve_omp");
+    auto result_omp = linear_systems_library::JacobiSolver::solve_omp(system);
+    std::cout << "x is calculated in " << timer_omp.stop_human_readable() << " (" << result_omp.iterations << " iterations)." << std::endl;
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread without forming D^-1 and B (matrix-free)." << std::endl;
+    tracing_library::ScopedTimer timer_matrix_free("jacobi_solve_matrix_free");
+    auto result_matrix_free = linear_systems_library::JacobiSolver::solve_matrix_free(system);
+    std::cout << "x is calculated in " << timer_matrix_free.stop_human_readable() << " (" << result_matrix_free.iterations << " iterations)." << std::endl;
+
+    /**
+     * s-step: сходимость проверяется раз в несколько итераций, между проверками нет глобальных редукций.
+     */
+    linear_systems_library::SolverOptions s_step_options;
+    s_step_options.steps_per_check = 8;
+    std::cout << "Work in " << omp_get_num_procs() << " thread with matrix-free Jacobi, convergence checked every "
+              << s_step_options.steps_per_check << " iterations." << std::endl;
+    tracing_library::ScopedTimer timer_s_step("jacobi_solve_matrix_free_s_step");
+    auto result_s_step = linear_systems_library::JacobiSolver::solve_matrix_free(system, s_step_options);
+    std::cout << "x is calculated in " << timer_s_step.stop_human_readable() << " (" << result_s_step.iterations << " iterations)." << std::endl;
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with Gauss-Seidel, red-black ordering." << std::endl;
+    tracing_library::ScopedTimer timer_gauss_seidel("gauss_seidel_solve");
+    auto result_gauss_seidel = linear_systems_library::GaussSeidelSolver::solve(system, linear_systems_library::SolverOptions(), linear_systems_library::Ordering::RED_BLACK);
+    std::cout << "x is calculated in " << timer_gauss_seidel.stop_human_readable() << " (" << result_gauss_seidel.iterations << " iterations)." << std::endl;
+
+    float relaxation_factor = linear_systems_library::SORSolver::estimate_relaxation_factor(system);
+    std::cout << "Work in " << omp_get_num_procs() << " thread with SOR, red-black ordering, w = " << relaxation_factor << "." << std::endl;
+    tracing_library::ScopedTimer timer_sor("sor_solve");
+    auto result_sor = linear_systems_library::SORSolver::solve(system, linear_systems_library::SolverOptions(), relaxation_factor, linear_systems_library::Ordering::RED_BLACK);
+    std::cout << "x is calculated in " << timer_sor.stop_human_readable() << " (" << result_sor.iterations << " iterations)." << std::endl;
+
+    /**
+     * Без диагонального преобладания метод Якоби может расходиться. Итерации не крутятся вечно:
+     * монитор останавливает их по росту невязки.
+     */
+    linear_systems_library::LinearSystem non_dominant_system(system_size, false, false, 1, seed);
+    std::cout << "Work in " << omp_get_num_procs() << " thread with matrix-free Jacobi on a system without diagonal dominance." << std::endl;
+    auto result_non_dominant = linear_systems_library::JacobiSolver::solve_matrix_free(non_dominant_system);
+    std::cout << "Stopped with status " << linear_systems_library::to_string(result_non_dominant.status) << " after "
+              << result_non_dominant.iterations << " iterations, residual " << result_non_dominant.residual << "." << std::endl;
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with BiCGSTAB." << std::endl;
+    tracing_library::ScopedTimer timer_bicgstab("bicgstab_solve");
+    auto result_bicgstab = linear_systems_library::BiCGSTABSolver::solve(system);
+    print_result(result_bicgstab, timer_bicgstab.stop_human_readable());
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with GMRES(30)." << std::endl;
+    tracing_library::ScopedTimer timer_gmres("gmres_solve");
+    auto result_gmres = linear_systems_library::GMRESSolver::solve(system);
+    print_result(result_gmres, timer_gmres.stop_human_readable());
+
+    /**
+     * Метод сопряжённых градиентов требует симметричной положительно определённой матрицы.
+     */
+    linear_systems_library::LinearSystem symmetric_system(system_size, true, true, 1, seed);
+    linear_systems_library::JacobiPreconditioner jacobi_preconditioner(symmetric_system.get_A());
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with CG on a symmetric system." << std::endl;
+    tracing_library::ScopedTimer timer_cg("cg_solve");
+    auto result_cg = linear_systems_library::ConjugateGradientSolver::solve(symmetric_system);
+    print_result(result_cg, timer_cg.stop_human_readable());
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with Jacobi-preconditioned CG on a symmetric system." << std::endl;
+    tracing_library::ScopedTimer timer_pcg("pcg_solve");
+    auto result_pcg = linear_systems_library::ConjugateGradientSolver::solve(symmetric_system, linear_systems_library::SolverOptions(),
+                                                                             &jacobi_preconditioner);
+    print_result(result_pcg, timer_pcg.stop_human_readable());
+
+    /**
+     * Прямые методы: разложение считается один раз, после чего каждая правая часть стоит O(n^2).
+     */
+    std::cout << "Work in " << omp_get_num_procs() << " thread with blocked LU." << std::endl;
+    tracing_library::ScopedTimer timer_lu("lu_factorization");
+    linear_systems_library::LUSolver lu(system.get_A());
+    std::cout << "LU is calculated in " << timer_lu.stop_human_readable() << "." << std::endl;
+    tracing_library::ScopedTimer timer_lu_solve("lu_solve");
+    auto x_lu = lu.solve(system.get_b());
+    std::cout << "x is calculated in " << timer_lu_solve.stop_human_readable() << "." << std::endl;
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with blocked Cholesky on a symmetric system." << std::endl;
+    tracing_library::ScopedTimer timer_cholesky("cholesky_factorization");
+    linear_systems_library::CholeskySolver cholesky(symmetric_system.get_A());
+    std::cout << "L is calculated in " << timer_cholesky.stop_human_readable() << "." << std::endl;
+    tracing_library::ScopedTimer timer_cholesky_solve("cholesky_solve");
+    auto x_cholesky = cholesky.solve(symmetric_system.get_b());
+    std::cout << "x is calculated in " << timer_cholesky_solve.stop_human_readable() << "." << std::endl;
+
+    /**
+     * Смешанная точность: поправка ищется в float, невязка и решение - в double.
+     * Точность сравнивается с LU-разложением целиком в double.
+     */
+    using linear_systems_library::InnerSolver;
+    auto x_double = run_refinement<double, double>("double LU, double residual", system.get_A(), system.get_b());
+    run_refinement<float, float>("float LU, float residual", system.get_A(), system.get_b(), &x_double);
+    run_refinement<float, double>("float LU, double residual", system.get_A(), system.get_b(), &x_double);
+    run_refinement<float, double, InnerSolver::JACOBI>("float Jacobi, double residual", system.get_A(), system.get_b(),
+                                                       &x_double);
+    run_refinement<float, double, InnerSolver::CONJUGATE_GRADIENT>("float CG on a symmetric system, double residual",
+                                                                   symmetric_system.get_A(), symmetric_system.get_b());
+
+    /**
+     * Одна матрица и много правых частей: блочный метод Якоби против решения по одной правой части.
+     */
+    linear_systems_library::LinearSystem block_system(system_size, true, false, rhs_count, seed);
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with block Jacobi, " << rhs_count << " right-hand sides at once." << std::endl;
+    tracing_library::ScopedTimer timer_block("jacobi_solve_block");
+    auto result_block = linear_systems_library::JacobiSolver::solve_block(block_system);
+    std::cout << "X is calculated in " << timer_block.stop_human_readable() << " (" << result_block.iterations << " iterations)." << std::endl;
+
+    std::cout << "Work in " << omp_get_num_procs() << " thread with Jacobi, " << rhs_count << " right-hand sides one by one." << std::endl;
+    tracing_library::ScopedTimer timer_one_by_one("jacobi_solve_one_by_one");
+    matrix_library::Matrix b_column(system_size, 1);
+    for (size_t c = 0; c < rhs_count; ++c) {
+        for (size_t i = 0; i < system_size; ++i) {
+            b_column.get_element(i, 0) = block_system.get_b().get_element(i, c);
+        }
+        auto x_column = linear_systems_library::JacobiSolver::solve_block(block_system.get_A(), b_column);
+    }
+    std::cout << "X is calculated in " << timer_one_by_one.stop_human_readable() << "." << std::endl;
+
+    if (benchmark_library::PerfProfiler::instance().is_enabled()) {
+        std::cout << std::endl;
+        benchmark_library::PerfProfiler::instance().write_summary();
+    }
 }
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <mpi.h>
+
+#include "Matrix.h"
+#include "LinearSystem.h"
+#include "SparseLinearSystem.h"
+#include "DistributedJacobiSolver.h"
+#include "Scaling.h"
+#include "Tracing.h"
+
+/**
+ * @brief Максимальное отклонение найденного решения от известного.
+ * @param x Найденное решение.
+ * @param expected Известное решение.
+ * @return max_i |x[i] - expected[i]|.
+ */
+float max_error(const matrix_library::Matrix &x, const matrix_library::Matrix &expected) {
+    float error = 0.0f;
+    for (size_t i = 0; i < expected.get_row_count(); ++i) {
+        error = std::max(error, std::abs(x.get_element(i, 0) - expected.get_element(i, 0)));
+    }
+    return error;
+}
+
+/**
+ * @brief Напечатать итог метода и ошибку относительно известного решения.
+ * @details Если метод не сошёлся, вместо времени печатается причина остановки и невязка.
+ * @param result Результат метода.
+ * @param elapsed Время решения в читаемом виде.
+ * @param x Решение, собранное со всех процессов.
+ * @param expected Известное решение.
+ */
+void print_result(const linear_systems_library::SolverResult &result, const std::string &elapsed,
+                  const matrix_library::Matrix &x, const matrix_library::Matrix &expected) {
+    if (result.converged()) {
+        std::cout << "x is calculated in " << elapsed << " (" << result.iterations << " iterations)." << std::endl;
+    } else {
+        std::cout << "Stopped with status " << linear_systems_library::to_string(result.status) << " after "
+                  << result.iterations << " iterations, residual " << result.residual << "." << std::endl;
+    }
+    std::cout << "Max error is " << max_error(x, expected) << "." << std::endl;
+}
+
+/**
+ * @brief Сообщить всем процессам, удалось ли процессу 0 создать систему.
+ * @details Вызывается до первой коллективной операции с системой: иначе при ошибке процесс 0 завершился бы,
+ * @details а остальные ждали бы его в scatter_rows.
+ * @param error Текст ошибки на процессе 0. Пустой, если ошибки нет; на остальных процессах не используется.
+ * @param rank Номер процесса.
+ * @return True на всех процессах, если система не создана.
+ */
+bool broadcast_failure(const std::string &error, int rank) {
+    int failed = (rank == 0 && !error.empty()) ? 1 : 0;
+    MPI_Bcast(&failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (failed != 0 && rank == 0) {
+        std::cout << error << std::endl;
+    }
+    return failed != 0;
+}
+
+int main(int argc, char *argv[]) {
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank, comm_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+
+    std::optional<std::string> steps_option = benchmark_library::take_option(argc, argv, "--steps-per-check=");
+    const size_t steps_per_check = steps_option ? std::stoul(steps_option.value()) : 1;
+    if (steps_per_check == 0) {
+        if (rank == 0) {
+            std::cout << "The number of steps per convergence check must be positive." << std::endl;
+        }
+        MPI_Finalize();
+        return -1;
+    }
+    linear_systems_library::SolverOptions options;
+    options.steps_per_check = steps_per_check;
+
+    std::optional<std::string> seed_option = benchmark_library::take_option(argc, argv, "--seed=");
+    std::optional<uint64_t> seed;
+    if (seed_option) {
+        seed = std::stoull(seed_option.value());
+    }
+
+    if (argc < 2) {
+        if (rank == 0) {
+            std::cout << "Specify the size of system or --sparse=<kind> and the size of sparse system." << std::endl;
+        }
+        MPI_Finalize();
+        return -1;
+    }
+
+    /**
+     * Систему создаёт процесс 0 и раздаёт блоки строк, решение собирается обратно для проверки.
+     */
+    const std::string sparse_option = "--sparse=";
+    std::string first_argument(argv[1]);
+    if (first_argument.rfind(sparse_option, 0) == 0) {
+        if (argc < 3) {
+            if (rank == 0) {
+                std::cout << "Specify the size of sparse system." << std::endl;
+            }
+            MPI_Finalize();
+            return -1;
+        }
+        std::string kind = first_argument.substr(sparse_option.size());
+        size_t size = std::stoul(argv[2]);
+        std::optional<linear_systems_library::SparseLinearSystem> system;
+        std::string error;
+        if (rank == 0) {
+            try {
+                system.emplace(linear_systems_library::SparseLinearSystem::create(kind, size, seed));
+                std::cout << "Sparse system " << kind << ": " << system->get_A().get_row_count() << " unknowns, "
+                          << system->get_A().get_nonzero_count() << " nonzeros." << std::endl;
+            } catch (const std::invalid_argument &exception) {
+                error = exception.what();
+            }
+        }
+        if (broadcast_failure(error, rank)) {
+            MPI_Finalize();
+            return -1;
+        }
+        auto A_rows = linear_systems_library::DistributedJacobiSolver::scatter_rows(
+                rank == 0 ? &system->get_A() : nullptr, MPI_COMM_WORLD);
+        auto b_rows = linear_systems_library::DistributedJacobiSolver::scatter_rows(
+                rank == 0 ? &system->get_b() : nullptr, MPI_COMM_WORLD);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        tracing_library::ScopedTimer timer("jacobi_mpi_csr");
+        auto result = linear_systems_library::DistributedJacobiSolver::solve_csr(A_rows, b_rows, MPI_COMM_WORLD, options);
+        MPI_Barrier(MPI_COMM_WORLD);
+        std::string elapsed = timer.stop_human_readable();
+        auto x = linear_systems_library::DistributedJacobiSolver::gather_rows(result.x, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "Work in " << comm_size << " processes with CSR Jacobi and halo exchange, convergence checked every "
+                      << steps_per_check << " iterations." << std::endl;
+            print_result(result, elapsed, x, system->get_x());
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    size_t system_size = std::stoul(argv[1]);
+    std::optional<linear_systems_library::LinearSystem> system;
+    if (rank == 0) {
+        system.emplace(system_size, true, false, 1, seed);
+    }
+    auto A_rows = linear_systems_library::DistributedJacobiSolver::scatter_rows(
+            rank == 0 ? &system->get_A() : nullptr, MPI_COMM_WORLD);
+    auto b_rows = linear_systems_library::DistributedJacobiSolver::scatter_rows(
+            rank == 0 ? &system->get_b() : nullptr, MPI_COMM_WORLD);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    tracing_library::ScopedTimer timer("jacobi_mpi");
+    auto result = linear_systems_library::DistributedJacobiSolver::solve(A_rows, b_rows, MPI_COMM_WORLD, options);
+    MPI_Barrier(MPI_COMM_WORLD);
+    std::string elapsed = timer.stop_human_readable();
+    auto x = linear_systems_library::DistributedJacobiSolver::gather_rows(result.x, MPI_COMM_WORLD);
+    if (rank == 0) {
+        std::cout << "Work in " << comm_size << " processes with dense Jacobi and MPI_Iallgatherv, convergence checked every "
+                  << steps_per_check << " iterations." << std::endl;
+        print_result(result, elapsed, x, system->get_x());
+    }
+
+    MPI_Finalize();
+    return 0;
+}
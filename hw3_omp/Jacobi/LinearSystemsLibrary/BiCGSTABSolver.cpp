@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+
+#include "BiCGSTABSolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+#include "VectorOperations.h"
+
+namespace linear_systems_library {
+
+    SolverResult BiCGSTABSolver::solve(const linear_systems_library::LinearSystem &system, const SolverOptions &options,
+                                       const Preconditioner *preconditioner) {
+        /**
+         * Об алгоритме: https://en.wikipedia.org/wiki/Biconjugate_gradient_stabilized_method
+         * Вместо транспонированной матрицы, как в BiCG, используется шаг минимизации невязки (omega),
+         * который сглаживает нерегулярную сходимость BiCG.
+         */
+        const auto &A = system.get_A();
+        assert(A.get_row_count() == A.get_column_count());
+        const size_t matrix_size = A.get_row_count();
+        auto n = static_cast<double>(matrix_size);
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, system.get_b().get_data()));
+
+        matrix_library::Matrix x_vector(matrix_size, 1);
+        matrix_library::Matrix r_vector(matrix_size, 1);
+        matrix_library::Matrix r_hat_vector(matrix_size, 1);
+        matrix_library::Matrix p_vector(matrix_size, 1);
+        matrix_library::Matrix v_vector(matrix_size, 1);
+        matrix_library::Matrix s_vector(matrix_size, 1);
+        matrix_library::Matrix t_vector(matrix_size, 1);
+        matrix_library::Matrix p_preconditioned_vector(matrix_size, 1);
+        matrix_library::Matrix s_preconditioned_vector(matrix_size, 1);
+        float *x = x_vector.get_data();
+        float *r = r_vector.get_data();
+        float *r_hat = r_hat_vector.get_data();
+        float *p = p_vector.get_data();
+        float *v = v_vector.get_data();
+        float *s = s_vector.get_data();
+        float *t = t_vector.get_data();
+        /**
+         * Без предобусловливателя M^-1 p = p и M^-1 s = s, отдельные векторы не нужны.
+         */
+        float *p_preconditioned = preconditioner != nullptr ? p_preconditioned_vector.get_data() : p;
+        float *s_preconditioned = preconditioner != nullptr ? s_preconditioned_vector.get_data() : s;
+        monitor.finish_setup();
+
+        TRACE_SCOPE("bicgstab_iterations");
+        benchmark_library::PerfRegion iterations_region("bicgstab_iterations");
+        double rr = VectorOperations::residual(A, x, system.get_b().get_data(), r);
+        std::copy(r, r + matrix_size, r_hat);
+
+        double rho = 1.0;
+        double alpha = 1.0;
+        double omega = 1.0;
+        size_t iterations = 0;
+        std::optional<SolverStatus> status;
+        if (monitor.is_residual_small(std::sqrt(rr))) {
+            status = SolverStatus::CONVERGED;
+        }
+        while (!status) {
+            iterations_region.add_flops(4.0 * n * n + 20.0 * n);
+            ++iterations;
+
+            double rho_next = VectorOperations::dot(matrix_size, r_hat, r);
+            if (rho_next == 0.0 || !std::isfinite(rho_next)) {
+                status = monitor.fail(std::sqrt(rr), SolverStatus::BREAKDOWN);  // r ортогональна r_hat
+                break;
+            }
+            double beta = (rho_next / rho) * (alpha / omega);
+            rho = rho_next;
+            VectorOperations::axpbypcz(matrix_size, 1.0f, r, static_cast<float>(-beta * omega), v,
+                                       static_cast<float>(beta), p);
+            if (preconditioner != nullptr) {
+                preconditioner->apply(p, p_preconditioned);
+            }
+            VectorOperations::multiply(A, p_preconditioned, v);
+            const double r_hat_v = VectorOperations::dot(matrix_size, r_hat, v);
+            if (r_hat_v == 0.0 || !std::isfinite(r_hat_v)) {
+                status = monitor.fail(std::sqrt(rr), SolverStatus::BREAKDOWN);
+                break;
+            }
+            alpha = rho / r_hat_v;
+
+            double ss = VectorOperations::waxpby_dot(matrix_size, 1.0f, r, static_cast<float>(-alpha), v, s);
+            if (!std::isfinite(ss)) {
+                status = monitor.fail(std::sqrt(rr), SolverStatus::DIVERGENCE);
+                break;
+            }
+            if (monitor.is_residual_small(std::sqrt(ss))) {
+                VectorOperations::axpy(matrix_size, static_cast<float>(alpha), p_preconditioned, x);
+                rr = ss;
+                status = monitor.finish_iteration(iterations, true, false, [rr]() { return std::sqrt(rr); });
+                break;
+            }
+
+            if (preconditioner != nullptr) {
+                preconditioner->apply(s, s_preconditioned);
+            }
+            VectorOperations::multiply(A, s_preconditioned, t);
+            double ts = 0.0;
+            double tt = 0.0;
+            VectorOperations::dot_pair(matrix_size, t, s, t, ts, tt);
+            if (tt == 0.0 || !std::isfinite(tt) || !std::isfinite(ts)) {
+                status = monitor.fail(std::sqrt(rr), SolverStatus::BREAKDOWN);
+                break;
+            }
+            omega = ts / tt;
+
+            VectorOperations::axpbypcz(matrix_size, static_cast<float>(alpha), p_preconditioned,
+                                       static_cast<float>(omega), s_preconditioned, 1.0f, x);
+            rr = VectorOperations::waxpby_dot(matrix_size, 1.0f, s, static_cast<float>(-omega), t, r);
+            if (!std::isfinite(rr)) {
+                status = monitor.fail(std::sqrt(rr), SolverStatus::DIVERGENCE);
+                break;
+            }
+            if (omega == 0.0) {
+                // шаг минимизации невязки ничего не дал, следующая beta делится на omega
+                status = monitor.fail(std::sqrt(rr), SolverStatus::BREAKDOWN);
+                break;
+            }
+            const double residual_norm = std::sqrt(rr);
+            status = monitor.finish_iteration(iterations, monitor.is_residual_small(residual_norm), false,
+                                              [residual_norm]() { return residual_norm; });
+        }
+        return monitor.make_result(std::move(x_vector), iterations, *status);
+    }
+}
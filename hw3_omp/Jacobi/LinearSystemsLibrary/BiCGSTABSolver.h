@@ -0,0 +1,33 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_BICGSTABSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_BICGSTABSOLVER_H
+
+#include <omp.h>
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Preconditioner.h"
+#include "SolverMonitor.h"
+
+namespace linear_systems_library {
+    class BiCGSTABSolver {
+    public:
+        /**
+         * @brief Решить СЛАУ с произвольной невырожденной матрицей стабилизированным методом бисопряжённых градиентов.
+         * @details Предобусловливание правое: решается A M^-1 u = b, x = M^-1 u, поэтому невязка не искажается.
+         * @details Итерация: два умножения A на вектор, четыре скалярных произведения
+         * @details (два из них совмещены в VectorOperations::dot_pair) и обновления векторов.
+         * @details Итерации не выделяют память. Сходимость - ||b - A x|| <= eps * ||b||, лимиты, расходимость
+         * @details и застой отслеживает SolverMonitor. При вырождении метода (нулевой или не конечный знаменатель)
+         * @details итерации прекращаются со статусом BREAKDOWN, если невязка перестала быть конечной - DIVERGENCE.
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @param preconditioner Предобусловливатель. Если nullptr, не используется.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve(const linear_systems_library::LinearSystem &system,
+                                  const SolverOptions &options = SolverOptions(),
+                                  const Preconditioner *preconditioner = nullptr);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_BICGSTABSOLVER_H
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "BlasBackend.h"
+#include "CholeskySolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+
+namespace linear_systems_library {
+
+    CholeskySolver::CholeskySolver(const matrix_library::Matrix &A, size_t block_size) : L_(A) {
+        /**
+         * Об алгоритме: https://ru.wikipedia.org/wiki/Разложение_Холецкого
+         * Блочный вариант: dpotrf из LAPACK.
+         */
+        assert(A.get_row_count() == A.get_column_count());
+        assert(block_size > 0);
+        const size_t matrix_size = A.get_row_count();
+        const size_t blocks_count = (matrix_size + block_size - 1) / block_size;
+        auto n = static_cast<double>(matrix_size);
+
+        TRACE_SCOPE("cholesky_factorization");
+        benchmark_library::PerfRegion factorization_region("cholesky_factorization", n * n * n / 3.0);
+        /**
+         * Зависимости задач - как в LUSolver, по одному адресу на блок столбцов.
+         */
+        std::vector<char> block_tokens(blocks_count);
+        bool not_positive_definite = false;
+        matrix_library::SingleThreadedBlas single_threaded_blas;  // sgemm вызывается из задач, каждая уже занимает поток OMP
+#pragma omp parallel default(none) shared(matrix_size, block_size, blocks_count, block_tokens, not_positive_definite)
+#pragma omp single
+        for (size_t k = 0; k < blocks_count; ++k) {
+            const size_t panel_column = k * block_size;
+            const size_t panel_width = std::min(block_size, matrix_size - panel_column);
+#pragma omp task default(shared) firstprivate(panel_column, panel_width) depend(inout: block_tokens.data()[k])
+            {
+                if (!factorize_panel(panel_column, panel_width)) {
+#pragma omp atomic write
+                    not_positive_definite = true;
+                }
+            }
+            for (size_t j = k + 1; j < blocks_count; ++j) {
+                const size_t column = j * block_size;
+                const size_t width = std::min(block_size, matrix_size - column);
+#pragma omp task default(shared) firstprivate(panel_column, panel_width, column, width) \
+        depend(in: block_tokens.data()[k]) depend(inout: block_tokens.data()[j])
+                update_block(panel_column, panel_width, column, width);
+            }
+        }
+
+        if (not_positive_definite) {
+            throw std::invalid_argument("Matrix is not positive definite.");
+        }
+
+#pragma omp parallel for default(none) shared(matrix_size)
+        for (size_t i = 0; i < matrix_size; ++i) {
+            std::fill(&L_.get_element(i, 0) + i + 1, &L_.get_element(i, 0) + matrix_size, 0.0f);
+        }
+    }
+
+    matrix_library::Matrix CholeskySolver::solve(const matrix_library::Matrix &B) const {
+        const size_t matrix_size = L_.get_row_count();
+        assert(B.get_row_count() == matrix_size);
+        const size_t rhs_count = B.get_column_count();
+
+        TRACE_SCOPE("cholesky_solve");
+        matrix_library::Matrix X(B);
+#pragma omp parallel default(none) shared(matrix_size, rhs_count, X)
+        {
+            std::vector<float> column(matrix_size);
+#pragma omp for schedule(dynamic)
+            for (size_t c = 0; c < rhs_count; ++c) {
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    column[i] = X.get_element(i, c);
+                }
+                /**
+                 * Прямой ход L y = b по строкам L. Обратный ход L^T x = y тоже идёт по строкам L:
+                 * найденная x[i] сразу вычитается из всех y[p], p < i, - так память читается подряд.
+                 */
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    const float *l_row = &L_.get_element(i, 0);
+                    float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+                    for (size_t p = 0; p < i; ++p) {
+                        sum += l_row[p] * column[p];
+                    }
+                    column[i] = (column[i] - sum) / l_row[i];
+                }
+                for (size_t i = matrix_size; i-- > 0;) {
+                    const float *l_row = &L_.get_element(i, 0);
+                    float x_i = column[i] / l_row[i];
+                    column[i] = x_i;
+#pragma omp simd
+                    for (size_t p = 0; p < i; ++p) {
+                        column[p] -= l_row[p] * x_i;
+                    }
+                }
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    X.get_element(i, c) = column[i];
+                }
+            }
+        }
+        return X;
+    }
+
+    matrix_library::Matrix CholeskySolver::solve(const linear_systems_library::LinearSystem &system, size_t block_size) {
+        return CholeskySolver(system.get_A(), block_size).solve(system.get_b());
+    }
+
+    const matrix_library::Matrix &CholeskySolver::get_factor() const {
+        return L_;
+    }
+
+    bool CholeskySolver::factorize_panel(size_t column, size_t width) {
+        const size_t matrix_size = L_.get_row_count();
+        float *a = L_.get_data();
+        const size_t panel_end = column + width;
+
+        /**
+         * По строкам сверху вниз: L[i][j] = (A[i][j] - sum_p L[i][p] * L[j][p]) / L[j][j] для j < i,
+         * L[i][i] = sqrt(A[i][i] - sum_p L[i][p]^2) для строк диагонального блока.
+         * Строки под диагональным блоком дают L21 = A21 L11^-T.
+         * Вклад предыдущих панелей уже вычтен обновлениями, поэтому суммы идут только по столбцам панели.
+         */
+        for (size_t i = column; i < matrix_size; ++i) {
+            float *l_i = a + i * matrix_size;
+            const size_t row_end = std::min(i, panel_end);
+            for (size_t j = column; j < row_end; ++j) {
+                const float *l_j = a + j * matrix_size;
+                float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+                for (size_t p = column; p < j; ++p) {
+                    sum += l_i[p] * l_j[p];
+                }
+                l_i[j] = (l_i[j] - sum) / l_j[j];
+            }
+            if (i < panel_end) {
+                float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+                for (size_t p = column; p < i; ++p) {
+                    sum += l_i[p] * l_i[p];
+                }
+                float diagonal = l_i[i] - sum;
+                if (!(diagonal > 0.0f)) {
+                    return false;
+                }
+                l_i[i] = std::sqrt(diagonal);
+            }
+        }
+        return true;
+    }
+
+    void CholeskySolver::update_block(size_t panel_column, size_t panel_width, size_t column, size_t width) {
+        /**
+         * A[column.., column..column + width) -= L[column.., panel] * L[column..column + width, panel]^T.
+         * В диагональном блоке заодно портится верхний треугольник, но он не используется.
+         */
+        const size_t matrix_size = L_.get_row_count();
+        float *a = L_.get_data();
+        const float *l_panel = a + column * matrix_size + panel_column;
+        matrix_library::BlasBackend::instance().sgemm(
+                matrix_library::BlasTranspose::NO, matrix_library::BlasTranspose::YES,
+                matrix_size - column, width, panel_width,
+                -1.0f, l_panel, matrix_size, l_panel, matrix_size,
+                1.0f, a + column * matrix_size + column, matrix_size);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_CHOLESKYSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_CHOLESKYSOLVER_H
+
+#include <omp.h>
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Прямой метод для симметричных положительно определённых матриц: разложение Холецкого A = L L^T.
+     * @details Вдвое дешевле LU-разложения и не требует перестановок.
+     * @details Устроено так же, как LUSolver: блочное правостороннее разложение, панель - диагональный блок
+     * @details и блок под ним, обновление оставшейся нижней части - sgemm A22 = A22 - L21 * L21^T
+     * @details по блокам столбцов, задачи OMP с зависимостями по блокам столбцов.
+     * @details Используется только нижний треугольник A.
+     */
+    class CholeskySolver {
+    public:
+        /**
+         * @brief Конструктор. Раскладывает матрицу.
+         * @details Бросает std::invalid_argument, если матрица не положительно определена.
+         * @param A Симметричная квадратная матрица.
+         * @param block_size Ширина блока столбцов.
+         */
+        explicit CholeskySolver(const matrix_library::Matrix &A, size_t block_size = 128);
+
+        /**
+         * @brief Решить A X = B по готовому разложению.
+         * @param B Матрица правых частей n x k (или вектор-столбец).
+         * @return Матрица решений n x k.
+         */
+        matrix_library::Matrix solve(const matrix_library::Matrix &B) const;
+
+        /**
+         * @brief Решить СЛАУ: разложить матрицу и решить для всех правых частей.
+         * @param system СЛАУ с симметричной положительно определённой матрицей.
+         * @param block_size Ширина блока столбцов.
+         * @return Решение.
+         */
+        static matrix_library::Matrix solve(const linear_systems_library::LinearSystem &system, size_t block_size = 128);
+
+        /**
+         * @brief Получить множитель разложения.
+         * @return Нижнетреугольная L, над диагональю нули. Неизменяемая ссылка.
+         */
+        const matrix_library::Matrix &get_factor() const;
+
+    private:
+        /**
+         * @brief Разложить панель: диагональный блок [column, column + width) и столбцы L под ним.
+         * @return False, если матрица оказалась не положительно определённой.
+         */
+        bool factorize_panel(size_t column, size_t width);
+
+        /**
+         * @brief Обновить нижнюю часть блока столбцов [column, column + width) после разложения панели.
+         */
+        void update_block(size_t panel_column, size_t panel_width, size_t column, size_t width);
+
+        matrix_library::Matrix L_;
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_CHOLESKYSOLVER_H
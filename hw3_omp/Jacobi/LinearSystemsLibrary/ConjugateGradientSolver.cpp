@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ConjugateGradientSolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+#include "VectorOperations.h"
+
+namespace linear_systems_library {
+
+    SolverResult ConjugateGradientSolver::solve(const linear_systems_library::LinearSystem &system,
+                                                const SolverOptions &options, const Preconditioner *preconditioner) {
+        return solve(system.get_A(), system.get_b(), options, preconditioner);
+    }
+
+    SolverResult ConjugateGradientSolver::solve(const matrix_library::Matrix &A, const matrix_library::Matrix &b,
+                                                const SolverOptions &options, const Preconditioner *preconditioner) {
+        /**
+         * Об алгоритме: https://ru.wikipedia.org/wiki/Метод_сопряжённых_градиентов_(СЛАУ)
+         * Приближение на k-й итерации минимизирует A-норму ошибки на подпространстве Крылова размерности k,
+         * поэтому в точной арифметике метод сходится не более чем за n итераций,
+         * а на практике - за O(sqrt(cond(A))) итераций.
+         */
+        assert(A.get_row_count() == A.get_column_count());
+        assert(b.get_row_count() == A.get_row_count() && b.get_column_count() == 1);
+        const size_t matrix_size = A.get_row_count();
+        auto n = static_cast<double>(matrix_size);
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, b.get_data()));
+
+        matrix_library::Matrix x_vector(matrix_size, 1);
+        matrix_library::Matrix r_vector(matrix_size, 1);
+        matrix_library::Matrix z_vector(matrix_size, 1);
+        matrix_library::Matrix p_vector(matrix_size, 1);
+        matrix_library::Matrix q_vector(matrix_size, 1);
+        float *x = x_vector.get_data();
+        float *r = r_vector.get_data();
+        float *p = p_vector.get_data();
+        float *q = q_vector.get_data();
+        /**
+         * Без предобусловливателя z = r, и отдельный вектор не нужен.
+         */
+        float *z = preconditioner != nullptr ? z_vector.get_data() : r;
+        monitor.finish_setup();
+
+        TRACE_SCOPE("cg_iterations");
+        benchmark_library::PerfRegion iterations_region("cg_iterations");
+        double rr = VectorOperations::residual(A, x, b.get_data(), r);
+        if (preconditioner != nullptr) {
+            preconditioner->apply(r, z);
+        }
+        std::copy(z, z + matrix_size, p);
+        double rz = preconditioner != nullptr ? VectorOperations::dot(matrix_size, r, z) : rr;
+
+        size_t iterations = 0;
+        std::optional<SolverStatus> status;
+        if (monitor.is_residual_small(std::sqrt(rr))) {
+            status = SolverStatus::CONVERGED;
+        }
+        while (!status) {
+            iterations_region.add_flops(2.0 * n * n + 10.0 * n);
+            ++iterations;
+
+            VectorOperations::multiply(A, p, q);
+            const double pq = VectorOperations::dot(matrix_size, p, q);
+            if (!(pq > 0.0 && std::isfinite(pq))) {
+                // (A p, p) <= 0: матрица не положительно определена, шаг не определён
+                status = monitor.fail(std::sqrt(rr), SolverStatus::BREAKDOWN);
+                break;
+            }
+            auto alpha = static_cast<float>(rz / pq);
+            VectorOperations::axpy(matrix_size, alpha, p, x);
+            rr = VectorOperations::axpy_dot(matrix_size, -alpha, q, r);
+
+            double rz_next = rr;
+            if (preconditioner != nullptr) {
+                preconditioner->apply(r, z);
+                rz_next = VectorOperations::dot(matrix_size, r, z);
+            }
+            if (!std::isfinite(rr) || !std::isfinite(rz_next)) {
+                status = monitor.fail(std::sqrt(rr), SolverStatus::DIVERGENCE);
+                break;
+            }
+            VectorOperations::xpay(matrix_size, z, static_cast<float>(rz_next / rz), p);
+            rz = rz_next;
+
+            const double residual_norm = std::sqrt(rr);
+            status = monitor.finish_iteration(iterations, monitor.is_residual_small(residual_norm), false,
+                                              [residual_norm]() { return residual_norm; });
+        }
+        return monitor.make_result(std::move(x_vector), iterations, *status);
+    }
+}
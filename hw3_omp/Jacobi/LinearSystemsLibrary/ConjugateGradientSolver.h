@@ -0,0 +1,46 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_CONJUGATEGRADIENTSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_CONJUGATEGRADIENTSOLVER_H
+
+#include <omp.h>
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Preconditioner.h"
+#include "SolverMonitor.h"
+
+namespace linear_systems_library {
+    class ConjugateGradientSolver {
+    public:
+        /**
+         * @brief Решить СЛАУ с симметричной положительно определённой матрицей методом сопряжённых градиентов.
+         * @details Итерация: одно умножение A на вектор, два скалярных произведения и три обновления векторов,
+         * @details из которых обновление невязки совмещено с её нормой (VectorOperations::axpy_dot).
+         * @details Итерации не выделяют память. Сходимость - ||b - A x|| <= eps * ||b||: норма невязки
+         * @details известна на каждой итерации, лимиты, расходимость и застой отслеживает SolverMonitor.
+         * @details Если (A p, p) <= 0 (матрица не положительно определена), итерации прекращаются со статусом BREAKDOWN,
+         * @details если невязка перестала быть конечной - со статусом DIVERGENCE.
+         * @param system СЛАУ. Матрица должна быть симметричной и положительно определённой.
+         * @param options Точность и условия аварийной остановки.
+         * @param preconditioner Предобусловливатель. Если nullptr, не используется.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve(const linear_systems_library::LinearSystem &system,
+                                  const SolverOptions &options = SolverOptions(),
+                                  const Preconditioner *preconditioner = nullptr);
+
+        /**
+         * @brief Решить A x = b методом сопряжённых градиентов, см. solve(system).
+         * @details Матрица не копируется: так решает системы для поправки RefinementSolver.
+         * @param A Симметричная положительно определённая матрица.
+         * @param b Вектор-столбец свободных членов.
+         * @param options Точность и условия аварийной остановки.
+         * @param preconditioner Предобусловливатель. Если nullptr, не используется.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve(const matrix_library::Matrix &A, const matrix_library::Matrix &b,
+                                  const SolverOptions &options = SolverOptions(),
+                                  const Preconditioner *preconditioner = nullptr);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_CONJUGATEGRADIENTSOLVER_H
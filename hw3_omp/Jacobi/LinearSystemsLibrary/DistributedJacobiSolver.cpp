@@ -0,0 +1,507 @@
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include "DistributedJacobiSolver.h"
+#include "Tracing.h"
+
+namespace linear_systems_library {
+
+    namespace {
+        /**
+         * @brief Размеры и начала блоков строк всех процессов по количеству своих строк (MPI_Allgather).
+         * @param local_rows Количество своих строк.
+         * @param communicator Коммуникатор.
+         * @param counts Сюда записываются количества строк процессов.
+         * @param displacements Сюда записываются номера первых строк процессов.
+         * @return Общее количество строк.
+         */
+        size_t gather_layout(size_t local_rows, MPI_Comm communicator, std::vector<int> &counts,
+                             std::vector<int> &displacements) {
+            int comm_size;
+            MPI_Comm_size(communicator, &comm_size);
+            assert(local_rows <= static_cast<size_t>(INT_MAX));
+            int local_count = static_cast<int>(local_rows);
+            counts.resize(comm_size);
+            displacements.resize(comm_size);
+            MPI_Allgather(&local_count, 1, MPI_INT, counts.data(), 1, MPI_INT, communicator);
+            size_t total = 0;
+            for (int p = 0; p < comm_size; ++p) {
+                assert(total <= static_cast<size_t>(INT_MAX));
+                displacements[p] = static_cast<int>(total);
+                total += static_cast<size_t>(counts[p]);
+            }
+            return total;
+        }
+
+        /**
+         * @brief Отложенная проверка сходимости: нормы итерации и код причины остановки сводятся одним MPI_Iallreduce(MAX).
+         * @details start вызывается на итерациях, кратных steps_per_check, finish - на следующей итерации после неё.
+         * @details Код причины - лимит итераций или времени, замеченный хотя бы одним процессом (SolverStatus + 1, ноль - нет).
+         * @details Остальное решается по сведённым нормам и поэтому одинаково на всех процессах.
+         */
+        class LaggedCheck {
+        public:
+            LaggedCheck(MPI_Comm communicator, SolverMonitor &monitor, float q, float eps) :
+                    communicator_(communicator), monitor_(monitor), q_(q), eps_(eps) {}
+
+            /**
+             * @brief Ждётся ли результат редукции.
+             */
+            bool is_pending() const {
+                return request_ != MPI_REQUEST_NULL;
+            }
+
+            /**
+             * @brief Начать сведение норм итерации.
+             * @param iteration Номер итерации.
+             * @param difference_norm Своя норма разности итераций.
+             * @param residual_norm Своя норма невязки.
+             */
+            void start(size_t iteration, float difference_norm, float residual_norm) {
+                auto limit = monitor_.check_limits(iteration);
+                values_[0] = difference_norm;
+                values_[1] = residual_norm;
+                values_[2] = limit ? static_cast<float>(static_cast<int>(*limit) + 1) : 0.0f;
+                iteration_ = iteration;
+                MPI_Iallreduce(MPI_IN_PLACE, values_, 3, MPI_FLOAT, MPI_MAX, communicator_, &request_);
+            }
+
+            /**
+             * @brief Дождаться редукции и решить, остановиться ли.
+             * @return Причина остановки или std::nullopt, если можно продолжать.
+             */
+            std::optional<SolverStatus> finish() {
+                MPI_Wait(&request_, MPI_STATUS_IGNORE);
+                bool converged = q_ < 1.0f ? values_[0] <= (1 - q_) / q_ * eps_ : monitor_.is_residual_small(values_[1]);
+                if (converged) {
+                    monitor_.check_residual(iteration_, values_[1]);
+                    return SolverStatus::CONVERGED;
+                }
+                if (values_[2] > 0.0f) {
+                    monitor_.check_residual(iteration_, values_[1]);
+                    return static_cast<SolverStatus>(static_cast<int>(values_[2]) - 1);
+                }
+                return monitor_.check_residual(iteration_, values_[1]);
+            }
+
+        private:
+            MPI_Comm communicator_;
+            SolverMonitor &monitor_;
+            float q_;
+            float eps_;
+            float values_[3] = {0.0f, 0.0f, 0.0f};
+            size_t iteration_{0};
+            MPI_Request request_{MPI_REQUEST_NULL};
+        };
+    }
+
+    SolverResult DistributedJacobiSolver::solve(const matrix_library::Matrix &A_rows, const matrix_library::Matrix &b_rows,
+                                                MPI_Comm communicator, const SolverOptions &options) {
+        const size_t steps_per_check = options.steps_per_check;
+        int rank;
+        MPI_Comm_rank(communicator, &rank);
+        const size_t local_rows = A_rows.get_row_count();
+        assert(b_rows.get_row_count() == local_rows && b_rows.get_column_count() == 1);
+        std::vector<int> counts;
+        std::vector<int> displacements;
+        const size_t matrix_size = gather_layout(local_rows, communicator, counts, displacements);
+        assert(A_rows.get_column_count() == matrix_size);
+        const size_t row_begin = static_cast<size_t>(displacements[rank]);
+        const size_t row_end = row_begin + local_rows;
+        const float *a = A_rows.get_data();
+        const float *b = b_rows.get_data();
+
+        /**
+         * Подготовка: q = max_i sum_{j!=i} |A[i][j] / A[i][i]| и ||b||_inf - одним MPI_Allreduce(MAX) на двоих.
+         */
+        std::optional<tracing_library::TraceSpan> setup_span(std::in_place, "jacobi_mpi_setup");
+        float row_norm = 0.0f;
+        float b_norm = 0.0f;
+#pragma omp parallel for schedule(static) default(none) shared(local_rows, matrix_size, row_begin, a, b) \
+        reduction(max:row_norm, b_norm)
+        for (size_t i = 0; i < local_rows; ++i) {
+            const float *row = a + i * matrix_size;
+            float sum = 0.0f;
+            for (size_t j = 0; j < matrix_size; ++j) {
+                sum += std::abs(row[j]);
+            }
+            const float diagonal = std::abs(row[row_begin + i]);
+            row_norm = std::max(row_norm, (sum - diagonal) / diagonal);
+            b_norm = std::max(b_norm, std::abs(b[i]));
+        }
+        float norms[2] = {row_norm, b_norm};
+        MPI_Allreduce(MPI_IN_PLACE, norms, 2, MPI_FLOAT, MPI_MAX, communicator);
+        const float q = norms[0];
+        SolverMonitor monitor(options, matrix_size, norms[1]);
+        LaggedCheck check(communicator, monitor, q, options.eps);
+        setup_span.reset();
+        monitor.finish_setup();
+
+        TRACE_SCOPE("jacobi_mpi_iterations");
+        matrix_library::Matrix x_local(local_rows, 1);
+        std::vector<float> x_next(local_rows, 0.0f);
+        std::vector<float> x_global(matrix_size);
+        std::vector<float> partial_sums(local_rows);
+        float *x = x_local.get_data();
+        std::fill(x, x + local_rows, 0.0f);
+        float *x_all = x_global.data();
+        float *next = x_next.data();
+        float *sums = partial_sums.data();
+        /**
+         * Проверка сходимости отложенная: нормы итерации сводятся неблокирующим MPI_Iallreduce,
+         * пока идёт следующая итерация, и решение принимается после неё (она только уточняет x).
+         */
+        std::optional<SolverStatus> status;
+        size_t iterations = 0;
+        while (!status) {
+            ++iterations;
+            MPI_Request gathering;
+            MPI_Iallgatherv(x, counts[rank], MPI_FLOAT, x_all, counts.data(), displacements.data(), MPI_FLOAT,
+                            communicator, &gathering);
+
+            /**
+             * Пока собирается x, считаем вклад собственных столбцов - для них x уже есть.
+             */
+#pragma omp parallel for schedule(static) default(none) shared(local_rows, matrix_size, row_begin, a, x, sums)
+            for (size_t i = 0; i < local_rows; ++i) {
+                const float *row = a + i * matrix_size + row_begin;
+                float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+                for (size_t j = 0; j < local_rows; ++j) {
+                    sum += row[j] * x[j];
+                }
+                sums[i] = sum;
+            }
+            MPI_Wait(&gathering, MPI_STATUS_IGNORE);
+
+            float difference_norm = 0.0f;
+            float residual_norm = 0.0f;
+#pragma omp parallel for schedule(static) default(none) \
+        shared(local_rows, matrix_size, row_begin, row_end, a, b, x, x_all, next, sums) \
+        reduction(max:difference_norm, residual_norm)
+            for (size_t i = 0; i < local_rows; ++i) {
+                const float *row = a + i * matrix_size;
+                float sum = sums[i];
+#pragma omp simd reduction(+:sum)
+                for (size_t j = 0; j < row_begin; ++j) {
+                    sum += row[j] * x_all[j];
+                }
+#pragma omp simd reduction(+:sum)
+                for (size_t j = row_end; j < matrix_size; ++j) {
+                    sum += row[j] * x_all[j];
+                }
+                float residual = b[i] - sum;
+                float step = residual / row[row_begin + i];
+                next[i] = x[i] + step;
+                difference_norm = std::max(difference_norm, std::abs(step));
+                residual_norm = std::max(residual_norm, std::abs(residual));
+            }
+            std::copy(next, next + local_rows, x);
+
+            if (check.is_pending()) {
+                status = check.finish();
+            }
+            if (!status && iterations % steps_per_check == 0) {
+                check.start(iterations, difference_norm, residual_norm);
+            }
+        }
+
+        return monitor.make_result(std::move(x_local), iterations, *status);
+    }
+
+    SolverResult DistributedJacobiSolver::solve_csr(const SparseMatrix &A_rows, const matrix_library::Matrix &b_rows,
+                                                    MPI_Comm communicator, const SolverOptions &options) {
+        const size_t steps_per_check = options.steps_per_check;
+        int rank;
+        int comm_size;
+        MPI_Comm_rank(communicator, &rank);
+        MPI_Comm_size(communicator, &comm_size);
+        const size_t local_rows = A_rows.get_row_count();
+        assert(b_rows.get_row_count() == local_rows && b_rows.get_column_count() == 1);
+        std::vector<int> counts;
+        std::vector<int> displacements;
+        const size_t matrix_size = gather_layout(local_rows, communicator, counts, displacements);
+        assert(A_rows.get_column_count() == matrix_size);
+        const auto row_begin = static_cast<size_t>(displacements[rank]);
+        const size_t row_end = row_begin + local_rows;
+        const size_t *offsets = A_rows.get_row_offsets().data();
+        const std::vector<uint32_t> &global_columns = A_rows.get_column_indices();
+        const float *values = A_rows.get_values().data();
+        const float *b = b_rows.get_data();
+
+        std::optional<tracing_library::TraceSpan> setup_span(std::in_place, "jacobi_mpi_csr_setup");
+        /**
+         * Призрачные узлы - чужие столбцы, на которые ссылаются свои строки. Они упорядочены по номеру,
+         * поэтому узлы одного владельца лежат подряд. В локальной нумерации свои столбцы - [0, m),
+         * призрачные - m + позиция в списке.
+         */
+        std::vector<uint32_t> ghosts;
+        for (uint32_t column: global_columns) {
+            if (column < row_begin || column >= row_end) {
+                ghosts.push_back(column);
+            }
+        }
+        std::sort(ghosts.begin(), ghosts.end());
+        ghosts.erase(std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+
+        std::vector<uint32_t> local_columns(global_columns.size());
+        for (size_t k = 0; k < global_columns.size(); ++k) {
+            uint32_t column = global_columns[k];
+            if (column >= row_begin && column < row_end) {
+                local_columns[k] = static_cast<uint32_t>(column - row_begin);
+            } else {
+                auto position = std::lower_bound(ghosts.begin(), ghosts.end(), column) - ghosts.begin();
+                local_columns[k] = static_cast<uint32_t>(local_rows + static_cast<size_t>(position));
+            }
+        }
+
+        std::vector<int> receive_counts(comm_size, 0);
+        for (uint32_t ghost: ghosts) {
+            auto owner = std::upper_bound(displacements.begin(), displacements.end(), static_cast<int>(ghost)) -
+                         displacements.begin() - 1;
+            ++receive_counts[owner];
+        }
+        std::vector<int> send_counts(comm_size, 0);
+        MPI_Alltoall(receive_counts.data(), 1, MPI_INT, send_counts.data(), 1, MPI_INT, communicator);
+        std::vector<int> receive_displacements(comm_size, 0);
+        std::vector<int> send_displacements(comm_size, 0);
+        for (int p = 1; p < comm_size; ++p) {
+            receive_displacements[p] = receive_displacements[p - 1] + receive_counts[p - 1];
+            send_displacements[p] = send_displacements[p - 1] + send_counts[p - 1];
+        }
+        std::vector<uint32_t> send_indices(send_displacements.back() + send_counts.back());
+        MPI_Alltoallv(ghosts.data(), receive_counts.data(), receive_displacements.data(), MPI_UINT32_T,
+                      send_indices.data(), send_counts.data(), send_displacements.data(), MPI_UINT32_T, communicator);
+        for (uint32_t &index: send_indices) {
+            index -= static_cast<uint32_t>(row_begin);
+        }
+
+        /**
+         * Внутренние строки ссылаются только на свои столбцы, граничные - хотя бы на один призрачный.
+         * Заодно q = max_i sum_{j!=i} |A[i][j] / A[i][i]| и ||b||_inf - одним MPI_Allreduce(MAX) на двоих.
+         */
+        std::vector<size_t> interior_rows;
+        std::vector<size_t> boundary_rows;
+        std::vector<float> diagonals(local_rows, 0.0f);
+        float row_norm = 0.0f;
+        float b_norm = 0.0f;
+        for (size_t i = 0; i < local_rows; ++i) {
+            bool is_interior = true;
+            float off_diagonal_sum = 0.0f;
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                if (local_columns[k] == i) {
+                    diagonals[i] = values[k];
+                } else {
+                    off_diagonal_sum += std::abs(values[k]);
+                }
+                is_interior = is_interior && local_columns[k] < local_rows;
+            }
+            (is_interior ? interior_rows : boundary_rows).push_back(i);
+            row_norm = std::max(row_norm, off_diagonal_sum / std::abs(diagonals[i]));
+            b_norm = std::max(b_norm, std::abs(b[i]));
+        }
+        float norms[2] = {row_norm, b_norm};
+        MPI_Allreduce(MPI_IN_PLACE, norms, 2, MPI_FLOAT, MPI_MAX, communicator);
+        const float q = norms[0];
+        SolverMonitor monitor(options, matrix_size, norms[1]);
+        LaggedCheck check(communicator, monitor, q, options.eps);
+        setup_span.reset();
+        monitor.finish_setup();
+
+        TRACE_SCOPE("jacobi_mpi_csr_iterations");
+        const size_t extended_size = local_rows + ghosts.size();
+        std::vector<float> x_first(extended_size, 0.0f);
+        std::vector<float> x_second(extended_size, 0.0f);
+        std::vector<float> send_buffer(send_indices.size());
+        std::vector<MPI_Request> requests;
+        requests.reserve(2 * static_cast<size_t>(comm_size));
+        float *x_prev = x_second.data();
+        float *x_current = x_first.data();
+        const uint32_t *columns = local_columns.data();
+        const float *diagonal_values = diagonals.data();
+        std::optional<SolverStatus> status;
+        size_t iterations = 0;
+        while (!status) {
+            ++iterations;
+            std::swap(x_prev, x_current);
+
+            requests.clear();
+            for (int p = 0; p < comm_size; ++p) {
+                if (receive_counts[p] > 0) {
+                    requests.emplace_back();
+                    MPI_Irecv(x_prev + local_rows + receive_displacements[p], receive_counts[p], MPI_FLOAT, p, 0,
+                              communicator, &requests.back());
+                }
+            }
+            for (size_t k = 0; k < send_indices.size(); ++k) {
+                send_buffer[k] = x_prev[send_indices[k]];
+            }
+            for (int p = 0; p < comm_size; ++p) {
+                if (send_counts[p] > 0) {
+                    requests.emplace_back();
+                    MPI_Isend(send_buffer.data() + send_displacements[p], send_counts[p], MPI_FLOAT, p, 0,
+                              communicator, &requests.back());
+                }
+            }
+
+            float difference_norm = 0.0f;
+            float residual_norm = 0.0f;
+            /**
+             * Шаг Якоби по списку строк, как в JacobiSolver::solve_csr.
+             */
+            auto sweep = [&](const std::vector<size_t> &rows) {
+                const size_t *row_indices = rows.data();
+                const size_t rows_count = rows.size();
+                float difference = 0.0f;
+                float residual_max = 0.0f;
+#pragma omp parallel for schedule(static) default(none) \
+        shared(rows_count, row_indices, offsets, columns, values, diagonal_values, b, x_prev, x_current) \
+        reduction(max:difference, residual_max)
+                for (size_t r = 0; r < rows_count; ++r) {
+                    const size_t i = row_indices[r];
+                    float sum = 0.0f;
+                    for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                        sum += values[k] * x_prev[columns[k]];
+                    }
+                    float residual = b[i] - sum;
+                    float step = residual / diagonal_values[i];
+                    x_current[i] = x_prev[i] + step;
+                    difference = std::max(difference, std::abs(step));
+                    residual_max = std::max(residual_max, std::abs(residual));
+                }
+                difference_norm = std::max(difference_norm, difference);
+                residual_norm = std::max(residual_norm, residual_max);
+            };
+            sweep(interior_rows);
+            MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+            sweep(boundary_rows);
+
+            if (check.is_pending()) {
+                status = check.finish();
+            }
+            if (!status && iterations % steps_per_check == 0) {
+                check.start(iterations, difference_norm, residual_norm);
+            }
+        }
+
+        matrix_library::Matrix x(local_rows, 1);
+        std::copy(x_current, x_current + local_rows, x.get_data());
+        return monitor.make_result(std::move(x), iterations, *status);
+    }
+
+    std::pair<size_t, size_t> DistributedJacobiSolver::row_range(size_t size, int rank, int comm_size) {
+        return {size * static_cast<size_t>(rank) / static_cast<size_t>(comm_size),
+                size * static_cast<size_t>(rank + 1) / static_cast<size_t>(comm_size)};
+    }
+
+    matrix_library::Matrix DistributedJacobiSolver::scatter_rows(const matrix_library::Matrix *matrix,
+                                                                 MPI_Comm communicator) {
+        int rank;
+        int comm_size;
+        MPI_Comm_rank(communicator, &rank);
+        MPI_Comm_size(communicator, &comm_size);
+        unsigned long long sizes[2] = {0, 0};
+        if (rank == 0) {
+            sizes[0] = matrix->get_row_count();
+            sizes[1] = matrix->get_column_count();
+        }
+        MPI_Bcast(sizes, 2, MPI_UNSIGNED_LONG_LONG, 0, communicator);
+        const auto row_count = static_cast<size_t>(sizes[0]);
+        const auto column_count = static_cast<size_t>(sizes[1]);
+
+        std::vector<int> counts(comm_size);
+        std::vector<int> displacements(comm_size);
+        for (int p = 0; p < comm_size; ++p) {
+            auto range = row_range(row_count, p, comm_size);
+            assert(range.second * column_count <= static_cast<size_t>(INT_MAX));
+            counts[p] = static_cast<int>((range.second - range.first) * column_count);
+            displacements[p] = static_cast<int>(range.first * column_count);
+        }
+        auto range = row_range(row_count, rank, comm_size);
+        matrix_library::Matrix rows(range.second - range.first, column_count);
+        MPI_Scatterv(rank == 0 ? matrix->get_data() : nullptr, counts.data(), displacements.data(), MPI_FLOAT,
+                     rows.get_data(), counts[rank], MPI_FLOAT, 0, communicator);
+        return rows;
+    }
+
+    SparseMatrix DistributedJacobiSolver::scatter_rows(const SparseMatrix *matrix, MPI_Comm communicator) {
+        int rank;
+        int comm_size;
+        MPI_Comm_rank(communicator, &rank);
+        MPI_Comm_size(communicator, &comm_size);
+        unsigned long long sizes[2] = {0, 0};
+        if (rank == 0) {
+            sizes[0] = matrix->get_row_count();
+            sizes[1] = matrix->get_column_count();
+        }
+        MPI_Bcast(sizes, 2, MPI_UNSIGNED_LONG_LONG, 0, communicator);
+        const auto row_count = static_cast<size_t>(sizes[0]);
+        const auto column_count = static_cast<size_t>(sizes[1]);
+
+        /**
+         * Длины строк раздаются вместо начал строк: области отправки MPI_Scatterv не должны перекрываться.
+         */
+        std::vector<int> row_counts(comm_size);
+        std::vector<int> row_displacements(comm_size);
+        std::vector<int> nonzero_counts(comm_size);
+        std::vector<int> nonzero_displacements(comm_size);
+        std::vector<unsigned long long> row_lengths;
+        if (rank == 0) {
+            const auto &offsets = matrix->get_row_offsets();
+            row_lengths.resize(row_count);
+            for (size_t i = 0; i < row_count; ++i) {
+                row_lengths[i] = offsets[i + 1] - offsets[i];
+            }
+            for (int p = 0; p < comm_size; ++p) {
+                auto range = row_range(row_count, p, comm_size);
+                assert(offsets[range.second] <= static_cast<size_t>(INT_MAX));
+                row_counts[p] = static_cast<int>(range.second - range.first);
+                row_displacements[p] = static_cast<int>(range.first);
+                nonzero_counts[p] = static_cast<int>(offsets[range.second] - offsets[range.first]);
+                nonzero_displacements[p] = static_cast<int>(offsets[range.first]);
+            }
+        }
+        MPI_Bcast(nonzero_counts.data(), comm_size, MPI_INT, 0, communicator);
+
+        auto range = row_range(row_count, rank, comm_size);
+        const size_t local_rows = range.second - range.first;
+        std::vector<unsigned long long> local_lengths(local_rows);
+        MPI_Scatterv(rank == 0 ? row_lengths.data() : nullptr, row_counts.data(), row_displacements.data(),
+                     MPI_UNSIGNED_LONG_LONG, local_lengths.data(), static_cast<int>(local_rows),
+                     MPI_UNSIGNED_LONG_LONG, 0, communicator);
+        std::vector<size_t> row_offsets(local_rows + 1, 0);
+        for (size_t i = 0; i < local_rows; ++i) {
+            row_offsets[i + 1] = row_offsets[i] + static_cast<size_t>(local_lengths[i]);
+        }
+
+        std::vector<uint32_t> column_indices(static_cast<size_t>(nonzero_counts[rank]));
+        std::vector<float> values(static_cast<size_t>(nonzero_counts[rank]));
+        MPI_Scatterv(rank == 0 ? matrix->get_column_indices().data() : nullptr, nonzero_counts.data(),
+                     nonzero_displacements.data(), MPI_UINT32_T, column_indices.data(), nonzero_counts[rank],
+                     MPI_UINT32_T, 0, communicator);
+        MPI_Scatterv(rank == 0 ? matrix->get_values().data() : nullptr, nonzero_counts.data(),
+                     nonzero_displacements.data(), MPI_FLOAT, values.data(), nonzero_counts[rank], MPI_FLOAT, 0,
+                     communicator);
+        return SparseMatrix(local_rows, column_count, std::move(row_offsets), std::move(column_indices),
+                            std::move(values));
+    }
+
+    matrix_library::Matrix DistributedJacobiSolver::gather_rows(const matrix_library::Matrix &rows,
+                                                                MPI_Comm communicator) {
+        const size_t column_count = rows.get_column_count();
+        std::vector<int> counts;
+        std::vector<int> displacements;
+        const size_t row_count = gather_layout(rows.get_row_count() * column_count, communicator, counts,
+                                               displacements) / column_count;
+        matrix_library::Matrix matrix(row_count, column_count);
+        int rank;
+        MPI_Comm_rank(communicator, &rank);
+        MPI_Allgatherv(rows.get_data(), counts[rank], MPI_FLOAT, matrix.get_data(), counts.data(),
+                       displacements.data(), MPI_FLOAT, communicator);
+        return matrix;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_DISTRIBUTEDJACOBISOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_DISTRIBUTEDJACOBISOLVER_H
+
+#include <utility>
+
+#include <mpi.h>
+#include <omp.h>
+
+#include "Matrix.h"
+#include "SolverMonitor.h"
+#include "SparseMatrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Метод Якоби на распределённой памяти (MPI).
+     * @details Матрица делится на блоки строк: каждый процесс хранит свои строки A и b целиком (с глобальными
+     * @details номерами столбцов) и считает соответствующий блок x. Внутри процесса строки делятся между потоками OMP.
+     * @details Сходимость проверяется раз в options.steps_per_check итераций одним MPI_Iallreduce(MAX): по норме разности
+     * @details итераций, если q < 1, иначе по максимуму невязки ||b - A x||_inf <= eps * ||b||_inf. Редукция идёт
+     * @details одновременно со следующей итерацией и ждётся после неё, поэтому итераций на одну больше,
+     * @details чем при блокирующей проверке, зато процессы не простаивают на глобальной синхронизации.
+     * @details Аварийную остановку решает SolverMonitor по сведённым нормам (невязка в нём - по максимуму модуля),
+     * @details поэтому расходимость и застой все процессы видят одинаково. Лимиты итераций и времени каждый процесс
+     * @details проверяет сам и передаёт код причины в той же редукции, и останавливаются все вместе.
+     * @details options.residual_callback вызывается на каждом процессе с одними и теми же значениями
+     * @details и должен везде отвечать одинаково.
+     * @details Разбиение по умолчанию - row_range; решатели принимают и любое другое разбиение на подряд идущие блоки.
+     */
+    class DistributedJacobiSolver {
+    public:
+        /**
+         * @brief Решить СЛАУ с плотной матрицей.
+         * @details Блоки x собираются на всех процессах неблокирующим MPI_Iallgatherv. Пока он идёт,
+         * @details считается вклад диагонального блока A (собственные столбцы процесса), после - остальных столбцов.
+         * @param A_rows Свои строки матрицы коэффициентов, m x n.
+         * @param b_rows Свои свободные члены, m x 1.
+         * @param communicator Коммуникатор, на всех процессах которого вызывается solve.
+         * @param options Точность и условия аварийной остановки, одинаковые на всех процессах.
+         * @return Свой блок решения m x 1, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve(const matrix_library::Matrix &A_rows, const matrix_library::Matrix &b_rows,
+                                  MPI_Comm communicator, const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Решить СЛАУ с разреженной матрицей в формате CSR.
+         * @details Процесс получает только те элементы x, на которые ссылаются его строки (призрачные узлы),
+         * @details и только от их владельцев: у ленточных и сеточных матриц это соседние блоки.
+         * @details Схема обмена строится один раз. На итерации обмен идёт неблокирующими MPI_Isend/MPI_Irecv,
+         * @details а тем временем считаются внутренние строки, которым призрачные узлы не нужны; граничные - после MPI_Waitall.
+         * @param A_rows Свои строки матрицы коэффициентов с глобальными номерами столбцов.
+         * @param b_rows Свои свободные члены, m x 1.
+         * @param communicator Коммуникатор, на всех процессах которого вызывается solve_csr.
+         * @param options Точность и условия аварийной остановки, одинаковые на всех процессах.
+         * @return Свой блок решения m x 1, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve_csr(const SparseMatrix &A_rows, const matrix_library::Matrix &b_rows,
+                                      MPI_Comm communicator, const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Разбиение по умолчанию: блок строк [size * rank / comm_size, size * (rank + 1) / comm_size).
+         * @param size Количество строк.
+         * @param rank Номер процесса.
+         * @param comm_size Количество процессов.
+         * @return Первая строка блока и строка за последней.
+         */
+        static std::pair<size_t, size_t> row_range(size_t size, int rank, int comm_size);
+
+        /**
+         * @brief Раздать блоки строк плотной матрицы с процесса 0 по разбиению row_range.
+         * @param matrix Матрица на процессе 0, на остальных не используется (может быть nullptr).
+         * @param communicator Коммуникатор.
+         * @return Свой блок строк.
+         */
+        static matrix_library::Matrix scatter_rows(const matrix_library::Matrix *matrix, MPI_Comm communicator);
+
+        /**
+         * @brief Раздать блоки строк разреженной матрицы с процесса 0 по разбиению row_range.
+         * @param matrix Матрица на процессе 0, на остальных не используется (может быть nullptr).
+         * @param communicator Коммуникатор.
+         * @return Свой блок строк, номера столбцов глобальные.
+         */
+        static SparseMatrix scatter_rows(const SparseMatrix *matrix, MPI_Comm communicator);
+
+        /**
+         * @brief Собрать блоки строк в одну матрицу на всех процессах (MPI_Allgatherv).
+         * @param rows Свой блок строк.
+         * @param communicator Коммуникатор.
+         * @return Вся матрица.
+         */
+        static matrix_library::Matrix gather_rows(const matrix_library::Matrix &rows, MPI_Comm communicator);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_DISTRIBUTEDJACOBISOLVER_H
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "BlasBackend.h"
+#include "GMRESSolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+#include "VectorOperations.h"
+
+namespace linear_systems_library {
+
+    SolverResult GMRESSolver::solve(const linear_systems_library::LinearSystem &system, const SolverOptions &options,
+                                    size_t restart, const Preconditioner *preconditioner) {
+        /**
+         * Об алгоритме: https://en.wikipedia.org/wiki/Generalized_minimal_residual_method
+         * Приближение минимизирует евклидову норму невязки на подпространстве Крылова.
+         * Процесс Арнольди строит ортонормированный базис V и хессенбергову матрицу H, A V_k = V_{k+1} H_k,
+         * а задача наименьших квадратов min ||beta e_1 - H_k y|| решается вращениями Гивенса по ходу итераций,
+         * так что норма невязки известна на каждом шаге без вычисления x.
+         */
+        const auto &A = system.get_A();
+        assert(A.get_row_count() == A.get_column_count());
+        assert(restart > 0);
+        const size_t matrix_size = A.get_row_count();
+        const auto &backend = matrix_library::BlasBackend::instance();
+        auto n = static_cast<double>(matrix_size);
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, system.get_b().get_data()));
+
+        matrix_library::Matrix x_vector(matrix_size, 1);
+        matrix_library::Matrix w_vector(matrix_size, 1);
+        matrix_library::Matrix z_vector(matrix_size, 1);
+        matrix_library::Matrix V(restart + 1, matrix_size);
+        float *x = x_vector.get_data();
+        float *w = w_vector.get_data();
+        float *z_buffer = z_vector.get_data();
+
+        std::vector<double> H((restart + 1) * restart, 0.0);  // хессенбергова матрица по строкам
+        std::vector<double> cosines(restart, 0.0);
+        std::vector<double> sines(restart, 0.0);
+        std::vector<double> g(restart + 1, 0.0);  // правая часть задачи наименьших квадратов
+        std::vector<float> h(restart + 1, 0.0f);  // коэффициенты ортогонализации
+        std::vector<float> y(restart, 0.0f);
+        monitor.finish_setup();
+
+        TRACE_SCOPE("gmres_iterations");
+        benchmark_library::PerfRegion iterations_region("gmres_iterations");
+        size_t iterations = 0;
+        std::optional<SolverStatus> status;
+        while (!status) {
+            float *v_first = &V.get_element(0, 0);
+            double beta = std::sqrt(VectorOperations::residual(A, x, system.get_b().get_data(), v_first));
+            if (monitor.is_residual_small(beta)) {
+                status = SolverStatus::CONVERGED;
+                break;
+            }
+            VectorOperations::waxpby(matrix_size, static_cast<float>(1.0 / beta), v_first, 0.0f, v_first, v_first);
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = beta;
+
+            size_t basis_size = 0;
+            while (basis_size < restart && !status) {
+                const size_t j = basis_size;
+                iterations_region.add_flops(2.0 * n * n + 8.0 * n * static_cast<double>(j + 1) + 4.0 * n);
+                ++iterations;
+
+                float *v_j = &V.get_element(j, 0);
+                float *z = v_j;
+                if (preconditioner != nullptr) {
+                    preconditioner->apply(v_j, z_buffer);
+                    z = z_buffer;
+                }
+                VectorOperations::multiply(A, z, w);
+
+                /**
+                 * CGS2: h = V w, w = w - V^T h, и ещё раз для восстановления ортогональности в float.
+                 */
+                for (size_t i = 0; i <= j; ++i) {
+                    H[i * restart + j] = 0.0;
+                }
+                for (size_t pass = 0; pass < 2; ++pass) {
+                    backend.sgemv(matrix_library::BlasTranspose::NO, j + 1, matrix_size,
+                                  1.0f, V.get_data(), matrix_size, w, 0.0f, h.data());
+                    backend.sgemv(matrix_library::BlasTranspose::YES, j + 1, matrix_size,
+                                  -1.0f, V.get_data(), matrix_size, h.data(), 1.0f, w);
+                    for (size_t i = 0; i <= j; ++i) {
+                        H[i * restart + j] += h[i];
+                    }
+                }
+                double w_norm = VectorOperations::norm2(matrix_size, w);
+                if (!std::isfinite(w_norm)) {
+                    // столбец j в решение не входит, приближение строится по предыдущим
+                    status = monitor.fail(std::abs(g[j]), SolverStatus::DIVERGENCE);
+                    break;
+                }
+                H[(j + 1) * restart + j] = w_norm;
+                if (w_norm > 0.0) {
+                    VectorOperations::waxpby(matrix_size, static_cast<float>(1.0 / w_norm), w, 0.0f, w,
+                                             &V.get_element(j + 1, 0));
+                }
+
+                /**
+                 * Применяем к новому столбцу H накопленные вращения и строим вращение, зануляющее H[j+1][j].
+                 */
+                for (size_t i = 0; i < j; ++i) {
+                    double upper = H[i * restart + j];
+                    double lower = H[(i + 1) * restart + j];
+                    H[i * restart + j] = cosines[i] * upper + sines[i] * lower;
+                    H[(i + 1) * restart + j] = -sines[i] * upper + cosines[i] * lower;
+                }
+                double diagonal = H[j * restart + j];
+                double below = H[(j + 1) * restart + j];
+                double radius = std::hypot(diagonal, below);
+                if (!(radius > 0.0 && std::isfinite(radius))) {
+                    // H вырождена: решение задачи наименьших квадратов не определено
+                    status = monitor.fail(std::abs(g[j]), SolverStatus::BREAKDOWN);
+                    break;
+                }
+                cosines[j] = diagonal / radius;
+                sines[j] = below / radius;
+                H[j * restart + j] = radius;
+                H[(j + 1) * restart + j] = 0.0;
+                g[j + 1] = -sines[j] * g[j];
+                g[j] = cosines[j] * g[j];
+
+                ++basis_size;
+                /**
+                 * |g[j+1]| - норма невязки после j-й итерации. w = 0 - удачное вырождение: решение уже в подпространстве.
+                 */
+                const double residual_norm = std::abs(g[j + 1]);
+                status = monitor.finish_iteration(iterations, monitor.is_residual_small(residual_norm) || w_norm == 0.0,
+                                                  false, [residual_norm]() { return residual_norm; });
+            }
+
+            if (basis_size == 0) {
+                break;
+            }
+            /**
+             * Обратный ход по верхнетреугольной H, затем x = x + M^-1 V^T y.
+             */
+            for (size_t i = basis_size; i-- > 0;) {
+                double sum = g[i];
+                for (size_t k = i + 1; k < basis_size; ++k) {
+                    sum -= H[i * restart + k] * y[k];
+                }
+                y[i] = static_cast<float>(sum / H[i * restart + i]);
+            }
+            backend.sgemv(matrix_library::BlasTranspose::YES, basis_size, matrix_size,
+                          1.0f, V.get_data(), matrix_size, y.data(), 0.0f, w);
+            if (preconditioner != nullptr) {
+                preconditioner->apply(w, z_buffer);
+                VectorOperations::axpy(matrix_size, 1.0f, z_buffer, x);
+            } else {
+                VectorOperations::axpy(matrix_size, 1.0f, w, x);
+            }
+        }
+
+        return monitor.make_result(std::move(x_vector), iterations, *status);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_GMRESSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_GMRESSOLVER_H
+
+#include <omp.h>
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Preconditioner.h"
+#include "SolverMonitor.h"
+
+namespace linear_systems_library {
+    class GMRESSolver {
+    public:
+        /**
+         * @brief Решить СЛАУ с произвольной невырожденной матрицей методом GMRES с перезапусками, GMRES(m).
+         * @details Базис подпространства Крылова хранится строками матрицы (m + 1) x n, поэтому ортогонализация
+         * @details очередного вектора ко всем предыдущим - два вызова sgemv (классический Грам-Шмидт, повторённый дважды,
+         * @details CGS2) вместо j отдельных скалярных произведений модифицированного Грама-Шмидта.
+         * @details Предобусловливание правое. Вся память выделяется до итераций.
+         * @details Сходимость - ||b - A x|| <= eps * ||b||: норма невязки известна на каждой итерации Арнольди
+         * @details из вращений Гивенса, лимиты, расходимость и застой отслеживает SolverMonitor.
+         * @details При любой остановке приближение достраивается по уже построенному базису.
+         * @details Если хессенбергова матрица вырождена, итерации прекращаются со статусом BREAKDOWN,
+         * @details если вектор Арнольди перестал быть конечным - со статусом DIVERGENCE.
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @param restart Размерность подпространства Крылова до перезапуска (m).
+         * @param preconditioner Предобусловливатель. Если nullptr, не используется.
+         * @return Приближение, причина остановки, общее количество итераций Арнольди, невязка и время по фазам.
+         */
+        static SolverResult solve(const linear_systems_library::LinearSystem &system,
+                                  const SolverOptions &options = SolverOptions(), size_t restart = 30,
+                                  const Preconditioner *preconditioner = nullptr);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_GMRESSOLVER_H
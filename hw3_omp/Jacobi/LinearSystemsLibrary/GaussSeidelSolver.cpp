@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+
+#include "GaussSeidelSolver.h"
+#include "JacobiSolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+#include "VectorOperations.h"
+
+namespace linear_systems_library {
+
+    SolverResult GaussSeidelSolver::solve(const linear_systems_library::LinearSystem &system, const SolverOptions &options,
+                                          Ordering ordering) {
+        /**
+         * Об алгоритме: https://ru.wikipedia.org/wiki/Метод_Гаусса_—_Зейделя_решения_системы_линейных_уравнений
+         * В отличие от метода Якоби, новая компонента приближения сразу используется при вычислении следующих.
+         */
+        return iterate(system, options, 1.0f, ordering, "gauss_seidel_iterations");
+    }
+
+    std::vector<std::vector<size_t>> GaussSeidelSolver::colour(const matrix_library::Matrix &A, Ordering ordering) {
+        assert(A.get_row_count() == A.get_column_count());
+        const size_t matrix_size = A.get_row_count();
+
+        if (ordering == Ordering::RED_BLACK) {
+            std::vector<std::vector<size_t>> colours(2);
+            for (size_t i = 0; i < matrix_size; ++i) {
+                colours[i % 2].push_back(i);
+            }
+            return colours;
+        }
+
+        /**
+         * Жадная раскраска: строке достаётся наименьший цвет, которого нет у уже раскрашенных соседей.
+         * Соседи - строки j < i, для которых A[i][j] или A[j][i] не ноль.
+         */
+        std::vector<size_t> row_colours(matrix_size, 0);
+        std::vector<size_t> used_by(matrix_size, matrix_size);
+        size_t colours_count = 0;
+        for (size_t i = 0; i < matrix_size; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (A.get_element(i, j) != 0.0f || A.get_element(j, i) != 0.0f) {
+                    used_by[row_colours[j]] = i;
+                }
+            }
+            size_t row_colour = 0;
+            while (used_by[row_colour] == i) {
+                ++row_colour;
+            }
+            row_colours[i] = row_colour;
+            colours_count = std::max(colours_count, row_colour + 1);
+        }
+
+        std::vector<std::vector<size_t>> colours(colours_count);
+        for (size_t i = 0; i < matrix_size; ++i) {
+            colours[row_colours[i]].push_back(i);
+        }
+        return colours;
+    }
+
+    SolverResult GaussSeidelSolver::iterate(const linear_systems_library::LinearSystem &system, const SolverOptions &options,
+                                            float relaxation_factor, Ordering ordering, const char *region_name) {
+        const auto &A = system.get_A();
+        const auto &b = system.get_b();
+        assert(A.get_row_count() == A.get_column_count());
+        assert(relaxation_factor > 0.0f && relaxation_factor < 2.0f);
+        const size_t matrix_size = A.get_row_count();
+        auto n = static_cast<double>(matrix_size);
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, b.get_data()));
+
+        const auto colours = colour(A, ordering);
+        const float q = JacobiSolver::iteration_norm(A);
+        monitor.finish_setup();
+
+        TRACE_SCOPE(region_name);
+        benchmark_library::PerfRegion iterations_region(region_name);
+        /**
+         * Приближение обновляется на месте. Новые значения цвета сначала пишутся в отдельный буфер,
+         * а в приближение переносятся после того, как все строки цвета посчитаны:
+         * так строки одного цвета читают только старые значения друг друга и не гоняются за данными.
+         */
+        matrix_library::Matrix x_current(matrix_size, 1);
+        matrix_library::Matrix x_next(matrix_size, 1);
+        float *x = x_current.get_data();
+        float *x_colour = x_next.get_data();
+        size_t iterations = 0;
+        std::optional<SolverStatus> status;
+        while (!status) {
+            iterations_region.add_flops(2.0 * n * n + 6.0 * n);
+            ++iterations;
+
+            float difference_norm = 0.0f;
+            double residual_norm = 0.0;
+#pragma omp parallel default(none) \
+        shared(A, b, x, x_colour, colours, matrix_size, relaxation_factor) \
+        reduction(max:difference_norm) reduction(+:residual_norm)
+            for (const auto &rows: colours) {
+                const size_t rows_count = rows.size();
+#pragma omp for schedule(static)
+                for (size_t r = 0; r < rows_count; ++r) {
+                    const size_t i = rows[r];
+                    const float *a_row = &A.get_element(i, 0);
+                    float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+                    for (size_t j = 0; j < matrix_size; ++j) {
+                        sum += a_row[j] * x[j];
+                    }
+                    float residual = b.get_element(i, 0) - sum;
+                    float step = relaxation_factor * residual / a_row[i];
+                    x_colour[i] = x[i] + step;
+                    difference_norm = std::max(difference_norm, std::abs(step));
+                    residual_norm += static_cast<double>(residual) * residual;
+                }
+#pragma omp for schedule(static)
+                for (size_t r = 0; r < rows_count; ++r) {
+                    x[rows[r]] = x_colour[rows[r]];
+                }
+            }
+            residual_norm = std::sqrt(residual_norm);
+            bool converged = q < 1.0f ? difference_norm <= (1 - q) / q * options.eps
+                                      : monitor.is_residual_small(residual_norm);
+            status = monitor.finish_iteration(iterations, converged, false, [&]() { return residual_norm; });
+        }
+
+        return monitor.make_result(std::move(x_current), iterations, *status);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_GAUSSSEIDELSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_GAUSSSEIDELSOLVER_H
+
+#include <vector>
+
+#include <omp.h>
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "SolverMonitor.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Порядок обхода неизвестных в методе Гаусса-Зейделя.
+     * @details Неизвестные разбиваются на цвета. Внутри цвета компоненты обновляются параллельно
+     * @details по значениям с прошлого шага, а цвета обходятся последовательно,
+     * @details и каждый следующий цвет уже видит новые значения предыдущих.
+     */
+    enum class Ordering {
+        /**
+         * Два цвета по чётности индекса. Для трёхдиагональных и 5-точечных разностных матриц
+         * совпадает с классическим методом Гаусса-Зейделя, для плотных матриц это блочный вариант:
+         * связи внутри цвета берутся с прошлого шага. При диагональном преобладании тоже сходится.
+         */
+        RED_BLACK,
+        /**
+         * Жадная раскраска графа ненулевых элементов A: строки одного цвета не связаны между собой,
+         * поэтому результат совпадает с последовательным методом Гаусса-Зейделя в порядке цветов.
+         * Для плотной матрицы каждый цвет - одна строка, и параллелизма нет.
+         */
+        GRAPH_COLOURING
+    };
+
+    class GaussSeidelSolver {
+    public:
+        /**
+         * @brief Решить СЛАУ методом Гаусса-Зейделя. Используется OMP.
+         * @details Критерий остановки такой же, как у метода Якоби: ||x_k - x_{k-1}|| <= (1 - q) / q * eps,
+         * @details где q - норма матрицы перехода метода Якоби. При диагональном преобладании
+         * @details матрица перехода метода Гаусса-Зейделя по норме не больше q, поэтому оценка верна и здесь.
+         * @details Если q >= 1, итерации идут до ||b - A x|| <= eps * ||b||. Невязка оценивается по шагам строк
+         * @details в момент их обновления, а расходимость, застой и лимиты отслеживает SolverMonitor.
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @param ordering Порядок обхода неизвестных.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve(const linear_systems_library::LinearSystem &system,
+                                  const SolverOptions &options = SolverOptions(), Ordering ordering = Ordering::RED_BLACK);
+
+        /**
+         * @brief Разбить неизвестные на цвета.
+         * @param A Матрица коэффициентов.
+         * @param ordering Порядок обхода.
+         * @return Списки индексов неизвестных по цветам в порядке обхода.
+         */
+        static std::vector<std::vector<size_t>> colour(const matrix_library::Matrix &A, Ordering ordering);
+
+    private:
+        friend class SORSolver;
+
+        /**
+         * @brief Итерации метода верхней релаксации. При relaxation_factor = 1 это метод Гаусса-Зейделя.
+         * @details x_new[i] = x[i] + relaxation_factor * (b[i] - sum_j A[i][j] * x[j]) / A[i][i].
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @param relaxation_factor Параметр релаксации из (0, 2).
+         * @param ordering Порядок обхода неизвестных.
+         * @param region_name Имя участка для трассы и аппаратных счётчиков.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult iterate(const linear_systems_library::LinearSystem &system, const SolverOptions &options,
+                                    float relaxation_factor, Ordering ordering, const char *region_name);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_GAUSSSEIDELSOLVER_H
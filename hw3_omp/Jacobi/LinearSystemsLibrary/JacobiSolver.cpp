@@ -1,15 +1,142 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "JacobiSolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+#include "VectorOperations.h"
 
 namespace linear_systems_library {
 
-    matrix_library::Matrix JacobiSolver::solve(const linear_systems_library::LinearSystem &system, float eps) {
+    namespace {
+
+        /**
+         * @brief Частичные нормы одного потока. Выровнены по кэш-линии, чтобы потоки не писали в одну строку кэша.
+         */
+        struct alignas(64) ThreadNorms {
+            float difference = 0.0f;
+            float row_norm = 0.0f;
+            double residual = 0.0;
+        };
+
+        /**
+         * @brief Итерации метода Якоби по строкам в одной параллельной области с отложенной проверкой сходимости.
+         * @details Потоки не расходятся между итерациями, единственная синхронизация на итерации - барьер после прохода,
+         * @details без которого следующий проход прочитал бы недосчитанный x. Редукций нет: на итерациях,
+         * @details кратных steps_per_check, каждый поток пишет свои частичные нормы в свою ячейку, а сводит их
+         * @details и решает, остановиться ли, поток 0 в начале следующей итерации, пока остальные уже считают свои строки.
+         * @details Решение видно всем после барьера этой следующей итерации, поэтому итераций на одну больше,
+         * @details чем при немедленной проверке; лишняя итерация только уточняет x.
+         * @details Ячейки норм двойные (по чётности проверки), флаги остановки - по чётности итерации,
+         * @details чтобы поток 0 не писал туда, откуда другие ещё читают.
+         * @tparam RowStep void(size_t i, const float *x_prev, float *x_current, bool is_first_iteration, ThreadNorms &norms):
+         * @tparam RowStep считает x_current[i], копит в norms max |шаг|, сумму квадратов невязки и (на первой итерации)
+         * @tparam RowStep норму строки матрицы перехода.
+         * @param matrix_size Размер системы.
+         * @param options Точность и условия аварийной остановки.
+         * @param monitor Монитор, подготовка уже закончена.
+         * @param row_step Шаг для одной строки.
+         * @return Результат метода.
+         */
+        template<typename RowStep>
+        SolverResult iterate_rows(size_t matrix_size, const SolverOptions &options, SolverMonitor &monitor,
+                                  RowStep row_step) {
+            matrix_library::Matrix x_first(matrix_size, 1);
+            matrix_library::Matrix x_second(matrix_size, 1);
+            float *first = x_first.get_data();
+            float *second = x_second.get_data();
+            std::fill(first, first + matrix_size, 0.0f);
+            std::fill(second, second + matrix_size, 0.0f);
+            const size_t steps_per_check = options.steps_per_check;
+            const float eps = options.eps;
+            const auto threads_count = static_cast<size_t>(omp_get_max_threads());
+            /**
+             * Два набора ячеек для проверок и третий - для норм строк с первой итерации.
+             */
+            std::vector<ThreadNorms> thread_norms(3 * threads_count);
+            ThreadNorms *norms = thread_norms.data();
+            bool stop[2] = {false, false};
+            float q = 0.0f;
+            size_t iterations = 0;
+            SolverStatus status = SolverStatus::CONVERGED;
+            float *result = first;
+#pragma omp parallel default(none) \
+        shared(matrix_size, steps_per_check, eps, threads_count, norms, stop, q, iterations, status, result, \
+               first, second, monitor, row_step)
+            {
+                const auto thread = static_cast<size_t>(omp_get_thread_num());
+                float *x_prev = second;
+                float *x_current = first;
+                size_t iteration = 0;
+                while (true) {
+                    ++iteration;
+                    std::swap(x_prev, x_current);
+                    if (thread == 0 && iteration == 2) {
+                        const ThreadNorms *first_norms = norms + 2 * threads_count;
+                        for (size_t t = 0; t < threads_count; ++t) {
+                            q = std::max(q, first_norms[t].row_norm);
+                        }
+                    }
+                    if (thread == 0 && iteration > 1 && (iteration - 1) % steps_per_check == 0) {
+                        TRACE_SCOPE("jacobi_convergence_check");
+                        const ThreadNorms *checked = norms + ((iteration - 1) / steps_per_check % 2) * threads_count;
+                        float difference_norm = 0.0f;
+                        double residual_norm = 0.0;
+                        for (size_t t = 0; t < threads_count; ++t) {
+                            difference_norm = std::max(difference_norm, checked[t].difference);
+                            residual_norm += checked[t].residual;
+                        }
+                        residual_norm = std::sqrt(residual_norm);
+                        bool converged = q < 1.0f ? difference_norm <= (1 - q) / q * eps
+                                                  : monitor.is_residual_small(residual_norm);
+                        auto finished = monitor.finish_iteration(iteration - 1, converged, false,
+                                                                 [&]() { return residual_norm; });
+                        if (finished) {
+                            status = *finished;
+                            stop[iteration % 2] = true;
+                        }
+                    }
+
+                    const bool is_first_iteration = iteration == 1;
+                    ThreadNorms local;
+#pragma omp for schedule(static) nowait
+                    for (size_t i = 0; i < matrix_size; ++i) {
+                        row_step(i, x_prev, x_current, is_first_iteration, local);
+                    }
+                    if (iteration % steps_per_check == 0) {
+                        norms[(iteration / steps_per_check % 2) * threads_count + thread] = local;
+                    }
+                    if (is_first_iteration) {
+                        norms[2 * threads_count + thread].row_norm = local.row_norm;
+                    }
+#pragma omp barrier
+                    if (stop[iteration % 2]) {
+                        if (thread == 0) {
+                            iterations = iteration;
+                            result = x_current;
+                        }
+                        break;
+                    }
+                }
+            }
+
+            return monitor.make_result(std::move(result == first ? x_first : x_second), iterations, status);
+        }
+    }
+
+    SolverResult JacobiSolver::solve(const linear_systems_library::LinearSystem &system, const SolverOptions &options) {
         /**
          * Об алгоритме: https://ru.wikipedia.org/wiki/Метод_Якоби
          * Метод Якоби — разновидность метода простой итерации для решения системы линейных алгебраических уравнений.
          */
         assert(system.get_A().get_row_count() == system.get_A().get_column_count());
         auto matrix_size = system.get_A().get_row_count();
+        auto n = static_cast<double>(matrix_size);
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, system.get_b().get_data()));
 
+        std::optional<tracing_library::TraceSpan> setup_span(std::in_place, "jacobi_setup");
+        std::optional<benchmark_library::PerfRegion> setup_region(std::in_place, "jacobi_setup", 2.0 * n * n * n + 3.0 * n * n);
         matrix_library::Matrix D_inv(matrix_size, matrix_size);
         for (size_t i = 0; i < matrix_size; ++i) {
             D_inv.get_element(i, i) = 1.0f / system.get_A().get_element(i, i);
@@ -24,20 +151,48 @@ namespace linear_systems_library {
 
         matrix_library::Matrix B = E - matrix_library::MatrixMultiplier::multiplication_cblas(D_inv, system.get_A());
 
+        /**
+         * При q >= 1 сходимость не гарантирована: итерации идут до малой невязки, а расходимость ловит монитор.
+         */
         float q = matrix_norm_inf(B);
-        assert(q < 1.0f);
+        setup_region.reset();
+        setup_span.reset();
+        monitor.finish_setup();
 
+        TRACE_SCOPE("jacobi_iterations");
+        benchmark_library::PerfRegion iterations_region("jacobi_iterations");
         matrix_library::Matrix x_prev(matrix_size, 1);
         matrix_library::Matrix x_current(matrix_size, 1);
-        do {
-            x_prev = x_current;
-            x_current = matrix_library::MatrixMultiplier::multiplication_cblas(B, x_prev) + g;
-        } while (matrix_norm_inf(x_current - x_prev) > (1 - q) / q * eps);
+        size_t iterations = 0;
+        std::optional<SolverStatus> status;
+        while (!status) {
+            ++iterations;
+            iterations_region.add_flops(2.0 * n * n + 3.0 * n);
+            {
+                TRACE_SCOPE("jacobi_update");
+                x_prev = x_current;
+                x_current = matrix_library::MatrixMultiplier::multiplication_cblas(B, x_prev) + g;
+            }
+            if (iterations % options.steps_per_check != 0) {
+                continue;
+            }
+            TRACE_SCOPE("jacobi_convergence_check");
+            bool converged = q < 1.0f && matrix_norm_inf(x_current - x_prev) <= (1 - q) / q * options.eps;
+            status = monitor.finish_iteration(iterations, converged, q >= 1.0f, [&]() {
+                double residual_norm = 0.0;
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    double residual = static_cast<double>(system.get_A().get_element(i, i)) *
+                                      (x_current.get_element(i, 0) - x_prev.get_element(i, 0));
+                    residual_norm += residual * residual;
+                }
+                return std::sqrt(residual_norm);
+            });
+        }
 
-        return x_current;
+        return monitor.make_result(std::move(x_current), iterations, *status);
     }
 
-    matrix_library::Matrix JacobiSolver::solve_omp(const linear_systems_library::LinearSystem &system, float eps) {
+    SolverResult JacobiSolver::solve_omp(const linear_systems_library::LinearSystem &system, const SolverOptions &options) {
         /**
          * Об алгоритме: https://ru.wikipedia.org/wiki/Метод_Якоби
          * Метод Якоби — разновидность метода простой итерации для решения системы линейных алгебраических уравнений.
@@ -47,10 +202,18 @@ namespace linear_systems_library {
         assert(system.get_A().get_row_count() == system.get_A().get_column_count());
         auto matrix_size = system.get_A().get_row_count();
 
+        auto n = static_cast<double>(matrix_size);
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, system.get_b().get_data()));
+
+        std::optional<tracing_library::TraceSpan> setup_span(std::in_place, "jacobi_omp_setup");
+        std::optional<benchmark_library::PerfRegion> setup_region(std::in_place, "jacobi_omp_setup", 2.0 * n * n * n + 3.0 * n * n);
         matrix_library::Matrix D_inv(matrix_size, matrix_size);
-#pragma omp parallel for default(none) shared(D_inv, system, matrix_size)
+        std::vector<float> diagonal(matrix_size);
+        float *diagonal_data = diagonal.data();
+#pragma omp parallel for default(none) shared(D_inv, system, matrix_size, diagonal_data)
         for (size_t i = 0; i < matrix_size; ++i) {
-            D_inv.get_element(i, i) = 1.0f / system.get_A().get_element(i, i);
+            diagonal_data[i] = system.get_A().get_element(i, i);
+            D_inv.get_element(i, i) = 1.0f / diagonal_data[i];
         }
 
         matrix_library::Matrix g = matrix_library::MatrixMultiplier::multiplication_cblas(D_inv, system.get_b());
@@ -64,16 +227,339 @@ namespace linear_systems_library {
         matrix_library::Matrix B = matrix_subtraction_omp(E, matrix_library::MatrixMultiplier::multiplication_cblas(D_inv, system.get_A()));
 
         float q = matrix_norm_inf_omp(B);
-        assert(q < 1.0f);
+        setup_region.reset();
+        setup_span.reset();
+        monitor.finish_setup();
 
-        matrix_library::Matrix x_prev(matrix_size, 1);
-        matrix_library::Matrix x_current(matrix_size, 1);
-        do {
-            x_prev = x_current;
-            x_current = matrix_addition_omp(matrix_library::MatrixMultiplier::multiplication_cblas(B, x_prev), g);
-        } while (matrix_norm_inf_omp(matrix_subtraction_omp(x_current, x_prev)) > (1 - q) / q * eps);
+        TRACE_SCOPE("jacobi_omp_iterations");
+        benchmark_library::PerfRegion iterations_region("jacobi_omp_iterations");
+        /**
+         * Два заранее выделенных вектора меняются ролями на каждой итерации (ping-pong),
+         * поэтому в установившемся режиме итерации не выделяют память и ничего не копируют.
+         */
+        matrix_library::Matrix x_first(matrix_size, 1);
+        matrix_library::Matrix x_second(matrix_size, 1);
+        float *x_prev = x_second.get_data();
+        float *x_current = x_first.get_data();
+        const float *g_data = g.get_data();
+        const auto &backend = matrix_library::BlasBackend::instance();
+        const size_t steps_per_check = options.steps_per_check;
+        size_t iterations = 0;
+        std::optional<SolverStatus> status;
+        while (!status) {
+            ++iterations;
+            iterations_region.add_flops(2.0 * n * n + 6.0 * n);
+            std::swap(x_prev, x_current);
+            {
+                TRACE_SCOPE("jacobi_omp_update");
+                backend.sgemv(matrix_library::BlasTranspose::NO, matrix_size, matrix_size,
+                              1.0f, B.get_data(), matrix_size, x_prev, 0.0f, x_current);
+            }
+            if (iterations % steps_per_check != 0) {
+#pragma omp parallel for simd schedule(static) default(none) shared(matrix_size, x_current, g_data)
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    x_current[i] += g_data[i];
+                }
+                continue;
+            }
+            TRACE_SCOPE("jacobi_omp_convergence_check");
+            /**
+             * Прибавление g, норма разности приближений и невязка D (x_new - x) в одном проходе по векторам.
+             */
+            float difference_norm = 0.0f;
+            double residual_norm = 0.0;
+#pragma omp parallel for simd schedule(static) default(none) \
+        shared(matrix_size, x_prev, x_current, g_data, diagonal_data) \
+        reduction(max:difference_norm) reduction(+:residual_norm)
+            for (size_t i = 0; i < matrix_size; ++i) {
+                float x_new = x_current[i] + g_data[i];
+                x_current[i] = x_new;
+                float step = x_new - x_prev[i];
+                difference_norm = std::max(difference_norm, std::abs(step));
+                double residual = static_cast<double>(diagonal_data[i]) * step;
+                residual_norm += residual * residual;
+            }
+            residual_norm = std::sqrt(residual_norm);
+            bool converged = q < 1.0f ? difference_norm <= (1 - q) / q * options.eps
+                                      : monitor.is_residual_small(residual_norm);
+            status = monitor.finish_iteration(iterations, converged, false, [&]() { return residual_norm; });
+        }
+
+        if (x_current == x_first.get_data()) {
+            return monitor.make_result(std::move(x_first), iterations, *status);
+        }
+        return monitor.make_result(std::move(x_second), iterations, *status);
+    }
+
+    SolverResult JacobiSolver::solve_matrix_free(const linear_systems_library::LinearSystem &system,
+                                                 const SolverOptions &options) {
+        return solve_matrix_free(system.get_A(), system.get_b(), options);
+    }
+
+    SolverResult JacobiSolver::solve_matrix_free(const matrix_library::Matrix &A, const matrix_library::Matrix &b,
+                                                 const SolverOptions &options) {
+        assert(b.get_row_count() == A.get_row_count() && b.get_column_count() == 1);
+        assert(A.get_row_count() == A.get_column_count());
+        const size_t matrix_size = A.get_row_count();
+        auto n = static_cast<double>(matrix_size);
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, b.get_data()));
+        monitor.finish_setup();
+
+        TRACE_SCOPE("jacobi_matrix_free_iterations");
+        benchmark_library::PerfRegion iterations_region("jacobi_matrix_free_iterations");
+        /**
+         * Одна строка A - одна компонента нового приближения, строки независимы.
+         * Разность приближений, невязка и (на первой итерации) норма строки B считаются в том же проходе.
+         */
+        auto result = iterate_rows(matrix_size, options, monitor, [&A, &b, matrix_size](
+                size_t i, const float *x, float *x_new_data, bool is_first_iteration, ThreadNorms &norms) {
+            const float *a_row = &A.get_element(i, 0);
+            float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+            for (size_t j = 0; j < matrix_size; ++j) {
+                sum += a_row[j] * x[j];
+            }
+            float diagonal = a_row[i];
+            float residual = b.get_element(i, 0) - sum;
+            float x_new = x[i] + residual / diagonal;
+            x_new_data[i] = x_new;
+            norms.difference = std::max(norms.difference, std::abs(x_new - x[i]));
+            norms.residual += static_cast<double>(residual) * residual;
 
-        return x_current;
+            if (is_first_iteration) {
+                float off_diagonal_sum = 0.0f;
+#pragma omp simd reduction(+:off_diagonal_sum)
+                for (size_t j = 0; j < matrix_size; ++j) {
+                    off_diagonal_sum += std::abs(a_row[j]);
+                }
+                norms.row_norm = std::max(norms.row_norm, (off_diagonal_sum - std::abs(diagonal)) / std::abs(diagonal));
+            }
+        });
+        iterations_region.add_flops(static_cast<double>(result.iterations) * (2.0 * n * n + 6.0 * n));
+        return result;
+    }
+
+    SolverResult JacobiSolver::solve_csr(const linear_systems_library::SparseLinearSystem &system,
+                                         const SolverOptions &options) {
+        const auto &A = system.get_A();
+        assert(A.get_row_count() == A.get_column_count());
+        const size_t matrix_size = A.get_row_count();
+        const size_t *offsets = A.get_row_offsets().data();
+        const uint32_t *columns = A.get_column_indices().data();
+        const float *values = A.get_values().data();
+        const float *b = system.get_b().get_data();
+        auto n = static_cast<double>(matrix_size);
+        auto nonzero_count = static_cast<double>(A.get_nonzero_count());
+        SolverMonitor monitor(options, matrix_size, VectorOperations::norm2(matrix_size, b));
+        monitor.finish_setup();
+
+        TRACE_SCOPE("jacobi_csr_iterations");
+        benchmark_library::PerfRegion iterations_region("jacobi_csr_iterations");
+        /**
+         * Невязка считается для x_prev, поэтому при остановке по ней x_current только точнее.
+         */
+        auto result = iterate_rows(matrix_size, options, monitor, [offsets, columns, values, b](
+                size_t i, const float *x_prev, float *x_current, bool is_first_iteration, ThreadNorms &norms) {
+            float sum = 0.0f;
+            float diagonal = 0.0f;
+            float off_diagonal_sum = 0.0f;
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                sum += values[k] * x_prev[columns[k]];
+                if (columns[k] == i) {
+                    diagonal = values[k];
+                } else {
+                    off_diagonal_sum += std::abs(values[k]);
+                }
+            }
+            float residual = b[i] - sum;
+            float step = residual / diagonal;
+            x_current[i] = x_prev[i] + step;
+            norms.difference = std::max(norms.difference, std::abs(step));
+            norms.residual += static_cast<double>(residual) * residual;
+            if (is_first_iteration) {
+                norms.row_norm = std::max(norms.row_norm, off_diagonal_sum / std::abs(diagonal));
+            }
+        });
+        iterations_region.add_flops(static_cast<double>(result.iterations) * (2.0 * nonzero_count + 5.0 * n));
+        return result;
+    }
+
+    SolverResult JacobiSolver::solve_block(const matrix_library::Matrix &A, const matrix_library::Matrix &B,
+                                           const SolverOptions &options) {
+        assert(A.get_row_count() == A.get_column_count());
+        assert(B.get_row_count() == A.get_row_count());
+        const size_t matrix_size = A.get_row_count();
+        const size_t rhs_count = B.get_column_count();
+        auto n = static_cast<double>(matrix_size);
+
+        std::vector<double> b_norms(rhs_count, 0.0);
+        for (size_t i = 0; i < matrix_size; ++i) {
+            for (size_t c = 0; c < rhs_count; ++c) {
+                b_norms[c] += static_cast<double>(B.get_element(i, c)) * B.get_element(i, c);
+            }
+        }
+        double b_norm = 0.0;
+        for (size_t c = 0; c < rhs_count; ++c) {
+            b_norm += b_norms[c];
+            b_norms[c] = std::sqrt(b_norms[c]);
+        }
+        /**
+         * Монитор следит за невязкой всех ещё не сошедшихся столбцов вместе (норма Фробениуса).
+         */
+        SolverMonitor monitor(options, matrix_size, std::sqrt(b_norm));
+
+        std::optional<tracing_library::TraceSpan> setup_span(std::in_place, "jacobi_block_setup");
+        const float q = iteration_norm(A);
+        const float threshold = (1 - q) / q * options.eps;
+        std::vector<float> inverse_diagonal(matrix_size);
+        for (size_t i = 0; i < matrix_size; ++i) {
+            inverse_diagonal[i] = 1.0f / A.get_element(i, i);
+        }
+
+        /**
+         * Несошедшиеся столбцы X и B хранятся подряд в матрицах n x active_count (ведущая размерность active_count),
+         * active[c] - номер столбца исходной задачи. Буферы выделяются один раз на k столбцов.
+         */
+        matrix_library::Matrix X(matrix_size, rhs_count);
+        matrix_library::Matrix X_active(matrix_size, rhs_count);
+        matrix_library::Matrix B_active(B);
+        matrix_library::Matrix AX(matrix_size, rhs_count);
+        std::vector<size_t> active(rhs_count);
+        for (size_t c = 0; c < rhs_count; ++c) {
+            active[c] = c;
+        }
+        size_t active_count = rhs_count;
+        const auto threads_count = static_cast<size_t>(omp_get_max_threads());
+        std::vector<float> thread_norms(threads_count * rhs_count);
+        std::vector<double> thread_residuals(threads_count * rhs_count);
+        std::vector<float> difference_norms(rhs_count);
+        std::vector<double> residual_norms(rhs_count);
+        std::vector<size_t> packed_columns(rhs_count);  // откуда в упакованной матрице берётся оставшийся столбец
+        setup_span.reset();
+        monitor.finish_setup();
+
+        TRACE_SCOPE("jacobi_block_iterations");
+        benchmark_library::PerfRegion iterations_region("jacobi_block_iterations");
+        const auto &backend = matrix_library::BlasBackend::instance();
+        float *x = X_active.get_data();
+        float *b = B_active.get_data();
+        float *ax = AX.get_data();
+        float *norms = thread_norms.data();
+        double *residuals = thread_residuals.data();
+        const float *d_inv = inverse_diagonal.data();
+        size_t iterations = 0;
+        std::optional<SolverStatus> status;
+        while (!status) {
+            iterations_region.add_flops(2.0 * n * n * static_cast<double>(active_count) + 5.0 * n * static_cast<double>(active_count));
+            ++iterations;
+            {
+                TRACE_SCOPE("jacobi_block_gemm");
+                backend.sgemm(matrix_library::BlasTranspose::NO, matrix_library::BlasTranspose::NO,
+                              matrix_size, active_count, matrix_size,
+                              1.0f, A.get_data(), matrix_size, x, active_count, 0.0f, ax, active_count);
+            }
+
+            TRACE_SCOPE("jacobi_block_update");
+            /**
+             * Каждый поток копит максимумы шагов и суммы квадратов невязки по столбцам в своей строке, затем они сводятся.
+             */
+#pragma omp parallel default(none) shared(matrix_size, active_count, x, b, ax, norms, residuals, d_inv)
+            {
+                const auto thread = static_cast<size_t>(omp_get_thread_num());
+                float *local_norms = norms + thread * active_count;
+                double *local_residuals = residuals + thread * active_count;
+                std::fill(local_norms, local_norms + active_count, 0.0f);
+                std::fill(local_residuals, local_residuals + active_count, 0.0);
+#pragma omp for schedule(static)
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    const size_t row = i * active_count;
+#pragma omp simd
+                    for (size_t c = 0; c < active_count; ++c) {
+                        float residual = b[row + c] - ax[row + c];
+                        float step = residual * d_inv[i];
+                        x[row + c] += step;
+                        local_norms[c] = std::max(local_norms[c], std::abs(step));
+                        local_residuals[c] += static_cast<double>(residual) * residual;
+                    }
+                }
+            }
+            std::fill(difference_norms.begin(), difference_norms.begin() + active_count, 0.0f);
+            std::fill(residual_norms.begin(), residual_norms.begin() + active_count, 0.0);
+            for (size_t thread = 0; thread < threads_count; ++thread) {
+                for (size_t c = 0; c < active_count; ++c) {
+                    difference_norms[c] = std::max(difference_norms[c], norms[thread * active_count + c]);
+                    residual_norms[c] += residuals[thread * active_count + c];
+                }
+            }
+            double residual_norm = 0.0;
+            for (size_t c = 0; c < active_count; ++c) {
+                residual_norm += residual_norms[c];
+            }
+            residual_norm = std::sqrt(residual_norm);
+
+            /**
+             * Столбец сошёлся, как в solve_matrix_free: при q < 1 - по разности итераций, иначе - по своей невязке.
+             * Сошедшиеся столбцы переписываются в ответ, оставшиеся сдвигаются к началу строк.
+             * Сдвиг идёт на месте в порядке возрастания адресов, поэтому ничего не затирается.
+             */
+            size_t remaining_count = 0;
+            for (size_t c = 0; c < active_count; ++c) {
+                bool converged = q < 1.0f ? difference_norms[c] <= threshold
+                                          : std::sqrt(residual_norms[c]) <= options.eps * b_norms[active[c]];
+                if (converged) {
+                    for (size_t i = 0; i < matrix_size; ++i) {
+                        X.get_element(i, active[c]) = x[i * active_count + c];
+                    }
+                } else {
+                    active[remaining_count] = active[c];
+                    packed_columns[remaining_count] = c;
+                    ++remaining_count;
+                }
+            }
+            if (remaining_count != active_count && remaining_count > 0) {
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    for (size_t c = 0; c < remaining_count; ++c) {
+                        x[i * remaining_count + c] = x[i * active_count + packed_columns[c]];
+                        b[i * remaining_count + c] = b[i * active_count + packed_columns[c]];
+                    }
+                }
+            }
+            active_count = remaining_count;
+            status = monitor.finish_iteration(iterations, active_count == 0, false, [&]() { return residual_norm; });
+        }
+
+        /**
+         * При аварийной остановке в ответ попадают последние приближения несошедшихся столбцов.
+         */
+        for (size_t c = 0; c < active_count; ++c) {
+            for (size_t i = 0; i < matrix_size; ++i) {
+                X.get_element(i, active[c]) = x[i * active_count + c];
+            }
+        }
+        return monitor.make_result(std::move(X), iterations, *status);
+    }
+
+    SolverResult JacobiSolver::solve_block(const linear_systems_library::LinearSystem &system,
+                                           const SolverOptions &options) {
+        return solve_block(system.get_A(), system.get_b(), options);
+    }
+
+    float JacobiSolver::iteration_norm(const matrix_library::Matrix &A) {
+        assert(A.get_row_count() == A.get_column_count());
+        const size_t matrix_size = A.get_row_count();
+        float norm = 0.0f;
+#pragma omp parallel for schedule(static) default(none) shared(A, matrix_size) reduction(max:norm)
+        for (size_t i = 0; i < matrix_size; ++i) {
+            const float *a_row = &A.get_element(i, 0);
+            float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+            for (size_t j = 0; j < matrix_size; ++j) {
+                sum += std::abs(a_row[j]);
+            }
+            float diagonal = std::abs(a_row[i]);
+            norm = std::max(norm, (sum - diagonal) / diagonal);
+        }
+        return norm;
     }
 
     float JacobiSolver::matrix_norm_inf(const matrix_library::Matrix &matrix) {
@@ -126,20 +612,4 @@ namespace linear_systems_library {
 
         return result;
     }
-
-    matrix_library::Matrix
-    JacobiSolver::matrix_addition_omp(const matrix_library::Matrix &lhs, const matrix_library::Matrix &rhs) {
-        assert(lhs.get_row_count() == rhs.get_row_count());
-        assert(lhs.get_column_count() == rhs.get_column_count());
-
-        matrix_library::Matrix result(lhs.get_row_count(), lhs.get_column_count());
-#pragma omp parallel for collapse(2) default(none) shared(lhs, rhs, result)
-        for (size_t i = 0; i < result.get_row_count(); ++i) {
-            for (size_t j = 0; j < result.get_column_count(); ++j) {
-                result.get_element(i, j) = lhs.get_element(i, j) + rhs.get_element(i, j);
-            }
-        }
-
-        return result;
-    }
 }
\ No newline at end of file
@@ -6,26 +6,103 @@
 #include "LinearSystem.h"
 #include "Matrix.h"
 #include "MatrixMultiplier.h"
+#include "SolverMonitor.h"
+#include "SparseLinearSystem.h"
 
 namespace linear_systems_library {
     class JacobiSolver {
     public:
         /**
          * @brief Решить СЛАУ.
+         * @details Если q >= 1, сходимость не гарантирована: итерации идут до ||b - A x|| <= eps * ||b||,
+         * @details а расходимость, застой и лимиты отслеживает SolverMonitor.
          * @param system СЛАУ.
-         * @param eps Требуемая точность.
-         * @return Вектор-столбец с решением.
+         * @param options Точность и условия аварийной остановки.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
          */
-        static matrix_library::Matrix solve(const linear_systems_library::LinearSystem &system, float eps = 1e-5);
+        static SolverResult solve(const linear_systems_library::LinearSystem &system,
+                                  const SolverOptions &options = SolverOptions());
 
         /**
-         * /**
          * @brief Решить СЛАУ. Используется OMP.
          * @param system СЛАУ.
-         * @param eps Требуемая точность.
-         * @return Вектор-столбец с решением.
+         * @param options Точность и условия аварийной остановки.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
          */
-        static matrix_library::Matrix solve_omp(const linear_systems_library::LinearSystem &system, float eps = 1e-5);
+        static SolverResult solve_omp(const linear_systems_library::LinearSystem &system,
+                                      const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Решить СЛАУ без построения матриц D^-1 и B. Используется OMP.
+         * @details Каждая итерация - один проход по строкам A: x_new[i] = x[i] + (b[i] - sum_j A[i][j] * x[j]) / A[i][i].
+         * @details Норма матрицы перехода q = max_i sum_{j!=i} |A[i][j] / A[i][i]| считается в том же проходе на первой итерации,
+         * @details поэтому подготовка стоит O(n), а памяти нужно только под A и два вектора.
+         * @details Итерации идут в одной параллельной области без редукций, проверка сходимости отложена на итерацию
+         * @details и делается раз в options.steps_per_check итераций.
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve_matrix_free(const linear_systems_library::LinearSystem &system,
+                                              const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Решить A x = b без построения матриц D^-1 и B, см. solve_matrix_free(system).
+         * @details Матрица не копируется: так решает системы для поправки RefinementSolver.
+         * @param A Квадратная матрица коэффициентов.
+         * @param b Вектор-столбец свободных членов.
+         * @param options Точность и условия аварийной остановки.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve_matrix_free(const matrix_library::Matrix &A, const matrix_library::Matrix &b,
+                                              const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Решить СЛАУ с разреженной матрицей в формате CSR. Используется OMP.
+         * @details Итерация - один проход по строкам CSR, как в solve_matrix_free: строки независимы и делятся между потоками.
+         * @details Память - матрица и два вектора, поэтому помещаются системы с 10^7 неизвестных.
+         * @details Если q < 1 (строгое диагональное преобладание), критерий остановки тот же, что в остальных вариантах.
+         * @details У разностных операторов Лапласа q = 1, и тогда итерации идут до ||b - A x|| <= eps * ||b||;
+         * @details невязка получается в том же проходе бесплатно. Проверка сходимости - как в solve_matrix_free.
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve_csr(const linear_systems_library::SparseLinearSystem &system,
+                                      const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Решить СЛАУ с одной матрицей и несколькими правыми частями A X = B. Используется OMP.
+         * @details Каждая итерация - одно умножение матриц R = B - A X (sgemm) по всем ещё не сошедшимся столбцам
+         * @details и обновление X = X + D^-1 R, так что A читается из памяти один раз за итерацию на все правые части,
+         * @details а не по разу на каждую, как при решении по одной.
+         * @details Сходимость проверяется по каждому столбцу отдельно (как в solve_matrix_free). Сошедшиеся столбцы
+         * @details выбывают: оставшиеся переупаковываются подряд, и следующие sgemm становятся уже.
+         * @details Лимиты, расходимость и застой отслеживает SolverMonitor по общей невязке несошедшихся столбцов.
+         * @param A Квадратная матрица коэффициентов.
+         * @param B Матрица правых частей n x k.
+         * @param options Точность и условия аварийной остановки.
+         * @return Матрица решений n x k, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve_block(const matrix_library::Matrix &A, const matrix_library::Matrix &B,
+                                        const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Решить СЛАУ со всеми правыми частями системы, см. solve_block(A, B).
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @return Матрица решений n x k, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve_block(const linear_systems_library::LinearSystem &system,
+                                        const SolverOptions &options = SolverOptions());
+
+        /**
+         * @brief Найти норму матрицы перехода метода Якоби q = max_i sum_{j!=i} |A[i][j] / A[i][i]|, не строя её.
+         * @details Если q < 1, метод Якоби сходится.
+         * @param A Квадратная матрица коэффициентов.
+         * @return Норма матрицы перехода.
+         */
+        static float iteration_norm(const matrix_library::Matrix &A);
 
     private:
         /**
@@ -49,14 +126,6 @@ namespace linear_systems_library {
          * @return Разность матриц.
          */
         static matrix_library::Matrix matrix_subtraction_omp(const matrix_library::Matrix& lhs, const matrix_library::Matrix& rhs);
-
-        /**
-         * @brief Найти сумму матриц. Используется OMP.
-         * @param lhs Первое слагаемое.
-         * @param rhs Второе слагаемое.
-         * @return Сумма матриц.
-         */
-        static matrix_library::Matrix matrix_addition_omp(const matrix_library::Matrix& lhs, const matrix_library::Matrix& rhs);
     };
 }
 
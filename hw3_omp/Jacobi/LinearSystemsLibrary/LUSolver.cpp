@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "BlasBackend.h"
+#include "LUSolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+
+namespace linear_systems_library {
+
+    template<typename T>
+    bool LUFactorization<T>::factorize(T *a, size_t matrix_size, size_t *pivots, size_t block_size) {
+        /**
+         * Об алгоритме: https://ru.wikipedia.org/wiki/LU-разложение
+         * Блочный вариант: Golub, Van Loan, Matrix Computations, 3.2.11, и dgetrf из LAPACK.
+         */
+        assert(block_size > 0);
+        const size_t blocks_count = (matrix_size + block_size - 1) / block_size;
+        auto n = static_cast<double>(matrix_size);
+
+        TRACE_SCOPE("lu_factorization");
+        benchmark_library::PerfRegion factorization_region("lu_factorization", 2.0 / 3.0 * n * n * n);
+        /**
+         * Элементы block_tokens служат только адресами для зависимостей задач: по одному на блок столбцов.
+         * Задача k-й панели ждёт все обновления своего блока, обновление j-го блока ждёт k-ю панель.
+         */
+        std::vector<char> block_tokens(blocks_count);
+        bool singular = false;
+        matrix_library::SingleThreadedBlas single_threaded_blas;  // sgemm вызывается из задач, каждая уже занимает поток OMP
+#pragma omp parallel default(none) shared(a, matrix_size, pivots, block_size, blocks_count, block_tokens, singular)
+#pragma omp single
+        for (size_t k = 0; k < blocks_count; ++k) {
+            const size_t panel_column = k * block_size;
+            const size_t panel_width = std::min(block_size, matrix_size - panel_column);
+#pragma omp task default(shared) firstprivate(panel_column, panel_width) depend(inout: block_tokens.data()[k])
+            {
+                if (!factorize_panel(a, matrix_size, pivots, panel_column, panel_width)) {
+#pragma omp atomic write
+                    singular = true;
+                }
+            }
+            for (size_t j = k + 1; j < blocks_count; ++j) {
+                const size_t column = j * block_size;
+                const size_t width = std::min(block_size, matrix_size - column);
+#pragma omp task default(shared) firstprivate(panel_column, panel_width, column, width) \
+        depend(in: block_tokens.data()[k]) depend(inout: block_tokens.data()[j])
+                update_block(a, matrix_size, pivots, panel_column, panel_width, column, width);
+            }
+        }
+
+        if (singular) {
+            return false;
+        }
+
+        /**
+         * Блоки левее панели (уже готовые столбцы L) переставляются в конце, когда все перестановки известны.
+         */
+        for (size_t k = 1; k < blocks_count; ++k) {
+            const size_t panel_column = k * block_size;
+            swap_rows(a, matrix_size, pivots, panel_column, std::min(block_size, matrix_size - panel_column),
+                      0, panel_column);
+        }
+        return true;
+    }
+
+    template<typename T>
+    void LUFactorization<T>::substitute(const T *lu, const size_t *pivots, size_t matrix_size, T *x) {
+        for (size_t i = 0; i < matrix_size; ++i) {
+            std::swap(x[i], x[pivots[i]]);
+        }
+        /**
+         * Прямой ход L y = P b (диагональ L единичная) и обратный U x = y.
+         */
+        for (size_t i = 0; i < matrix_size; ++i) {
+            const T *l_row = lu + i * matrix_size;
+            T sum = 0;
+#pragma omp simd reduction(+:sum)
+            for (size_t p = 0; p < i; ++p) {
+                sum += l_row[p] * x[p];
+            }
+            x[i] -= sum;
+        }
+        for (size_t i = matrix_size; i-- > 0;) {
+            const T *u_row = lu + i * matrix_size;
+            T sum = 0;
+#pragma omp simd reduction(+:sum)
+            for (size_t p = i + 1; p < matrix_size; ++p) {
+                sum += u_row[p] * x[p];
+            }
+            x[i] = (x[i] - sum) / u_row[i];
+        }
+    }
+
+    template<typename T>
+    bool LUFactorization<T>::factorize_panel(T *a, size_t matrix_size, size_t *pivots, size_t column, size_t width) {
+        const size_t panel_end = column + width;
+        for (size_t k = column; k < panel_end; ++k) {
+            size_t pivot = k;
+            T pivot_value = std::abs(a[k * matrix_size + k]);
+            for (size_t i = k + 1; i < matrix_size; ++i) {
+                T value = std::abs(a[i * matrix_size + k]);
+                if (value > pivot_value) {
+                    pivot = i;
+                    pivot_value = value;
+                }
+            }
+            pivots[k] = pivot;
+            if (pivot_value == 0) {
+                return false;
+            }
+            if (pivot != k) {
+                std::swap_ranges(a + k * matrix_size + column, a + k * matrix_size + panel_end,
+                                 a + pivot * matrix_size + column);
+            }
+
+            const T *u_row = a + k * matrix_size;
+            T inverse_pivot = 1 / u_row[k];
+            for (size_t i = k + 1; i < matrix_size; ++i) {
+                T *row = a + i * matrix_size;
+                T factor = row[k] * inverse_pivot;
+                row[k] = factor;
+#pragma omp simd
+                for (size_t j = k + 1; j < panel_end; ++j) {
+                    row[j] -= factor * u_row[j];
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    void LUFactorization<T>::update_block(T *a, size_t matrix_size, const size_t *pivots, size_t panel_column,
+                                          size_t panel_width, size_t column, size_t width) {
+        swap_rows(a, matrix_size, pivots, panel_column, panel_width, column, width);
+
+        /**
+         * U12 = L11^-1 A12, L11 - нижнетреугольная с единичной диагональю.
+         */
+        const size_t panel_end = panel_column + panel_width;
+        for (size_t i = panel_column + 1; i < panel_end; ++i) {
+            T *row = a + i * matrix_size + column;
+            for (size_t p = panel_column; p < i; ++p) {
+                T factor = a[i * matrix_size + p];
+                const T *u_row = a + p * matrix_size + column;
+#pragma omp simd
+                for (size_t j = 0; j < width; ++j) {
+                    row[j] -= factor * u_row[j];
+                }
+            }
+        }
+
+        /**
+         * A22 = A22 - L21 * U12. Здесь O(n^3) работы из всего разложения.
+         */
+        if (panel_end < matrix_size) {
+            subtract_product(matrix_size - panel_end, width, panel_width,
+                             a + panel_end * matrix_size + panel_column,
+                             a + panel_column * matrix_size + column,
+                             a + panel_end * matrix_size + column, matrix_size);
+        }
+    }
+
+    template<typename T>
+    void LUFactorization<T>::swap_rows(T *a, size_t matrix_size, const size_t *pivots, size_t panel_column,
+                                       size_t panel_width, size_t column, size_t width) {
+        for (size_t k = panel_column; k < panel_column + panel_width; ++k) {
+            size_t pivot = pivots[k];
+            if (pivot != k) {
+                std::swap_ranges(a + k * matrix_size + column, a + k * matrix_size + column + width,
+                                 a + pivot * matrix_size + column);
+            }
+        }
+    }
+
+    template<>
+    void LUFactorization<float>::subtract_product(size_t rows, size_t columns, size_t depth, const float *l,
+                                                  const float *u, float *c, size_t matrix_size) {
+        matrix_library::BlasBackend::instance().sgemm(
+                matrix_library::BlasTranspose::NO, matrix_library::BlasTranspose::NO,
+                rows, columns, depth, -1.0f, l, matrix_size, u, matrix_size, 1.0f, c, matrix_size);
+    }
+
+    template<>
+    void LUFactorization<double>::subtract_product(size_t rows, size_t columns, size_t depth, const double *l,
+                                                   const double *u, double *c, size_t matrix_size) {
+        /**
+         * Порядок i-p-j: внутренний цикл идёт по строкам U и C подряд и векторизуется.
+         * Параллельность даёт граф задач: блоки столбцов обновляются одновременно.
+         */
+        for (size_t i = 0; i < rows; ++i) {
+            double *c_row = c + i * matrix_size;
+            for (size_t p = 0; p < depth; ++p) {
+                double factor = l[i * matrix_size + p];
+                const double *u_row = u + p * matrix_size;
+#pragma omp simd
+                for (size_t j = 0; j < columns; ++j) {
+                    c_row[j] -= factor * u_row[j];
+                }
+            }
+        }
+    }
+
+    template class LUFactorization<float>;
+    template class LUFactorization<double>;
+
+    LUSolver::LUSolver(const matrix_library::Matrix &A, size_t block_size) : LU_(A), pivots_(A.get_row_count()) {
+        assert(A.get_row_count() == A.get_column_count());
+        if (!LUFactorization<float>::factorize(LU_.get_data(), LU_.get_row_count(), pivots_.data(), block_size)) {
+            throw std::invalid_argument("Matrix is singular.");
+        }
+    }
+
+    matrix_library::Matrix LUSolver::solve(const matrix_library::Matrix &B) const {
+        const size_t matrix_size = LU_.get_row_count();
+        assert(B.get_row_count() == matrix_size);
+        const size_t rhs_count = B.get_column_count();
+
+        TRACE_SCOPE("lu_solve");
+        matrix_library::Matrix X(B);
+#pragma omp parallel default(none) shared(matrix_size, rhs_count, X)
+        {
+            std::vector<float> column(matrix_size);
+#pragma omp for schedule(dynamic)
+            for (size_t c = 0; c < rhs_count; ++c) {
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    column[i] = X.get_element(i, c);
+                }
+                LUFactorization<float>::substitute(LU_.get_data(), pivots_.data(), matrix_size, column.data());
+                for (size_t i = 0; i < matrix_size; ++i) {
+                    X.get_element(i, c) = column[i];
+                }
+            }
+        }
+        return X;
+    }
+
+    matrix_library::Matrix LUSolver::solve(const linear_systems_library::LinearSystem &system, size_t block_size) {
+        return LUSolver(system.get_A(), block_size).solve(system.get_b());
+    }
+
+    const matrix_library::Matrix &LUSolver::get_factors() const {
+        return LU_;
+    }
+
+    const std::vector<size_t> &LUSolver::get_pivots() const {
+        return pivots_;
+    }
+}
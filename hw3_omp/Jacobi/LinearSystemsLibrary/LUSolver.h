@@ -0,0 +1,125 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_LUSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_LUSOLVER_H
+
+#include <vector>
+
+#include <omp.h>
+
+#include "LinearSystem.h"
+#include "Matrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Блочное LU-разложение с выбором главного элемента по столбцу на месте в точности T.
+     * @details Алгоритм LUSolver над массивом элементов T. Обновление A22 = A22 - L21 * U12 для float - sgemm
+     * @details выбранной реализации BLAS, для double - встроенный цикл (в BlasBackend только float).
+     * @details На нём построены LUSolver и LU-разложение в RefinementSolver.
+     * @tparam T float или double.
+     */
+    template<typename T>
+    class LUFactorization {
+    public:
+        /**
+         * @brief Разложить P A = L U на месте.
+         * @param a Квадратная матрица по строкам. Заменяется на L (без единичной диагонали) под диагональю и U.
+         * @param matrix_size Размер матрицы.
+         * @param pivots Массив на matrix_size элементов: pivots[i] - строка, переставленная с i-й на i-м шаге исключения.
+         * @param block_size Ширина блока столбцов.
+         * @return False, если матрица вырождена.
+         */
+        static bool factorize(T *a, size_t matrix_size, size_t *pivots, size_t block_size = 128);
+
+        /**
+         * @brief Решить A x = b по готовому разложению: прямая и обратная подстановки за O(n^2).
+         * @param lu Множители разложения.
+         * @param pivots Перестановки строк.
+         * @param matrix_size Размер матрицы.
+         * @param x На входе b, на выходе решение.
+         */
+        static void substitute(const T *lu, const size_t *pivots, size_t matrix_size, T *x);
+
+    private:
+        /**
+         * @brief Разложить панель: столбцы [column, column + width) в строках от column до конца.
+         * @details Перестановки строк применяются только внутри панели, остальные блоки переставляются отдельно.
+         * @return False, если встретился нулевой главный элемент.
+         */
+        static bool factorize_panel(T *a, size_t matrix_size, size_t *pivots, size_t column, size_t width);
+
+        /**
+         * @brief Обновить блок столбцов [column, column + width) после разложения панели, начинающейся в panel_column:
+         * @brief применить перестановки панели, U12 = L11^-1 A12, A22 = A22 - L21 * U12.
+         */
+        static void update_block(T *a, size_t matrix_size, const size_t *pivots, size_t panel_column,
+                                 size_t panel_width, size_t column, size_t width);
+
+        /**
+         * @brief Применить перестановки строк панели к блоку столбцов.
+         */
+        static void swap_rows(T *a, size_t matrix_size, const size_t *pivots, size_t panel_column,
+                              size_t panel_width, size_t column, size_t width);
+
+        /**
+         * @brief C = C - L U, L - rows x depth, U - depth x columns, все с ведущей размерностью matrix_size.
+         */
+        static void subtract_product(size_t rows, size_t columns, size_t depth, const T *l, const T *u, T *c,
+                                     size_t matrix_size);
+    };
+
+    /**
+     * @brief Прямой метод: LU-разложение с выбором главного элемента по столбцу, P A = L U.
+     * @details Разложение блочное правостороннее (right-looking): столбцы делятся на блоки ширины block_size,
+     * @details блок-панель раскладывается построчно, а оставшаяся часть матрицы обновляется умножением матриц
+     * @details A22 = A22 - L21 * U12 (sgemm выбранной реализации BLAS), где сосредоточена почти вся работа.
+     * @details Разложение панели и обновления оформлены задачами OMP с зависимостями по блокам столбцов,
+     * @details поэтому следующая панель раскладывается, как только обновлён её блок, параллельно с обновлением остальных
+     * @details (опережающий просмотр, lookahead).
+     * @details Разложение считается один раз в конструкторе и переиспользуется для любого количества правых частей.
+     * @details Само разложение - LUFactorization<float>.
+     */
+    class LUSolver {
+    public:
+        /**
+         * @brief Конструктор. Раскладывает матрицу.
+         * @details Бросает std::invalid_argument, если матрица вырождена.
+         * @param A Квадратная матрица.
+         * @param block_size Ширина блока столбцов.
+         */
+        explicit LUSolver(const matrix_library::Matrix &A, size_t block_size = 128);
+
+        /**
+         * @brief Решить A X = B по готовому разложению.
+         * @details Столбцы B решаются параллельно, каждый - прямой и обратной подстановкой за O(n^2).
+         * @param B Матрица правых частей n x k (или вектор-столбец).
+         * @return Матрица решений n x k.
+         */
+        matrix_library::Matrix solve(const matrix_library::Matrix &B) const;
+
+        /**
+         * @brief Решить СЛАУ: разложить матрицу и решить для всех правых частей.
+         * @param system СЛАУ.
+         * @param block_size Ширина блока столбцов.
+         * @return Решение.
+         */
+        static matrix_library::Matrix solve(const linear_systems_library::LinearSystem &system, size_t block_size = 128);
+
+        /**
+         * @brief Получить множители разложения.
+         * @return L (без единичной диагонали) под диагональю и U на диагонали и над ней. Неизменяемая ссылка.
+         */
+        const matrix_library::Matrix &get_factors() const;
+
+        /**
+         * @brief Получить перестановку строк.
+         * @return pivots[i] - строка, переставленная с i-й на i-м шаге исключения. Неизменяемая ссылка.
+         */
+        const std::vector<size_t> &get_pivots() const;
+
+    private:
+        matrix_library::Matrix LU_;
+        std::vector<size_t> pivots_;
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_LUSOLVER_H
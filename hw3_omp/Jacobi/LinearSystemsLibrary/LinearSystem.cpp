@@ -1,20 +1,253 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
 #include "LinearSystem.h"
+#include "SplitMix.h"
+#include "Tracing.h"
 
 namespace linear_systems_library {
 
-    LinearSystem::LinearSystem(size_t size, bool diagonally_dominant) : A_(size, size), x_(matrix_library::Matrix(size, 1)) {
-        A_.initialize_randomly();
-        if (diagonally_dominant) {
-            for (size_t i = 0; i < A_.get_row_count(); ++i) {
-                float sum = 0.0f;
-                for (size_t j = 0; j < A_.get_column_count(); ++j) {
-                    sum += A_.get_element(i, j);
+    namespace {
+
+        /**
+         * Сигнатура в начале файла СЛАУ.
+         */
+        const char FILE_MAGIC[8] = {'L', 'I', 'N', 'S', 'Y', 'S', '0', '1'};
+
+        /**
+         * При записи в файл строки A генерируются блоками примерно по столько элементов (64 Мб).
+         */
+        const size_t STREAM_BLOCK_ELEMENTS = size_t(1) << 24;
+
+        /**
+         * @brief Заголовок файла СЛАУ. За ним идут A (size x size), b и x (size x rhs_count) по строкам, float.
+         */
+        struct FileHeader {
+            char magic[8];
+            uint64_t size;
+            uint64_t rhs_count;
+        };
+
+        using benchmark_library::splitmix64;
+        using benchmark_library::uniform;
+
+        /**
+         * @brief Параметры генерируемой системы.
+         */
+        struct GeneratorParameters {
+            size_t size;
+            size_t rhs_count;
+            bool diagonally_dominant;
+            bool symmetric;
+            uint64_t A_key;
+            uint64_t x_key;
+
+            GeneratorParameters(size_t size, bool diagonally_dominant, bool symmetric, size_t rhs_count, uint64_t seed) :
+                    size(size), rhs_count(rhs_count), diagonally_dominant(diagonally_dominant), symmetric(symmetric),
+                    A_key(splitmix64(seed)), x_key(splitmix64(splitmix64(seed))) {}
+        };
+
+        /**
+         * @brief Сгенерировать известное решение.
+         * @param parameters Параметры системы.
+         * @param x Решение, size x rhs_count.
+         */
+        void generate_x(const GeneratorParameters &parameters, matrix_library::Matrix &x) {
+            const size_t n = parameters.size;
+            const size_t k = parameters.rhs_count;
+            const uint64_t key = parameters.x_key;
+#pragma omp parallel for default(none) shared(x, n, k, key)
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t c = 0; c < k; ++c) {
+                    x.get_element(i, c) = uniform(key, i * k + c);
                 }
-                A_.get_element(i, i) = sum * 2;
             }
         }
-        x_->initialize_randomly();
-        b_ = matrix_library::MatrixMultiplier::multiplication_cblas(A_, x_.value());
+
+        /**
+         * @brief Сгенерировать строки [first_row, last_row) матрицы A и соответствующие строки b за один проход.
+         * @details Элемент строки генерируется, прибавляется к сумме строки и к скалярному произведению с x.
+         * @details Диагональ заменяется на удвоенную сумму строки уже после прохода, а b поправляется на разницу.
+         * @details Симметричный элемент (i, j) берётся по номеру (min(i, j), max(i, j)), поэтому строки независимы.
+         * @param parameters Параметры системы.
+         * @param x Известное решение, size x rhs_count.
+         * @param first_row Первая строка блока.
+         * @param last_row Строка за последней.
+         * @param A_rows Строки A, (last_row - first_row) x size подряд.
+         * @param b_rows Строки b, (last_row - first_row) x rhs_count подряд.
+         */
+        void generate_rows(const GeneratorParameters &parameters, const matrix_library::Matrix &x,
+                           size_t first_row, size_t last_row, float *A_rows, float *b_rows) {
+            TRACE_SCOPE("linear_system_generate_rows");
+            const size_t n = parameters.size;
+            const size_t k = parameters.rhs_count;
+            const uint64_t key = parameters.A_key;
+            const bool diagonally_dominant = parameters.diagonally_dominant;
+            const bool symmetric = parameters.symmetric;
+            const float *x_data = &x.get_element(0, 0);
+#pragma omp parallel default(none) shared(n, k, key, diagonally_dominant, symmetric, x_data, first_row, last_row, A_rows, b_rows)
+            {
+                std::vector<double> dot(k);
+#pragma omp for schedule(static)
+                for (size_t i = first_row; i < last_row; ++i) {
+                    float *row = A_rows + (i - first_row) * n;
+                    float sum = 0.0f;
+                    if (k == 1) {
+                        double dot_single = 0.0;
+#pragma omp simd reduction(+:sum, dot_single)
+                        for (size_t j = 0; j < n; ++j) {
+                            float a = uniform(key, symmetric && j < i ? j * n + i : i * n + j);
+                            row[j] = a;
+                            sum += a;
+                            dot_single += static_cast<double>(a) * x_data[j];
+                        }
+                        dot[0] = dot_single;
+                    } else {
+                        std::fill(dot.begin(), dot.end(), 0.0);
+                        for (size_t j = 0; j < n; ++j) {
+                            float a = uniform(key, symmetric && j < i ? j * n + i : i * n + j);
+                            row[j] = a;
+                            sum += a;
+                            for (size_t c = 0; c < k; ++c) {
+                                dot[c] += static_cast<double>(a) * x_data[j * k + c];
+                            }
+                        }
+                    }
+                    if (diagonally_dominant) {
+                        float diagonal = sum * 2;
+                        for (size_t c = 0; c < k; ++c) {
+                            dot[c] += static_cast<double>(diagonal - row[i]) * x_data[i * k + c];
+                        }
+                        row[i] = diagonal;
+                    }
+                    for (size_t c = 0; c < k; ++c) {
+                        b_rows[(i - first_row) * k + c] = static_cast<float>(dot[c]);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Записать строки матрицы в поток подряд.
+         * @param output Поток.
+         * @param matrix Матрица.
+         */
+        void write_matrix(std::ofstream &output, const matrix_library::Matrix &matrix) {
+            for (size_t i = 0; i < matrix.get_row_count(); ++i) {
+                output.write(reinterpret_cast<const char *>(&matrix.get_element(i, 0)),
+                             static_cast<std::streamsize>(matrix.get_column_count() * sizeof(float)));
+            }
+        }
+
+        /**
+         * @brief Прочитать строки матрицы из потока.
+         * @param input Поток.
+         * @param matrix Матрица нужного размера.
+         */
+        void read_matrix(std::ifstream &input, matrix_library::Matrix &matrix) {
+            for (size_t i = 0; i < matrix.get_row_count(); ++i) {
+                input.read(reinterpret_cast<char *>(&matrix.get_element(i, 0)),
+                           static_cast<std::streamsize>(matrix.get_column_count() * sizeof(float)));
+            }
+        }
+
+        /**
+         * @brief Открыть файл на запись и записать заголовок.
+         * @details Бросает std::runtime_error, если файл не удалось открыть.
+         * @param path Путь к файлу.
+         * @param size Размер системы.
+         * @param rhs_count Количество правых частей.
+         * @return Поток, готовый к записи A.
+         */
+        std::ofstream open_for_writing(const std::string &path, size_t size, size_t rhs_count) {
+            std::ofstream output(path, std::ios_base::binary);
+            if (!output) {
+                throw std::runtime_error("Unable to open the system file for writing: " + path);
+            }
+            FileHeader header{};
+            std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+            header.size = size;
+            header.rhs_count = rhs_count;
+            output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            return output;
+        }
+    }
+
+    LinearSystem::LinearSystem(size_t size, bool diagonally_dominant, bool symmetric, size_t rhs_count,
+                               std::optional<uint64_t> seed) :
+            A_(size, size), b_(size, rhs_count), x_(matrix_library::Matrix(size, rhs_count)) {
+        TRACE_SCOPE("linear_system_generate");
+        GeneratorParameters parameters(size, diagonally_dominant, symmetric, rhs_count,
+                                       seed ? seed.value() : (uint64_t(std::random_device()()) << 32) ^ std::random_device()());
+        generate_x(parameters, x_.value());
+        generate_rows(parameters, x_.value(), 0, size, &A_.get_element(0, 0), &b_.get_element(0, 0));
+    }
+
+    LinearSystem::LinearSystem(matrix_library::Matrix A, matrix_library::Matrix b,
+                               std::optional<matrix_library::Matrix> x) :
+            A_(std::move(A)), b_(std::move(b)), x_(std::move(x)) {}
+
+    void LinearSystem::generate_to_file(const std::string &path, size_t size, bool diagonally_dominant, bool symmetric,
+                                        size_t rhs_count, uint64_t seed) {
+        TRACE_SCOPE("linear_system_generate_to_file");
+        GeneratorParameters parameters(size, diagonally_dominant, symmetric, rhs_count, seed);
+        matrix_library::Matrix x(size, rhs_count);
+        generate_x(parameters, x);
+
+        std::ofstream output = open_for_writing(path, size, rhs_count);
+        size_t block_rows = std::max<size_t>(1, STREAM_BLOCK_ELEMENTS / std::max<size_t>(1, size));
+        std::vector<float> A_block(std::min(block_rows, size) * size);
+        matrix_library::Matrix b(size, rhs_count);
+        for (size_t first_row = 0; first_row < size; first_row += block_rows) {
+            size_t last_row = std::min(size, first_row + block_rows);
+            generate_rows(parameters, x, first_row, last_row, A_block.data(), &b.get_element(first_row, 0));
+            output.write(reinterpret_cast<const char *>(A_block.data()),
+                         static_cast<std::streamsize>((last_row - first_row) * size * sizeof(float)));
+        }
+        write_matrix(output, b);
+        write_matrix(output, x);
+        if (!output) {
+            throw std::runtime_error("Unable to write the system file: " + path);
+        }
+    }
+
+    void LinearSystem::save(const std::string &path) const {
+        assert(x_.has_value());
+        std::ofstream output = open_for_writing(path, A_.get_row_count(), b_.get_column_count());
+        write_matrix(output, A_);
+        write_matrix(output, b_);
+        write_matrix(output, x_.value());
+        if (!output) {
+            throw std::runtime_error("Unable to write the system file: " + path);
+        }
+    }
+
+    LinearSystem LinearSystem::load(const std::string &path) {
+        TRACE_SCOPE("linear_system_load");
+        std::ifstream input(path, std::ios_base::binary);
+        if (!input) {
+            throw std::runtime_error("Unable to open the system file: " + path);
+        }
+        FileHeader header{};
+        input.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!input || std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+            header.size == 0 || header.rhs_count == 0) {
+            throw std::runtime_error("Unrecognized system file format: " + path);
+        }
+        matrix_library::Matrix A(header.size, header.size);
+        matrix_library::Matrix b(header.size, header.rhs_count);
+        matrix_library::Matrix x(header.size, header.rhs_count);
+        read_matrix(input, A);
+        read_matrix(input, b);
+        read_matrix(input, x);
+        if (!input) {
+            throw std::runtime_error("The system file is truncated: " + path);
+        }
+        return LinearSystem(std::move(A), std::move(b), std::move(x));
     }
 
     const matrix_library::Matrix &LinearSystem::get_A() const {
@@ -33,4 +266,4 @@ namespace linear_systems_library {
     bool LinearSystem::has_solving() const {
         return x_.has_value();
     }
-}
\ No newline at end of file
+}
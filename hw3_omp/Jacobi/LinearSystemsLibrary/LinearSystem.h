@@ -1,7 +1,9 @@
 #ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARSYSTEM_H
 #define HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARSYSTEM_H
 
+#include <cstdint>
 #include <optional>
+#include <string>
 
 #include "Matrix.h"
 #include "MatrixMultiplier.h"
@@ -13,6 +15,10 @@ namespace linear_systems_library {
 
     /**
      * @brief Класс для хранения систем линейных уравнений.
+     * @details Случайная система строится за один параллельный по строкам проход по A: элементы строки генерируются,
+     * @details тут же суммируются для диагонального преобладания и умножаются на x, так что b = A x получается
+     * @details без отдельного SGEMM. Генератор счётный: элемент (i, j) - хеш от seed и номера элемента,
+     * @details поэтому при одном seed система одна и та же при любом количестве потоков.
      */
     class LinearSystem {
     public:
@@ -20,8 +26,44 @@ namespace linear_systems_library {
          * @brief Конструирует случайную СЛАУ, решение сразу известно.
          * @param size Размер системы.
          * @param diagonally_dominant True, если требуется обеспечить диагональное преобладание матрицы коэффициентов.
+         * @param symmetric True, если матрица коэффициентов должна быть симметричной.
+         * @param rhs_count Количество правых частей (столбцов b и x).
+         * @param seed Зерно генератора. Если не задано, берётся из std::random_device.
+         * @details Симметричная матрица с диагональным преобладанием и положительной диагональю положительно определена,
+         * @details такие системы подходят для метода сопряжённых градиентов.
          */
-        explicit LinearSystem(size_t size, bool diagonally_dominant=true);
+        explicit LinearSystem(size_t size, bool diagonally_dominant=true, bool symmetric=false, size_t rhs_count=1,
+                              std::optional<uint64_t> seed=std::nullopt);
+
+        /**
+         * @brief Сгенерировать случайную СЛАУ сразу в двоичный файл, не держа A в памяти целиком.
+         * @details Строки генерируются блоками по несколько мегабайт и дописываются в файл. Файл совпадает с тем,
+         * @details что записал бы save у LinearSystem с теми же параметрами и seed.
+         * @details Бросает std::runtime_error, если файл не удалось записать.
+         * @param path Путь к файлу.
+         * @param size Размер системы.
+         * @param diagonally_dominant True, если требуется обеспечить диагональное преобладание матрицы коэффициентов.
+         * @param symmetric True, если матрица коэффициентов должна быть симметричной.
+         * @param rhs_count Количество правых частей.
+         * @param seed Зерно генератора.
+         */
+        static void generate_to_file(const std::string &path, size_t size, bool diagonally_dominant, bool symmetric,
+                                     size_t rhs_count, uint64_t seed);
+
+        /**
+         * @brief Записать систему в двоичный файл: заголовок, затем A, b и x по строкам.
+         * @details Бросает std::runtime_error, если файл не удалось записать.
+         * @param path Путь к файлу.
+         */
+        void save(const std::string &path) const;
+
+        /**
+         * @brief Прочитать систему из файла, записанного save или generate_to_file.
+         * @details Бросает std::runtime_error, если файл не удалось прочитать или это не файл СЛАУ.
+         * @param path Путь к файлу.
+         * @return Система с известным решением.
+         */
+        static LinearSystem load(const std::string &path);
 
         /**
          * @brief Получить матрицу коэффициентов.
@@ -31,13 +73,14 @@ namespace linear_systems_library {
 
         /**
          * @brief Получить вектор-столбец свободных членов.
+         * @details Если правых частей несколько, это матрица n x rhs_count, по столбцу на правую часть.
          * @return Свободные члены. Неизменяемая ссылка.
          */
         const matrix_library::Matrix &get_b() const;
 
         /**
          * @brief Получить решение системы, если ранее оно было сохранено в этом объекте.
-         * @return Решение системы. Вектор-столбец. Неизменяемая ссылка.
+         * @return Решение системы. Вектор-столбец (матрица n x rhs_count при нескольких правых частях). Неизменяемая ссылка.
          */
         const matrix_library::Matrix &get_x() const;
 
@@ -48,6 +91,8 @@ namespace linear_systems_library {
         bool has_solving() const;
 
     private:
+        LinearSystem(matrix_library::Matrix A, matrix_library::Matrix b, std::optional<matrix_library::Matrix> x);
+
         matrix_library::Matrix A_;
         matrix_library::Matrix b_;
         std::optional<matrix_library::Matrix> x_;
@@ -0,0 +1,75 @@
+#include <cassert>
+
+#include "Preconditioner.h"
+
+namespace linear_systems_library {
+
+    JacobiPreconditioner::JacobiPreconditioner(const matrix_library::Matrix &A) : inverse_diagonal_(A.get_row_count()) {
+        assert(A.get_row_count() == A.get_column_count());
+        for (size_t i = 0; i < inverse_diagonal_.size(); ++i) {
+            assert(A.get_element(i, i) != 0.0f);
+            inverse_diagonal_[i] = 1.0f / A.get_element(i, i);
+        }
+    }
+
+    void JacobiPreconditioner::apply(const float *r, float *z) const {
+        const size_t size = inverse_diagonal_.size();
+        const float *inverse_diagonal = inverse_diagonal_.data();
+#pragma omp parallel for simd schedule(static) default(none) shared(size, inverse_diagonal, r, z)
+        for (size_t i = 0; i < size; ++i) {
+            z[i] = inverse_diagonal[i] * r[i];
+        }
+    }
+
+    ILU0Preconditioner::ILU0Preconditioner(const matrix_library::Matrix &A) : LU_(A) {
+        /**
+         * Вариант IKJ исключения Гаусса: строка i исключается уже готовыми строками k < i.
+         * Изменяются только элементы, ненулевые в A, поэтому заполнения не возникает.
+         */
+        assert(A.get_row_count() == A.get_column_count());
+        const size_t matrix_size = A.get_row_count();
+        for (size_t i = 1; i < matrix_size; ++i) {
+            float *lu_row = &LU_.get_element(i, 0);
+            const float *a_row = &A.get_element(i, 0);
+            for (size_t k = 0; k < i; ++k) {
+                if (a_row[k] == 0.0f) {
+                    continue;
+                }
+                const float *u_row = &LU_.get_element(k, 0);
+                assert(u_row[k] != 0.0f);
+                float factor = lu_row[k] / u_row[k];
+                lu_row[k] = factor;
+#pragma omp simd
+                for (size_t j = k + 1; j < matrix_size; ++j) {
+                    lu_row[j] -= (a_row[j] != 0.0f) ? factor * u_row[j] : 0.0f;
+                }
+            }
+        }
+    }
+
+    void ILU0Preconditioner::apply(const float *r, float *z) const {
+        /**
+         * Прямой ход L y = r и обратный U z = y. Подстановки последовательны по строкам,
+         * векторизуется только скалярное произведение внутри строки.
+         */
+        const size_t matrix_size = LU_.get_row_count();
+        for (size_t i = 0; i < matrix_size; ++i) {
+            const float *l_row = &LU_.get_element(i, 0);
+            float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+            for (size_t k = 0; k < i; ++k) {
+                sum += l_row[k] * z[k];
+            }
+            z[i] = r[i] - sum;
+        }
+        for (size_t i = matrix_size; i-- > 0;) {
+            const float *u_row = &LU_.get_element(i, 0);
+            float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+            for (size_t j = i + 1; j < matrix_size; ++j) {
+                sum += u_row[j] * z[j];
+            }
+            z[i] = (z[i] - sum) / u_row[i];
+        }
+    }
+}
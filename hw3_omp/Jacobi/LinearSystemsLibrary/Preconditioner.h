@@ -0,0 +1,71 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_PRECONDITIONER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_PRECONDITIONER_H
+
+#include <vector>
+
+#include <omp.h>
+
+#include "Matrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Предобусловливатель M ~ A для методов подпространств Крылова.
+     * @details Метод вместо A x = b решает систему с A M^-1 или M^-1 A, у которой меньше число обусловленности.
+     */
+    class Preconditioner {
+    public:
+        virtual ~Preconditioner() = default;
+
+        /**
+         * @brief Решить M z = r.
+         * @details Не выделяет память. r и z не должны пересекаться.
+         * @param r Правая часть.
+         * @param z Результат.
+         */
+        virtual void apply(const float *r, float *z) const = 0;
+    };
+
+    /**
+     * @brief Предобусловливатель Якоби: M = diag(A).
+     */
+    class JacobiPreconditioner : public Preconditioner {
+    public:
+        /**
+         * @brief Конструктор.
+         * @param A Квадратная матрица с ненулевой диагональю.
+         */
+        explicit JacobiPreconditioner(const matrix_library::Matrix &A);
+
+        void apply(const float *r, float *z) const override;
+
+    private:
+        std::vector<float> inverse_diagonal_;
+    };
+
+    /**
+     * @brief Неполное LU-разложение без заполнения, ILU(0): M = L U, где L и U имеют
+     * @brief тот же портрет ненулевых элементов, что и A.
+     * @details Для плотной матрицы заполнения нет и ILU(0) совпадает с полным LU-разложением:
+     * @details построение стоит O(n^3), а метод сходится за одну-две итерации.
+     * @details Выигрыш по сравнению с предобусловливателем Якоби появляется на разреженных матрицах.
+     */
+    class ILU0Preconditioner : public Preconditioner {
+    public:
+        /**
+         * @brief Конструктор. Строит разложение.
+         * @param A Квадратная матрица, у которой разложение существует (например, с диагональным преобладанием).
+         */
+        explicit ILU0Preconditioner(const matrix_library::Matrix &A);
+
+        void apply(const float *r, float *z) const override;
+
+    private:
+        /**
+         * @brief L (без единичной диагонали) под диагональю и U на диагонали и над ней.
+         */
+        matrix_library::Matrix LU_;
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_PRECONDITIONER_H
@@ -0,0 +1,298 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_REFINEMENTSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_REFINEMENTSOLVER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <omp.h>
+
+#include "ConjugateGradientSolver.h"
+#include "JacobiSolver.h"
+#include "LinearSystem.h"
+#include "LUSolver.h"
+#include "Matrix.h"
+#include "SolverMonitor.h"
+#include "Tracing.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Метод, которым RefinementSolver решает систему для поправки.
+     */
+    enum class InnerSolver {
+        JACOBI,  // JacobiSolver::solve_matrix_free, нужна матрица с диагональным преобладанием
+        CONJUGATE_GRADIENT,  // ConjugateGradientSolver, нужна симметричная положительно определённая матрица
+        LU  // LUFactorization<Working>, разложение считается один раз в конструкторе
+    };
+
+    /**
+     * @brief Итерационное уточнение решения в смешанной точности.
+     * @details Система для поправки A d = r решается в рабочей точности Working (быстро: для float LU - блочное
+     * @details разложение на sgemm, данные вдвое меньше), а невязка r = b - A x и само решение x хранятся и считаются
+     * @details в точности Residual. Каждый шаг уменьшает погрешность примерно в cond(A) * eps(Working) раз
+     * @details (для Якоби и CG - в inner_eps раз), пока невязка не упрётся в точность Residual.
+     * @details Так решение получается с точностью Residual при пропускной способности Working.
+     * @details Элементы A и b - float, в double они представимы точно, поэтому RefinementSolver<float, double>
+     * @details решает ту же систему, что и чистый double-вариант RefinementSolver<double, double>.
+     * @details Уточнение останавливается, когда относительная невязка ||b - A x|| / ||b|| не больше eps
+     * @details или перестаёт уменьшаться хотя бы вдвое за шаг.
+     * @details Якоби и CG есть только в float, поэтому с ними Working должен быть float (проверяется при компиляции).
+     * @tparam Working Точность внутреннего метода.
+     * @tparam Residual Точность невязки и решения.
+     * @tparam Inner Внутренний метод.
+     */
+    template<typename Working, typename Residual, InnerSolver Inner = InnerSolver::LU>
+    class RefinementSolver {
+    public:
+        static_assert(std::is_floating_point_v<Working> && std::is_floating_point_v<Residual>,
+                      "Working and Residual must be floating point types.");
+        static_assert(Inner == InnerSolver::LU || std::is_same_v<Working, float>,
+                      "Jacobi and conjugate gradient inner solvers work in float only.");
+
+        /**
+         * @brief Результат уточнения.
+         */
+        struct Result {
+            /**
+             * Решение в точности Residual.
+             */
+            std::vector<Residual> x;
+
+            /**
+             * Количество шагов уточнения (решений системы для поправки).
+             */
+            size_t refinements = 0;
+
+            /**
+             * Суммарное количество итераций внутреннего метода (для LU - ноль).
+             */
+            size_t inner_iterations = 0;
+
+            /**
+             * Относительная невязка ||b - A x|| / ||b|| после каждого шага.
+             */
+            std::vector<double> residual_history;
+
+            /**
+             * Последняя относительная невязка.
+             */
+            double residual = 0.0;
+
+            /**
+             * True, если достигнута требуемая точность.
+             */
+            bool converged = false;
+
+            /**
+             * Причина остановки внутреннего метода на шаге, где он не сошёлся; уточнение на этом шаге прекращается,
+             * а его поправка не применяется. CONVERGED, если внутренний метод сходился на всех шагах (для LU - всегда).
+             */
+            SolverStatus inner_status = SolverStatus::CONVERGED;
+        };
+
+        /**
+         * @brief Конструктор. Для InnerSolver::LU раскладывает матрицу в точности Working.
+         * @details Матрица не копируется (кроме разложения), она должна жить дольше решателя.
+         * @details Бросает std::invalid_argument, если матрица вырождена.
+         * @param A Квадратная матрица коэффициентов.
+         */
+        explicit RefinementSolver(const matrix_library::Matrix &A) : A_(A), size_(A.get_row_count()) {
+            assert(A.get_row_count() == A.get_column_count());
+            if constexpr (Inner == InnerSolver::LU) {
+                const size_t n = size_;
+                factors_.resize(n * n);
+                pivots_.resize(n);
+                const float *a = A.get_data();
+                std::transform(a, a + n * n, factors_.begin(), [](float value) { return static_cast<Working>(value); });
+                if (!LUFactorization<Working>::factorize(factors_.data(), n, pivots_.data())) {
+                    throw std::invalid_argument("Matrix is singular.");
+                }
+            }
+        }
+
+        /**
+         * @brief Решить A x = b.
+         * @param b Вектор-столбец свободных членов.
+         * @param eps Требуемая относительная невязка. По умолчанию 100 eps(Residual).
+         * @param max_refinements Наибольшее количество шагов уточнения.
+         * @param inner_eps Относительная точность внутреннего метода (для Якоби и CG).
+         * @return Решение, количество шагов, история невязки и причина остановки внутреннего метода.
+         */
+        Result solve(const matrix_library::Matrix &b, double eps = 100.0 * std::numeric_limits<Residual>::epsilon(),
+                     size_t max_refinements = 30, double inner_eps = 1e-4) const {
+            assert(b.get_row_count() == size_ && b.get_column_count() == 1);
+            TRACE_SCOPE("refinement_solve");
+            const size_t n = size_;
+            const float *b_data = b.get_data();
+            Result result;
+            result.x.assign(n, Residual(0));
+            std::vector<Residual> residual(b_data, b_data + n);
+            std::vector<Working> correction_rhs(n);
+            std::vector<Working> correction(n);
+            const double b_norm = norm2(residual);
+            result.residual = b_norm > 0.0 ? 1.0 : 0.0;  // невязка начального приближения x = 0
+            double previous = std::numeric_limits<double>::infinity();
+            while (result.refinements < max_refinements) {
+                ++result.refinements;
+                std::transform(residual.begin(), residual.end(), correction_rhs.begin(),
+                               [](Residual value) { return static_cast<Working>(value); });
+                if (!solve_correction(correction_rhs, correction, inner_eps, result)) {
+                    break;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    result.x[i] += static_cast<Residual>(correction[i]);
+                }
+                compute_residual(b_data, result.x, residual);
+                double relative = b_norm > 0.0 ? norm2(residual) / b_norm : norm2(residual);
+                result.residual_history.push_back(relative);
+                result.residual = relative;
+                if (relative <= eps) {
+                    result.converged = true;
+                    break;
+                }
+                if (!(relative < 0.5 * previous)) {
+                    break;
+                }
+                previous = relative;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Решить СЛАУ, см. solve(b).
+         * @param system СЛАУ с одной правой частью.
+         * @return Решение, количество шагов, история невязки и причина остановки внутреннего метода.
+         */
+        static Result solve(const LinearSystem &system) {
+            RefinementSolver solver(system.get_A());
+            return solver.solve(system.get_b());
+        }
+
+        /**
+         * @brief Относительная невязка ||b - A x|| / ||b||, посчитанная в long double.
+         * @details Годится для сравнения решений любой точности между собой.
+         * @tparam T Тип элементов решения.
+         * @param A Матрица коэффициентов.
+         * @param b Вектор-столбец свободных членов.
+         * @param x Решение.
+         * @return Относительная невязка.
+         */
+        template<typename T>
+        static double relative_residual(const matrix_library::Matrix &A, const matrix_library::Matrix &b,
+                                        const std::vector<T> &x) {
+            const size_t n = A.get_row_count();
+            long double residual_norm = 0.0L;
+            long double b_norm = 0.0L;
+            for (size_t i = 0; i < n; ++i) {
+                const float *row = &A.get_element(i, 0);
+                long double sum = 0.0L;
+                for (size_t j = 0; j < n; ++j) {
+                    sum += static_cast<long double>(row[j]) * static_cast<long double>(x[j]);
+                }
+                long double difference = static_cast<long double>(b.get_element(i, 0)) - sum;
+                residual_norm += difference * difference;
+                b_norm += static_cast<long double>(b.get_element(i, 0)) * b.get_element(i, 0);
+            }
+            return static_cast<double>(std::sqrt(residual_norm / b_norm));
+        }
+
+    private:
+        /**
+         * @brief Евклидова норма вектора в double.
+         */
+        template<typename T>
+        static double norm2(const std::vector<T> &vector) {
+            const T *data = vector.data();
+            const size_t n = vector.size();
+            double sum = 0.0;
+#pragma omp parallel for simd schedule(static) default(none) shared(data, n) reduction(+:sum)
+            for (size_t i = 0; i < n; ++i) {
+                sum += static_cast<double>(data[i]) * static_cast<double>(data[i]);
+            }
+            return std::sqrt(sum);
+        }
+
+        /**
+         * @brief Невязка r = b - A x в точности Residual. Элементы A переводятся в Residual без потерь.
+         */
+        void compute_residual(const float *b, const std::vector<Residual> &x, std::vector<Residual> &residual) const {
+            TRACE_SCOPE("refinement_residual");
+            const size_t n = size_;
+            const Residual *x_data = x.data();
+            Residual *r = residual.data();
+            const matrix_library::Matrix &A = A_;
+#pragma omp parallel for schedule(static) default(none) shared(A, b, x_data, r, n)
+            for (size_t i = 0; i < n; ++i) {
+                const float *row = &A.get_element(i, 0);
+                Residual sum = 0;
+#pragma omp simd reduction(+:sum)
+                for (size_t j = 0; j < n; ++j) {
+                    sum += static_cast<Residual>(row[j]) * x_data[j];
+                }
+                r[i] = static_cast<Residual>(b[i]) - sum;
+            }
+        }
+
+        /**
+         * @brief Решить A d = r в точности Working выбранным методом.
+         * @details Добавляет итерации внутреннего метода в result.inner_iterations, а если он не сошёлся,
+         * @details записывает причину в result.inner_status.
+         * @return True, если поправка найдена.
+         */
+        bool solve_correction(const std::vector<Working> &rhs, std::vector<Working> &d, double inner_eps,
+                              Result &result) const {
+            TRACE_SCOPE("refinement_correction");
+            if constexpr (Inner == InnerSolver::LU) {
+                d = rhs;
+                LUFactorization<Working>::substitute(factors_.data(), pivots_.data(), size_, d.data());
+                return true;
+            } else {
+                /**
+                 * Правая часть нормируется на max |r[i] / A[i][i]| (первое приближение Якоби), чтобы поправка была
+                 * порядка единицы: поправки убывают от шага к шагу, а критерий Якоби при q < 1 абсолютный.
+                 * Так inner_eps остаётся относительной точностью для обоих методов.
+                 * Нулевой диагональный элемент не делит: иначе норма бесконечна, а поправка - NaN.
+                 */
+                double rhs_norm = 0.0;
+                for (size_t i = 0; i < size_; ++i) {
+                    const double diagonal = std::abs(static_cast<double>(A_.get_element(i, i)));
+                    rhs_norm = std::max(rhs_norm,
+                                        std::abs(static_cast<double>(rhs[i])) / (diagonal > 0.0 ? diagonal : 1.0));
+                }
+                if (rhs_norm == 0.0) {
+                    std::fill(d.begin(), d.end(), 0.0f);
+                    return true;
+                }
+                matrix_library::Matrix b(size_, 1);
+                std::transform(rhs.begin(), rhs.end(), b.get_data(),
+                               [rhs_norm](float value) { return static_cast<float>(value / rhs_norm); });
+                SolverOptions options;
+                options.eps = static_cast<float>(inner_eps);
+                SolverResult inner = Inner == InnerSolver::JACOBI ?
+                                     JacobiSolver::solve_matrix_free(A_, b, options) :
+                                     ConjugateGradientSolver::solve(A_, b, options);
+                result.inner_iterations += inner.iterations;
+                if (!inner.converged()) {
+                    result.inner_status = inner.status;
+                    return false;
+                }
+                const float *solution_data = inner.x.get_data();
+                std::transform(solution_data, solution_data + size_, d.begin(),
+                               [rhs_norm](float value) { return static_cast<float>(value * rhs_norm); });
+                return true;
+            }
+        }
+
+        const matrix_library::Matrix &A_;
+        size_t size_;
+        std::vector<Working> factors_;
+        std::vector<size_t> pivots_;
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_REFINEMENTSOLVER_H
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SORSolver.h"
+#include "Tracing.h"
+
+namespace linear_systems_library {
+
+    SolverResult SORSolver::solve(const linear_systems_library::LinearSystem &system, const SolverOptions &options,
+                                  float relaxation_factor, Ordering ordering) {
+        /**
+         * Об алгоритме: https://en.wikipedia.org/wiki/Successive_over-relaxation
+         * Шаг метода Гаусса-Зейделя умножается на параметр релаксации w: при w > 1 итерации "перескакивают"
+         * в сторону решения, и при удачном w их нужно на порядок меньше.
+         */
+        if (relaxation_factor == 0.0f) {
+            relaxation_factor = estimate_relaxation_factor(system);
+        }
+        return GaussSeidelSolver::iterate(system, options, relaxation_factor, ordering, "sor_iterations");
+    }
+
+    float SORSolver::estimate_relaxation_factor(const linear_systems_library::LinearSystem &system) {
+        TRACE_SCOPE("sor_relaxation_factor");
+        float rho = estimate_jacobi_spectral_radius(system.get_A());
+        if (rho >= 1.0f) {
+            return 1.0f;  // метод Якоби расходится, формула неприменима
+        }
+        return 2.0f / (1.0f + std::sqrt(1.0f - rho * rho));
+    }
+
+    float SORSolver::estimate_jacobi_spectral_radius(const matrix_library::Matrix &A, size_t max_iterations) {
+        assert(A.get_row_count() == A.get_column_count());
+        const size_t matrix_size = A.get_row_count();
+
+        /**
+         * Начальный вектор непостоянный, чтобы не оказаться ортогональным главному собственному вектору
+         * у матриц с симметричной структурой.
+         */
+        matrix_library::Matrix v_first(matrix_size, 1);
+        matrix_library::Matrix v_second(matrix_size, 1);
+        float *v = v_first.get_data();
+        float *v_next = v_second.get_data();
+        for (size_t i = 0; i < matrix_size; ++i) {
+            v[i] = 1.0f + 0.5f * std::sin(static_cast<float>(i));
+        }
+        float norm = 0.0f;
+        for (size_t i = 0; i < matrix_size; ++i) {
+            norm = std::max(norm, std::abs(v[i]));
+        }
+
+        float rho = 0.0f;
+        for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+            float next_norm = 0.0f;
+#pragma omp parallel for schedule(static) default(none) shared(A, v, v_next, matrix_size, norm) reduction(max:next_norm)
+            for (size_t i = 0; i < matrix_size; ++i) {
+                const float *a_row = &A.get_element(i, 0);
+                float sum = 0.0f;
+#pragma omp simd reduction(+:sum)
+                for (size_t j = 0; j < matrix_size; ++j) {
+                    sum += a_row[j] * v[j];
+                }
+                float value = -(sum - a_row[i] * v[i]) / a_row[i] / norm;
+                v_next[i] = value;
+                next_norm = std::max(next_norm, std::abs(value));
+            }
+            std::swap(v, v_next);
+
+            /**
+             * v нормирован на предыдущем шаге, поэтому новая норма и есть оценка |lambda_max|.
+             */
+            float previous_rho = rho;
+            rho = next_norm;
+            norm = next_norm;
+            if (norm == 0.0f || std::abs(rho - previous_rho) <= 1e-3f * rho) {
+                break;
+            }
+        }
+        return rho;
+    }
+}
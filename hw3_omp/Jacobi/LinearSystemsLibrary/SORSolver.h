@@ -0,0 +1,47 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_SORSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_SORSOLVER_H
+
+#include <omp.h>
+
+#include "GaussSeidelSolver.h"
+#include "LinearSystem.h"
+#include "Matrix.h"
+
+namespace linear_systems_library {
+    class SORSolver {
+    public:
+        /**
+         * @brief Решить СЛАУ методом верхней релаксации (SOR). Используется OMP.
+         * @details Обход неизвестных и критерий остановки такие же, как в GaussSeidelSolver.
+         * @param system СЛАУ.
+         * @param options Точность и условия аварийной остановки.
+         * @param relaxation_factor Параметр релаксации из (0, 2). Если ноль, подбирается estimate_relaxation_factor.
+         * @param ordering Порядок обхода неизвестных.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        static SolverResult solve(const linear_systems_library::LinearSystem &system,
+                                  const SolverOptions &options = SolverOptions(), float relaxation_factor = 0.0f,
+                                  Ordering ordering = Ordering::RED_BLACK);
+
+        /**
+         * @brief Подобрать параметр релаксации по формуле Юнга: w = 2 / (1 + sqrt(1 - rho^2)),
+         * @brief где rho - спектральный радиус матрицы перехода метода Якоби.
+         * @details Формула оптимальна для согласованно упорядоченных матриц (например, красно-чёрный
+         * @details порядок разностных схем), для остальных это разумное начальное приближение.
+         * @param system СЛАУ.
+         * @return Параметр релаксации из [1, 2).
+         */
+        static float estimate_relaxation_factor(const linear_systems_library::LinearSystem &system);
+
+        /**
+         * @brief Оценить спектральный радиус матрицы перехода метода Якоби B = E - D^-1 * A степенным методом.
+         * @details B не строится: v_new[i] = -(sum_{j!=i} A[i][j] * v[j]) / A[i][i].
+         * @param A Матрица коэффициентов.
+         * @param max_iterations Наибольшее количество шагов степенного метода.
+         * @return Оценка спектрального радиуса.
+         */
+        static float estimate_jacobi_spectral_radius(const matrix_library::Matrix &A, size_t max_iterations = 50);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_SORSOLVER_H
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "SolverMonitor.h"
+
+namespace linear_systems_library {
+
+    const char *to_string(SolverStatus status) {
+        switch (status) {
+            case SolverStatus::CONVERGED:
+                return "converged";
+            case SolverStatus::MAX_ITERATIONS:
+                return "max iterations";
+            case SolverStatus::TIME_LIMIT:
+                return "time limit";
+            case SolverStatus::STAGNATION:
+                return "stagnation";
+            case SolverStatus::DIVERGENCE:
+                return "divergence";
+            case SolverStatus::STOPPED:
+                return "stopped";
+            case SolverStatus::BREAKDOWN:
+                return "breakdown";
+        }
+        return "unknown";
+    }
+
+    bool SolverResult::converged() const {
+        return status == SolverStatus::CONVERGED;
+    }
+
+    SolverMonitor::SolverMonitor(const SolverOptions &options, size_t size, double b_norm) :
+            options_(options),
+            max_iterations_(options.max_iterations > 0 ? options.max_iterations : std::max<size_t>(1000, 10 * size)),
+            b_norm_(b_norm > 0.0 ? b_norm : 1.0),
+            start_(Clock::now()),
+            iterations_start_(start_),
+            best_residual_(std::numeric_limits<double>::infinity()) {
+        assert(options.check_period > 0);
+        assert(options.steps_per_check > 0);
+    }
+
+    void SolverMonitor::finish_setup() {
+        iterations_start_ = Clock::now();
+    }
+
+    bool SolverMonitor::is_check_iteration(size_t iteration) const {
+        return iteration % (options_.check_period * options_.steps_per_check) == 0;
+    }
+
+    bool SolverMonitor::is_residual_small(double residual_norm) const {
+        return residual_norm <= options_.eps * b_norm_;
+    }
+
+    std::optional<SolverStatus> SolverMonitor::check_residual(size_t iteration, double residual_norm) {
+        double relative_residual = residual_norm / b_norm_;
+        residual_history_.push_back(relative_residual);
+        if (options_.residual_callback && !options_.residual_callback(iteration, relative_residual)) {
+            return SolverStatus::STOPPED;
+        }
+        if (!std::isfinite(relative_residual) || relative_residual > options_.divergence_factor) {
+            return SolverStatus::DIVERGENCE;
+        }
+        if (relative_residual < best_residual_) {
+            best_residual_ = relative_residual;
+            checks_since_best_ = 0;
+        } else if (options_.stagnation_checks > 0 && ++checks_since_best_ >= options_.stagnation_checks) {
+            return SolverStatus::STAGNATION;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<SolverStatus> SolverMonitor::check_limits(size_t iteration) const {
+        if (iteration >= max_iterations_) {
+            return SolverStatus::MAX_ITERATIONS;
+        }
+        if (options_.time_limit > 0.0 &&
+            std::chrono::duration<double>(Clock::now() - iterations_start_).count() >= options_.time_limit) {
+            return SolverStatus::TIME_LIMIT;
+        }
+        return std::nullopt;
+    }
+
+    SolverStatus SolverMonitor::fail(double residual_norm, SolverStatus status) {
+        residual_history_.push_back(residual_norm / b_norm_);
+        return status;
+    }
+
+    SolverResult SolverMonitor::make_result(matrix_library::Matrix x, size_t iterations, SolverStatus status) {
+        SolverResult result;
+        result.x = std::move(x);
+        result.status = status;
+        result.iterations = iterations;
+        result.residual = residual_history_.empty() ? 0.0 : residual_history_.back();
+        result.residual_history = std::move(residual_history_);
+        result.setup_time = std::chrono::duration<double>(iterations_start_ - start_).count();
+        result.iterations_time = std::chrono::duration<double>(Clock::now() - iterations_start_).count();
+        return result;
+    }
+}
@@ -0,0 +1,236 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_SOLVERMONITOR_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_SOLVERMONITOR_H
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "Matrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Причина остановки итерационного метода.
+     */
+    enum class SolverStatus {
+        CONVERGED,  // достигнута требуемая точность
+        MAX_ITERATIONS,  // исчерпан лимит итераций
+        TIME_LIMIT,  // исчерпан лимит времени
+        STAGNATION,  // невязка давно не уменьшается
+        DIVERGENCE,  // невязка выросла во много раз или перестала быть конечной
+        STOPPED,  // остановлено обработчиком невязки
+        BREAKDOWN  // метод вырождается: знаменатель шага нулевой, не того знака или не конечен
+    };
+
+    /**
+     * @brief Получить название причины остановки.
+     * @param status Причина остановки.
+     * @return Название в нижнем регистре, например "converged".
+     */
+    const char *to_string(SolverStatus status);
+
+    /**
+     * @brief Параметры итерационного метода: точность и условия аварийной остановки.
+     */
+    struct SolverOptions {
+        /**
+         * Требуемая точность.
+         */
+        float eps = 1e-5f;
+
+        /**
+         * Наибольшее количество итераций. Ноль - max(1000, 10 * n).
+         */
+        size_t max_iterations = 0;
+
+        /**
+         * Лимит времени на итерации в секундах. Ноль - без лимита.
+         */
+        double time_limit = 0.0;
+
+        /**
+         * Невязка оценивается раз в столько итераций.
+         */
+        size_t check_period = 10;
+
+        /**
+         * Критерий сходимости проверяется раз в столько итераций (s-step). Между проверками итерации идут
+         * без глобальных редукций. Монитор тогда вызывается только на итерациях, кратных steps_per_check,
+         * и невязка оценивается на каждой check_period-й из них.
+         */
+        size_t steps_per_check = 1;
+
+        /**
+         * Застой - столько проверок подряд без нового минимума невязки. Ноль - не проверять.
+         */
+        size_t stagnation_checks = 50;
+
+        /**
+         * Расходимость - невязка больше начальной во столько раз. Начальное приближение нулевое, начальная невязка - b.
+         */
+        double divergence_factor = 1e4;
+
+        /**
+         * Вызывается на каждой проверке с номером итерации и относительной невязкой ||b - A x|| / ||b||.
+         * Если вернёт false, итерации останавливаются со статусом STOPPED.
+         */
+        std::function<bool(size_t, double)> residual_callback;
+    };
+
+    /**
+     * @brief Результат итерационного метода.
+     */
+    struct SolverResult {
+        /**
+         * Последнее приближение - решение, если status == CONVERGED.
+         */
+        matrix_library::Matrix x;
+
+        /**
+         * Причина остановки.
+         */
+        SolverStatus status = SolverStatus::CONVERGED;
+
+        /**
+         * Количество выполненных итераций.
+         */
+        size_t iterations = 0;
+
+        /**
+         * Последняя оценка относительной невязки ||b - A x|| / ||b||.
+         */
+        double residual = 0.0;
+
+        /**
+         * Оценки относительной невязки на всех проверках.
+         */
+        std::vector<double> residual_history;
+
+        /**
+         * Время подготовки (построение матриц, раскраска и т.п.) в секундах.
+         */
+        double setup_time = 0.0;
+
+        /**
+         * Время итераций в секундах.
+         */
+        double iterations_time = 0.0;
+
+        /**
+         * @brief Проверить, сошёлся ли метод.
+         * @return True, если достигнута требуемая точность.
+         */
+        bool converged() const;
+    };
+
+    /**
+     * @brief Следит за итерациями: лимиты итераций и времени, история невязки, застой и расходимость.
+     * @details Сам критерий сходимости остаётся за методом (у метода Якоби при q < 1 - по разности итераций),
+     * @details монитор только решает, когда пора остановиться аварийно, и собирает SolverResult.
+     * @details Невязку метод оценивает сам раз в check_period итераций - у стационарных методов она
+     * @details получается из шага итерации за O(n): b - A x = D (x_new - x).
+     */
+    class SolverMonitor {
+    public:
+        /**
+         * @brief Конструктор. Начинает отсчёт времени подготовки.
+         * @param options Параметры метода.
+         * @param size Размер системы.
+         * @param b_norm Евклидова норма правой части.
+         */
+        SolverMonitor(const SolverOptions &options, size_t size, double b_norm);
+
+        /**
+         * @brief Отметить конец подготовки и начало итераций.
+         */
+        void finish_setup();
+
+        /**
+         * @brief Нужно ли на этой итерации оценить невязку.
+         * @param iteration Номер итерации, начиная с 1.
+         * @return True раз в check_period * steps_per_check итераций.
+         */
+        bool is_check_iteration(size_t iteration) const;
+
+        /**
+         * @brief Проверить критерий сходимости по невязке ||b - A x|| <= eps * ||b||.
+         * @param residual_norm Евклидова норма невязки.
+         * @return True, если точность достигнута.
+         */
+        bool is_residual_small(double residual_norm) const;
+
+        /**
+         * @brief Записать оценку невязки, проверить расходимость и застой, вызвать обработчик.
+         * @param iteration Номер итерации.
+         * @param residual_norm Евклидова норма невязки.
+         * @return Причина аварийной остановки или std::nullopt, если можно продолжать.
+         */
+        std::optional<SolverStatus> check_residual(size_t iteration, double residual_norm);
+
+        /**
+         * @brief Проверить лимиты итераций и времени. Дёшево, можно звать на каждой итерации.
+         * @param iteration Номер итерации.
+         * @return Причина аварийной остановки или std::nullopt, если можно продолжать.
+         */
+        std::optional<SolverStatus> check_limits(size_t iteration) const;
+
+        /**
+         * @brief Остановить метод аварийно вне проверки (вырождение, не конечная невязка): записать невязку в историю.
+         * @param residual_norm Евклидова норма невязки текущего приближения.
+         * @param status Причина остановки.
+         * @return status.
+         */
+        SolverStatus fail(double residual_norm, SolverStatus status);
+
+        /**
+         * @brief Подвести итог итерации: сходимость, оценка невязки (на проверках и при сходимости) и лимиты.
+         * @tparam ResidualNorm Функция без аргументов, возвращающая евклидову норму невязки.
+         * @param iteration Номер итерации.
+         * @param converged Выполнен ли критерий сходимости самого метода.
+         * @param residual_criterion Считать ли сходимостью ||b - A x|| <= eps * ||b|| на проверках.
+         * @param residual_norm Оценка нормы невязки. Вызывается, только если нужна.
+         * @return Причина остановки или std::nullopt, если можно продолжать.
+         */
+        template<typename ResidualNorm>
+        std::optional<SolverStatus> finish_iteration(size_t iteration, bool converged, bool residual_criterion,
+                                                     ResidualNorm residual_norm) {
+            std::optional<SolverStatus> status;
+            if (converged || is_check_iteration(iteration)) {
+                double norm = residual_norm();
+                converged = converged || (residual_criterion && is_residual_small(norm));
+                status = check_residual(iteration, norm);
+            }
+            if (converged) {
+                return SolverStatus::CONVERGED;
+            }
+            if (status) {
+                return status;
+            }
+            return check_limits(iteration);
+        }
+
+        /**
+         * @brief Собрать результат.
+         * @param x Последнее приближение.
+         * @param iterations Количество выполненных итераций.
+         * @param status Причина остановки.
+         * @return Результат метода.
+         */
+        SolverResult make_result(matrix_library::Matrix x, size_t iterations, SolverStatus status);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        SolverOptions options_;
+        size_t max_iterations_;
+        double b_norm_;
+        Clock::time_point start_;
+        Clock::time_point iterations_start_;
+        std::vector<double> residual_history_;
+        double best_residual_;
+        size_t checks_since_best_{0};
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_SOLVERMONITOR_H
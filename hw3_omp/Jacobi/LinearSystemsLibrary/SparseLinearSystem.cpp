@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+
+#include "SparseLinearSystem.h"
+#include "SplitMix.h"
+
+namespace linear_systems_library {
+
+    namespace {
+
+        using benchmark_library::splitmix64;
+        using benchmark_library::uniform;
+
+        /**
+         * @brief Ключи генераторов матрицы и решения, выведенные из зерна, как в LinearSystem.
+         */
+        struct GeneratorKeys {
+            uint64_t A_key;
+            uint64_t x_key;
+
+            explicit GeneratorKeys(std::optional<uint64_t> seed) :
+                    A_key(splitmix64(seed ? seed.value() : (uint64_t(std::random_device()()) << 32) ^ std::random_device()())),
+                    x_key(splitmix64(A_key)) {}
+        };
+    }
+
+    SparseLinearSystem::SparseLinearSystem(SparseMatrix A, uint64_t x_key) :
+            A_(std::move(A)),
+            b_(A_.get_row_count(), 1),
+            x_(A_.get_column_count(), 1) {
+        const size_t size = x_.get_row_count();
+        float *x_data = x_.get_data();
+#pragma omp parallel for schedule(static) default(none) shared(size, x_data, x_key)
+        for (size_t i = 0; i < size; ++i) {
+            x_data[i] = uniform(x_key, i);
+        }
+        A_.multiply(x_.get_data(), b_.get_data());
+    }
+
+    SparseLinearSystem SparseLinearSystem::poisson_1d(size_t size, std::optional<uint64_t> seed) {
+        return SparseLinearSystem(build_poisson({size}), GeneratorKeys(seed).x_key);
+    }
+
+    SparseLinearSystem SparseLinearSystem::poisson_2d(size_t side, std::optional<uint64_t> seed) {
+        return SparseLinearSystem(build_poisson({side, side}), GeneratorKeys(seed).x_key);
+    }
+
+    SparseLinearSystem SparseLinearSystem::poisson_3d(size_t side, std::optional<uint64_t> seed) {
+        return SparseLinearSystem(build_poisson({side, side, side}), GeneratorKeys(seed).x_key);
+    }
+
+    SparseLinearSystem SparseLinearSystem::stencil_27_point(size_t side, std::optional<uint64_t> seed) {
+        return SparseLinearSystem(build_box_stencil(side), GeneratorKeys(seed).x_key);
+    }
+
+    SparseLinearSystem SparseLinearSystem::random_diagonally_dominant(size_t size, size_t nonzeros_per_row,
+                                                                      std::optional<uint64_t> seed) {
+        assert(nonzeros_per_row >= 1 && nonzeros_per_row <= size);
+        const GeneratorKeys keys(seed);
+        const uint64_t A_key = keys.A_key;
+        std::vector<size_t> row_offsets(size + 1);
+        for (size_t i = 0; i <= size; ++i) {
+            row_offsets[i] = i * nonzeros_per_row;
+        }
+        std::vector<uint32_t> column_indices(size * nonzeros_per_row);
+        std::vector<float> values(size * nonzeros_per_row);
+
+        /**
+         * У каждой строки свой поток чисел с ключом splitmix64(A_key + i): столбцы выбираются из него с отбрасыванием
+         * повторов, затем из него же берутся значения. Строка зависит только от seed и своего номера.
+         */
+#pragma omp parallel for schedule(static) default(none) shared(size, nonzeros_per_row, column_indices, values, A_key)
+        for (size_t i = 0; i < size; ++i) {
+            const uint64_t row_key = splitmix64(A_key + i);
+            uint64_t counter = 0;
+            uint32_t *columns = column_indices.data() + i * nonzeros_per_row;
+            columns[0] = static_cast<uint32_t>(i);
+            for (size_t k = 1; k < nonzeros_per_row; ++k) {
+                uint32_t column;
+                do {
+                    // старшие 32 бита, умноженные на size, - номер столбца из [0, size) без деления
+                    column = static_cast<uint32_t>(((splitmix64(row_key + counter++) >> 32) * size) >> 32);
+                } while (std::find(columns, columns + k, column) != columns + k);
+                columns[k] = column;
+            }
+            std::sort(columns, columns + nonzeros_per_row);
+
+            float *row_values = values.data() + i * nonzeros_per_row;
+            float sum = 0.0f;
+            size_t diagonal = 0;
+            for (size_t k = 0; k < nonzeros_per_row; ++k) {
+                if (columns[k] == i) {
+                    diagonal = k;
+                    continue;
+                }
+                row_values[k] = uniform(row_key, counter++);
+                sum += row_values[k];
+            }
+            row_values[diagonal] = nonzeros_per_row > 1 ? 2.0f * sum : 1.0f;
+        }
+
+        return SparseLinearSystem(SparseMatrix(size, size, std::move(row_offsets), std::move(column_indices),
+                                               std::move(values)), keys.x_key);
+    }
+
+    SparseLinearSystem SparseLinearSystem::create(const std::string &kind, size_t size, std::optional<uint64_t> seed) {
+        if (kind == "poisson1d") {
+            return poisson_1d(size, seed);
+        }
+        if (kind == "poisson2d") {
+            return poisson_2d(size, seed);
+        }
+        if (kind == "poisson3d") {
+            return poisson_3d(size, seed);
+        }
+        if (kind == "stencil27") {
+            return stencil_27_point(size, seed);
+        }
+        if (kind == "random") {
+            return random_diagonally_dominant(size, 7, seed);
+        }
+        throw std::invalid_argument("Unknown sparse system: " + kind +
+                                    ". Use poisson1d, poisson2d, poisson3d, stencil27 or random.");
+    }
+
+    const SparseMatrix &SparseLinearSystem::get_A() const {
+        return A_;
+    }
+
+    const matrix_library::Matrix &SparseLinearSystem::get_b() const {
+        return b_;
+    }
+
+    const matrix_library::Matrix &SparseLinearSystem::get_x() const {
+        return x_;
+    }
+
+    bool SparseLinearSystem::has_solving() const {
+        return true;
+    }
+
+    SparseMatrix SparseLinearSystem::build_poisson(const std::vector<size_t> &sides) {
+        const size_t dimensions = sides.size();
+        std::vector<size_t> strides(dimensions);
+        size_t size = 1;
+        for (size_t d = 0; d < dimensions; ++d) {
+            strides[d] = size;
+            size *= sides[d];
+        }
+
+        /**
+         * Узел i с координатами c_d = (i / strides[d]) % sides[d]. Соседи i -/+ strides[d] существуют,
+         * если c_d > 0 и c_d + 1 < sides[d]. Сначала считаются длины строк, затем, по префиксным суммам, сами строки.
+         * Столбцы в строке упорядочены: i - strides[d] по убыванию d, i, затем i + strides[d] по возрастанию d.
+         */
+        const size_t *sides_data = sides.data();
+        const size_t *strides_data = strides.data();
+        std::vector<size_t> row_offsets(size + 1, 0);
+        size_t *offsets = row_offsets.data();
+#pragma omp parallel for schedule(static) default(none) shared(size, dimensions, sides_data, strides_data, offsets)
+        for (size_t i = 0; i < size; ++i) {
+            size_t count = 1;
+            for (size_t d = 0; d < dimensions; ++d) {
+                size_t coordinate = (i / strides_data[d]) % sides_data[d];
+                count += (coordinate > 0 ? 1 : 0) + (coordinate + 1 < sides_data[d] ? 1 : 0);
+            }
+            offsets[i + 1] = count;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        std::vector<uint32_t> column_indices(offsets[size]);
+        std::vector<float> values(offsets[size]);
+        uint32_t *columns = column_indices.data();
+        float *entries = values.data();
+        const auto diagonal_value = static_cast<float>(2 * dimensions);
+#pragma omp parallel for schedule(static) default(none) \
+        shared(size, dimensions, sides_data, strides_data, offsets, columns, entries, diagonal_value)
+        for (size_t i = 0; i < size; ++i) {
+            size_t position = offsets[i];
+            for (size_t d = dimensions; d-- > 0;) {
+                if ((i / strides_data[d]) % sides_data[d] > 0) {
+                    columns[position] = static_cast<uint32_t>(i - strides_data[d]);
+                    entries[position++] = -1.0f;
+                }
+            }
+            columns[position] = static_cast<uint32_t>(i);
+            entries[position++] = diagonal_value;
+            for (size_t d = 0; d < dimensions; ++d) {
+                if ((i / strides_data[d]) % sides_data[d] + 1 < sides_data[d]) {
+                    columns[position] = static_cast<uint32_t>(i + strides_data[d]);
+                    entries[position++] = -1.0f;
+                }
+            }
+        }
+
+        return SparseMatrix(size, size, std::move(row_offsets), std::move(column_indices), std::move(values));
+    }
+
+    SparseMatrix SparseLinearSystem::build_box_stencil(size_t side) {
+        const size_t size = side * side * side;
+
+        /**
+         * Соседи узла (x, y, z) - узлы (x + dx, y + dy, z + dz), dx, dy, dz из {-1, 0, 1}, внутри куба.
+         * При обходе dz, dy, dx по возрастанию номера столбцов тоже возрастают.
+         */
+        std::vector<size_t> row_offsets(size + 1, 0);
+        size_t *offsets = row_offsets.data();
+#pragma omp parallel for schedule(static) default(none) shared(size, side, offsets)
+        for (size_t i = 0; i < size; ++i) {
+            size_t count = 1;
+            for (size_t coordinate: {i % side, (i / side) % side, i / (side * side)}) {
+                count *= 1 + (coordinate > 0 ? 1 : 0) + (coordinate + 1 < side ? 1 : 0);
+            }
+            offsets[i + 1] = count;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        std::vector<uint32_t> column_indices(offsets[size]);
+        std::vector<float> values(offsets[size]);
+        uint32_t *columns = column_indices.data();
+        float *entries = values.data();
+        const auto signed_side = static_cast<long long>(side);
+#pragma omp parallel for schedule(static) default(none) shared(size, side, signed_side, offsets, columns, entries)
+        for (size_t i = 0; i < size; ++i) {
+            const auto x = static_cast<long long>(i % side);
+            const auto y = static_cast<long long>((i / side) % side);
+            const auto z = static_cast<long long>(i / (side * side));
+            size_t position = offsets[i];
+            for (long long dz = -1; dz <= 1; ++dz) {
+                for (long long dy = -1; dy <= 1; ++dy) {
+                    for (long long dx = -1; dx <= 1; ++dx) {
+                        long long nx = x + dx;
+                        long long ny = y + dy;
+                        long long nz = z + dz;
+                        if (nx < 0 || ny < 0 || nz < 0 || nx >= signed_side || ny >= signed_side || nz >= signed_side) {
+                            continue;
+                        }
+                        columns[position] = static_cast<uint32_t>(nx + signed_side * (ny + signed_side * nz));
+                        entries[position++] = (dx == 0 && dy == 0 && dz == 0) ? 26.0f : -1.0f;
+                    }
+                }
+            }
+        }
+
+        return SparseMatrix(size, size, std::move(row_offsets), std::move(column_indices), std::move(values));
+    }
+}
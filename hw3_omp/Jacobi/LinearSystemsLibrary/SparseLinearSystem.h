@@ -0,0 +1,129 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPARSELINEARSYSTEM_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPARSELINEARSYSTEM_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Matrix.h"
+#include "SparseMatrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Система линейных уравнений с разреженной матрицей коэффициентов.
+     * @details Интерфейс как у LinearSystem. Решение x выбирается случайно, b = A x, поэтому решение сразу известно.
+     * @details Генераторы счётные, как у LinearSystem: при одном seed система одна и та же при любом количестве потоков.
+     * @details Создаётся генераторами: разностные операторы Лапласа на 1D/2D/3D сетках и случайные
+     * @details разреженные матрицы с диагональным преобладанием.
+     */
+    class SparseLinearSystem {
+    public:
+        /**
+         * @brief Оператор -u'' на отрезке, 3-точечный шаблон (2, -1, -1), граничные условия Дирихле.
+         * @param size Количество внутренних узлов сетки.
+         * @param seed Зерно генератора решения. Если не задано, берётся из std::random_device.
+         * @return СЛАУ размера size.
+         */
+        static SparseLinearSystem poisson_1d(size_t size, std::optional<uint64_t> seed=std::nullopt);
+
+        /**
+         * @brief Оператор Лапласа на квадрате, 5-точечный шаблон (4, -1 x 4), граничные условия Дирихле.
+         * @param side Количество внутренних узлов по каждой стороне.
+         * @param seed Зерно генератора решения. Если не задано, берётся из std::random_device.
+         * @return СЛАУ размера side^2.
+         */
+        static SparseLinearSystem poisson_2d(size_t side, std::optional<uint64_t> seed=std::nullopt);
+
+        /**
+         * @brief Оператор Лапласа на кубе, 7-точечный шаблон (6, -1 x 6), граничные условия Дирихле.
+         * @param side Количество внутренних узлов по каждой стороне.
+         * @param seed Зерно генератора решения. Если не задано, берётся из std::random_device.
+         * @return СЛАУ размера side^3.
+         */
+        static SparseLinearSystem poisson_3d(size_t side, std::optional<uint64_t> seed=std::nullopt);
+
+        /**
+         * @brief 27-точечный шаблон на кубе, как в бенчмарке HPCG: 26 на диагонали и -1 для всех соседей в кубе 3 x 3 x 3.
+         * @param side Количество внутренних узлов по каждой стороне.
+         * @param seed Зерно генератора решения. Если не задано, берётся из std::random_device.
+         * @return СЛАУ размера side^3.
+         */
+        static SparseLinearSystem stencil_27_point(size_t side, std::optional<uint64_t> seed=std::nullopt);
+
+        /**
+         * @brief Случайная разреженная матрица со строгим диагональным преобладанием.
+         * @details Внедиагональные элементы из [0, 1) в случайных различных столбцах,
+         * @details диагональный - удвоенная сумма остальных в строке, как в LinearSystem.
+         * @param size Размер системы.
+         * @param nonzeros_per_row Количество ненулевых элементов в строке, включая диагональный.
+         * @param seed Зерно генератора матрицы и решения. Если не задано, берётся из std::random_device.
+         * @return СЛАУ размера size.
+         */
+        static SparseLinearSystem random_diagonally_dominant(size_t size, size_t nonzeros_per_row = 7,
+                                                             std::optional<uint64_t> seed=std::nullopt);
+
+        /**
+         * @brief Создать систему по названию генератора.
+         * @details Бросает std::invalid_argument, если вид системы неизвестен.
+         * @param kind Вид системы: poisson1d, poisson2d, poisson3d, stencil27 или random.
+         * @param size Количество неизвестных (для poisson2d, poisson3d и stencil27 - узлов по стороне сетки).
+         * @param seed Зерно генератора. Если не задано, берётся из std::random_device.
+         * @return СЛАУ.
+         */
+        static SparseLinearSystem create(const std::string &kind, size_t size, std::optional<uint64_t> seed=std::nullopt);
+
+        /**
+         * @brief Получить матрицу коэффициентов.
+         * @return Матрица коэффициентов. Неизменяемая ссылка.
+         */
+        const SparseMatrix &get_A() const;
+
+        /**
+         * @brief Получить вектор-столбец свободных членов.
+         * @return Свободные члены. Неизменяемая ссылка.
+         */
+        const matrix_library::Matrix &get_b() const;
+
+        /**
+         * @brief Получить решение системы.
+         * @return Решение системы. Вектор-столбец. Неизменяемая ссылка.
+         */
+        const matrix_library::Matrix &get_x() const;
+
+        /**
+         * @brief Проверить, известно ли решение системы.
+         * @return True, если решение известно.
+         */
+        bool has_solving() const;
+
+    private:
+        /**
+         * @brief Конструктор. Выбирает случайное решение и считает b = A x.
+         * @param A Матрица коэффициентов.
+         * @param x_key Ключ счётного генератора решения.
+         */
+        SparseLinearSystem(SparseMatrix A, uint64_t x_key);
+
+        /**
+         * @brief Разностный оператор Лапласа на прямоугольной сетке любой размерности.
+         * @param sides Количество внутренних узлов по каждому измерению, первое измерение меняется быстрее всего.
+         * @return Матрица (2 * d) на диагонали и -1 для каждого соседа по сетке.
+         */
+        static SparseMatrix build_poisson(const std::vector<size_t> &sides);
+
+        /**
+         * @brief Матрица 27-точечного шаблона на кубической сетке.
+         * @param side Количество внутренних узлов по каждой стороне.
+         * @return Матрица 26 на диагонали и -1 для каждого соседа в кубе 3 x 3 x 3.
+         */
+        static SparseMatrix build_box_stencil(size_t side);
+
+        SparseMatrix A_;
+        matrix_library::Matrix b_;
+        matrix_library::Matrix x_;
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPARSELINEARSYSTEM_H
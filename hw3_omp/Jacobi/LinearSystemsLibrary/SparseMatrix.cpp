@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "SparseMatrix.h"
+
+namespace linear_systems_library {
+
+    SparseMatrix::SparseMatrix(size_t row_count, size_t column_count, std::vector<size_t> row_offsets,
+                               std::vector<uint32_t> column_indices, std::vector<float> values) :
+            row_count_(row_count),
+            column_count_(column_count),
+            row_offsets_(std::move(row_offsets)),
+            column_indices_(std::move(column_indices)),
+            values_(std::move(values)) {
+        assert(column_count_ <= static_cast<size_t>(std::numeric_limits<uint32_t>::max()) + 1);
+        assert(row_offsets_.size() == row_count_ + 1);
+        assert(row_offsets_.back() == values_.size());
+        assert(column_indices_.size() == values_.size());
+    }
+
+    size_t SparseMatrix::get_row_count() const {
+        return row_count_;
+    }
+
+    size_t SparseMatrix::get_column_count() const {
+        return column_count_;
+    }
+
+    size_t SparseMatrix::get_nonzero_count() const {
+        return values_.size();
+    }
+
+    size_t SparseMatrix::get_memory_size() const {
+        return row_offsets_.size() * sizeof(size_t) + column_indices_.size() * sizeof(uint32_t) +
+               values_.size() * sizeof(float);
+    }
+
+    const std::vector<size_t> &SparseMatrix::get_row_offsets() const {
+        return row_offsets_;
+    }
+
+    const std::vector<uint32_t> &SparseMatrix::get_column_indices() const {
+        return column_indices_;
+    }
+
+    const std::vector<float> &SparseMatrix::get_values() const {
+        return values_;
+    }
+
+    float SparseMatrix::get_element(size_t row_index, size_t column_index) const {
+        assert(row_index < row_count_ && column_index < column_count_);
+        auto begin = column_indices_.begin() + static_cast<ptrdiff_t>(row_offsets_[row_index]);
+        auto end = column_indices_.begin() + static_cast<ptrdiff_t>(row_offsets_[row_index + 1]);
+        auto position = std::lower_bound(begin, end, static_cast<uint32_t>(column_index));
+        if (position == end || *position != column_index) {
+            return 0.0f;
+        }
+        return values_[static_cast<size_t>(position - column_indices_.begin())];
+    }
+
+    void SparseMatrix::multiply(const float *x, float *y) const {
+        const size_t *offsets = row_offsets_.data();
+        const uint32_t *columns = column_indices_.data();
+        const float *values = values_.data();
+        const size_t row_count = row_count_;
+#pragma omp parallel for schedule(static) default(none) shared(row_count, offsets, columns, values, x, y)
+        for (size_t i = 0; i < row_count; ++i) {
+            float sum = 0.0f;
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                sum += values[k] * x[columns[k]];
+            }
+            y[i] = sum;
+        }
+    }
+
+    matrix_library::Matrix SparseMatrix::to_dense() const {
+        matrix_library::Matrix dense(row_count_, column_count_);
+        for (size_t i = 0; i < row_count_; ++i) {
+            for (size_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+                dense.get_element(i, column_indices_[k]) = values_[k];
+            }
+        }
+        return dense;
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPARSEMATRIX_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPARSEMATRIX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Matrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Разреженная матрица в формате CSR (compressed sparse row).
+     * @details Ненулевые элементы хранятся по строкам: values и column_indices строки i
+     * @details лежат в позициях [row_offsets[i], row_offsets[i + 1]), номера столбцов в строке возрастают.
+     * @details Номера столбцов 32-битные: на 7 ненулевых в строке матрица с 10^7 строк занимает около 600 МБ,
+     * @details тогда как плотная - 400 ТБ.
+     */
+    class SparseMatrix {
+    public:
+        SparseMatrix() = default;
+
+        /**
+         * @brief Конструктор из готовых массивов CSR.
+         * @param row_count Количество строк.
+         * @param column_count Количество столбцов. Не больше 2^32.
+         * @param row_offsets Начала строк, row_count + 1 элементов, последний равен количеству ненулевых.
+         * @param column_indices Номера столбцов ненулевых элементов.
+         * @param values Значения ненулевых элементов.
+         */
+        SparseMatrix(size_t row_count, size_t column_count, std::vector<size_t> row_offsets,
+                     std::vector<uint32_t> column_indices, std::vector<float> values);
+
+        /**
+         * @brief Получить количество строк матрицы.
+         * @return Количество строк матрицы.
+         */
+        size_t get_row_count() const;
+
+        /**
+         * @brief Получить количество столбцов матрицы.
+         * @return Количество столбцов матрицы.
+         */
+        size_t get_column_count() const;
+
+        /**
+         * @brief Получить количество хранимых ненулевых элементов.
+         * @return Количество ненулевых элементов.
+         */
+        size_t get_nonzero_count() const;
+
+        /**
+         * @brief Получить объём памяти под матрицу.
+         * @return Количество байт в массивах CSR.
+         */
+        size_t get_memory_size() const;
+
+        /**
+         * @brief Получить начала строк.
+         * @return Массив из row_count + 1 элементов. Неизменяемая ссылка.
+         */
+        const std::vector<size_t> &get_row_offsets() const;
+
+        /**
+         * @brief Получить номера столбцов ненулевых элементов.
+         * @return Неизменяемая ссылка.
+         */
+        const std::vector<uint32_t> &get_column_indices() const;
+
+        /**
+         * @brief Получить значения ненулевых элементов.
+         * @return Неизменяемая ссылка.
+         */
+        const std::vector<float> &get_values() const;
+
+        /**
+         * @brief Получить элемент матрицы. Двоичный поиск по строке, для отладки и проверок.
+         * @param row_index Номер строки.
+         * @param column_index Номер столбца.
+         * @return Значение элемента, ноль, если он не хранится.
+         */
+        float get_element(size_t row_index, size_t column_index) const;
+
+        /**
+         * @brief Умножение на вектор y = A x. Строки распределяются между потоками OMP.
+         * @param x Вектор длины get_column_count().
+         * @param y Результат длины get_row_count().
+         */
+        void multiply(const float *x, float *y) const;
+
+        /**
+         * @brief Преобразовать в плотную матрицу.
+         * @return Плотная матрица.
+         */
+        matrix_library::Matrix to_dense() const;
+
+    private:
+        size_t row_count_{0};
+        size_t column_count_{0};
+        std::vector<size_t> row_offsets_{0};
+        std::vector<uint32_t> column_indices_;
+        std::vector<float> values_;
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_SPARSEMATRIX_H
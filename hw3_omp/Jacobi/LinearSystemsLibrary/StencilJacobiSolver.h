@@ -0,0 +1,339 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_STENCILJACOBISOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_STENCILJACOBISOLVER_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include <omp.h>
+
+#include "Matrix.h"
+#include "PerfCounters.h"
+#include "SolverMonitor.h"
+#include "Tracing.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief 5-точечный шаблон на квадратной сетке: 4 на диагонали, -1 для соседей по осям.
+     * @details Та же матрица, что в SparseLinearSystem::poisson_2d.
+     */
+    struct FivePointStencil {
+        static constexpr size_t DIMENSIONS = 2;
+        static constexpr std::array<std::array<int, 3>, 4> NEIGHBOURS{{
+                {0, -1, 0}, {-1, 0, 0}, {1, 0, 0}, {0, 1, 0}}};
+    };
+
+    /**
+     * @brief 7-точечный шаблон на кубической сетке: 6 на диагонали, -1 для соседей по осям.
+     * @details Та же матрица, что в SparseLinearSystem::poisson_3d.
+     */
+    struct SevenPointStencil {
+        static constexpr size_t DIMENSIONS = 3;
+        static constexpr std::array<std::array<int, 3>, 6> NEIGHBOURS{{
+                {0, 0, -1}, {0, -1, 0}, {-1, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+    };
+
+    /**
+     * @brief 27-точечный шаблон на кубической сетке, как в HPCG: 26 на диагонали, -1 для всех соседей в кубе 3 x 3 x 3.
+     * @details Та же матрица, что в SparseLinearSystem::stencil_27_point.
+     */
+    struct TwentySevenPointStencil {
+        static constexpr size_t DIMENSIONS = 3;
+        static constexpr std::array<std::array<int, 3>, 26> NEIGHBOURS = []() {
+            std::array<std::array<int, 3>, 26> neighbours{};
+            size_t position = 0;
+            for (int dz = -1; dz <= 1; ++dz) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (dx != 0 || dy != 0 || dz != 0) {
+                            neighbours[position++] = {dx, dy, dz};
+                        }
+                    }
+                }
+            }
+            return neighbours;
+        }();
+    };
+
+    /**
+     * @brief Метод Якоби для разностного шаблона на прямоугольной сетке с нулевыми граничными условиями Дирихле.
+     * @details Матрица не хранится: шаблон - параметр шаблона класса, смещения соседей известны при компиляции,
+     * @details и цикл по соседям разворачивается. Все внедиагональные веса -1, диагональ - количество соседей,
+     * @details поэтому шаг Якоби - u_new = (f + sum u_neighbour) / N. Узлы нумеруются как в SparseLinearSystem: x быстрее всего.
+     * @details Сетка делится на тайлы tile_size по каждому измерению. Тайл вместе с "призрачным" слоем ширины
+     * @details time_steps копируется в локальный буфер потока, и над ним делается time_steps итераций подряд,
+     * @details пока он лежит в кэше: на итерации t обновляются узлы на расстоянии не меньше t от края буфера.
+     * @details После последней итерации внутренность тайла верна, слой выбрасывается. Узлы слоя считаются
+     * @details несколькими тайлами повторно - это плата за то, что общая память читается один раз на time_steps итераций.
+     * @details Невязка b - A u = N (u_new - u) получается бесплатно из последних двух итераций.
+     * @tparam Stencil FivePointStencil, SevenPointStencil или TwentySevenPointStencil.
+     */
+    template<typename Stencil>
+    class StencilJacobiSolver {
+    public:
+        static constexpr size_t DIMENSIONS = Stencil::DIMENSIONS;
+        static constexpr size_t NEIGHBOURS_COUNT = Stencil::NEIGHBOURS.size();
+        static_assert(DIMENSIONS == 2 || DIMENSIONS == 3, "Only 2D and 3D stencils are supported.");
+
+        /**
+         * @brief Конструктор.
+         * @param side_x Количество внутренних узлов по x.
+         * @param side_y Количество внутренних узлов по y.
+         * @param side_z Количество внутренних узлов по z, для двумерного шаблона 1.
+         * @param tile_size Сторона тайла в узлах.
+         * @param time_steps Количество итераций над тайлом за одно чтение общей памяти.
+         */
+        StencilJacobiSolver(size_t side_x, size_t side_y, size_t side_z = 1,
+                            size_t tile_size = DIMENSIONS == 2 ? 128 : 32,
+                            size_t time_steps = DIMENSIONS == 2 ? 4 : 2) :
+                sides_{side_x, side_y, side_z},
+                tile_size_(tile_size),
+                time_steps_(time_steps) {
+            assert(side_x > 0 && side_y > 0 && side_z > 0);
+            assert(DIMENSIONS == 3 || side_z == 1);
+            assert(tile_size > 0 && time_steps > 0);
+        }
+
+        /**
+         * @brief Получить количество неизвестных.
+         * @return Количество узлов сетки.
+         */
+        size_t get_size() const {
+            return sides_[0] * sides_[1] * sides_[2];
+        }
+
+        /**
+         * @brief Умножение на вектор y = A x.
+         * @param x Вектор длины get_size().
+         * @param y Результат длины get_size().
+         */
+        void multiply(const float *x, float *y) const {
+            const long long side_x = static_cast<long long>(sides_[0]);
+            const long long side_y = static_cast<long long>(sides_[1]);
+            const long long side_z = static_cast<long long>(sides_[2]);
+#pragma omp parallel for collapse(2) schedule(static) default(none) shared(side_x, side_y, side_z, x, y)
+            for (long long z = 0; z < side_z; ++z) {
+                for (long long y_index = 0; y_index < side_y; ++y_index) {
+                    for (long long x_index = 0; x_index < side_x; ++x_index) {
+                        const long long i = x_index + side_x * (y_index + side_y * z);
+                        float sum = static_cast<float>(NEIGHBOURS_COUNT) * x[i];
+                        for (const auto &neighbour: Stencil::NEIGHBOURS) {
+                            long long nx = x_index + neighbour[0];
+                            long long ny = y_index + neighbour[1];
+                            long long nz = z + neighbour[2];
+                            if (nx >= 0 && ny >= 0 && nz >= 0 && nx < side_x && ny < side_y && nz < side_z) {
+                                sum -= x[nx + side_x * (ny + side_y * nz)];
+                            }
+                        }
+                        y[i] = sum;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Решить A x = b.
+         * @details Итерации идут до ||b - A x|| <= eps * ||b||, как в JacobiSolver::solve_csr для операторов Лапласа.
+         * @details Сходимость проверяется раз в time_steps итераций, поэтому итераций может быть на time_steps - 1 больше;
+         * @details options.steps_per_check не используется. Лимиты, расходимость и застой отслеживает SolverMonitor.
+         * @param b Вектор-столбец свободных членов длины get_size().
+         * @param options Точность и условия аварийной остановки.
+         * @return Приближение, причина остановки, количество итераций, невязка и время по фазам.
+         */
+        SolverResult solve(const matrix_library::Matrix &b, const SolverOptions &options = SolverOptions()) const {
+            assert(b.get_row_count() == get_size() && b.get_column_count() == 1);
+            const size_t size = get_size();
+            const float *rhs = b.get_data();
+
+            double b_norm = 0.0;
+#pragma omp parallel for simd schedule(static) default(none) shared(size, rhs) reduction(+:b_norm)
+            for (size_t i = 0; i < size; ++i) {
+                b_norm += static_cast<double>(rhs[i]) * rhs[i];
+            }
+            SolverMonitor monitor(options, size, std::sqrt(b_norm));
+
+            /**
+             * Тайлы и локальные буферы. По измерениям, которых у шаблона нет, тайл - один слой без призрачных узлов.
+             */
+            std::array<size_t, 3> tiles_counts{};
+            std::array<size_t, 3> halos{};
+            size_t buffer_size = 1;
+            for (size_t a = 0; a < 3; ++a) {
+                const size_t tile = a < DIMENSIONS ? tile_size_ : 1;
+                halos[a] = a < DIMENSIONS ? time_steps_ : 0;
+                tiles_counts[a] = (sides_[a] + tile - 1) / tile;
+                buffer_size *= std::min(tile, sides_[a]) + 2 * halos[a];
+            }
+            const size_t tiles_count = tiles_counts[0] * tiles_counts[1] * tiles_counts[2];
+            std::vector<float> buffers(3 * buffer_size * static_cast<size_t>(omp_get_max_threads()));
+            monitor.finish_setup();
+
+            TRACE_SCOPE("stencil_jacobi_iterations");
+            benchmark_library::PerfRegion iterations_region("stencil_jacobi_iterations");
+            matrix_library::Matrix u_first(size, 1);
+            matrix_library::Matrix u_second(size, 1);
+            float *u = u_first.get_data();
+            float *u_next = u_second.get_data();
+            std::fill(u, u + size, 0.0f);
+            size_t iterations = 0;
+            std::optional<SolverStatus> status;
+            while (!status) {
+                iterations_region.add_flops(static_cast<double>((NEIGHBOURS_COUNT + 1) * time_steps_ + 4) *
+                                            static_cast<double>(size));
+                iterations += time_steps_;
+
+                double residual_norm = 0.0;
+#pragma omp parallel default(none) shared(tiles_count, tiles_counts, halos, buffer_size, buffers, rhs, u, u_next) \
+        reduction(+:residual_norm)
+                {
+                    float *source = buffers.data() + 3 * buffer_size * static_cast<size_t>(omp_get_thread_num());
+                    float *destination = source + buffer_size;
+                    float *local_rhs = destination + buffer_size;
+#pragma omp for schedule(dynamic)
+                    for (size_t tile = 0; tile < tiles_count; ++tile) {
+                        const std::array<size_t, 3> tile_index{tile % tiles_counts[0],
+                                                              (tile / tiles_counts[0]) % tiles_counts[1],
+                                                              tile / (tiles_counts[0] * tiles_counts[1])};
+                        residual_norm += sweep_tile(tile_index, halos, u, rhs, u_next,
+                                                    source, destination, local_rhs);
+                    }
+                }
+
+                std::swap(u, u_next);
+                residual_norm = std::sqrt(residual_norm);
+                status = monitor.finish_iteration(iterations, monitor.is_residual_small(residual_norm), false,
+                                                  [residual_norm]() { return residual_norm; });
+            }
+
+            if (u == u_first.get_data()) {
+                return monitor.make_result(std::move(u_first), iterations, *status);
+            }
+            return monitor.make_result(std::move(u_second), iterations, *status);
+        }
+
+    private:
+        /**
+         * @brief Сделать time_steps итераций над одним тайлом.
+         * @param tile_index Номер тайла по каждому измерению.
+         * @param halos Ширина призрачного слоя по каждому измерению.
+         * @param u Текущее приближение.
+         * @param rhs Свободные члены.
+         * @param u_next Сюда записывается внутренность тайла после time_steps итераций.
+         * @param source Локальный буфер потока.
+         * @param destination Второй локальный буфер потока.
+         * @param local_rhs Буфер под свободные члены тайла.
+         * @return Вклад тайла в квадрат нормы невязки приближения после time_steps - 1 итераций.
+         */
+        double sweep_tile(const std::array<size_t, 3> &tile_index, const std::array<size_t, 3> &halos,
+                          const float *u, const float *rhs, float *u_next,
+                          float *source, float *destination, float *local_rhs) const {
+            /**
+             * Локальная координата l по измерению a соответствует глобальной origin[a] - halos[a] + l.
+             * Узлы вне области остаются нулями в обоих буферах - это и есть граничное условие.
+             */
+            std::array<long long, 3> origin{};
+            std::array<long long, 3> extent{};
+            std::array<long long, 3> local_sides{};
+            std::array<long long, 3> domain_begin{};
+            std::array<long long, 3> domain_end{};
+            for (size_t a = 0; a < 3; ++a) {
+                const size_t tile = a < DIMENSIONS ? tile_size_ : 1;
+                origin[a] = static_cast<long long>(tile_index[a] * tile);
+                extent[a] = static_cast<long long>(std::min(tile, sides_[a] - tile_index[a] * tile));
+                const auto halo = static_cast<long long>(halos[a]);
+                local_sides[a] = extent[a] + 2 * halo;
+                domain_begin[a] = std::max(0LL, halo - origin[a]);
+                domain_end[a] = std::min(local_sides[a], static_cast<long long>(sides_[a]) - origin[a] + halo);
+            }
+            const long long stride_y = local_sides[0];
+            const long long stride_z = local_sides[0] * local_sides[1];
+            const auto global_x = static_cast<long long>(sides_[0]);
+            const auto global_xy = static_cast<long long>(sides_[0] * sides_[1]);
+            const auto halo_x = static_cast<long long>(halos[0]);
+            const auto halo_y = static_cast<long long>(halos[1]);
+            const auto halo_z = static_cast<long long>(halos[2]);
+
+            std::fill(source, source + stride_z * local_sides[2], 0.0f);
+            std::fill(local_rhs, local_rhs + stride_z * local_sides[2], 0.0f);
+            for (long long z = domain_begin[2]; z < domain_end[2]; ++z) {
+                for (long long y = domain_begin[1]; y < domain_end[1]; ++y) {
+                    const long long global_row = (origin[0] - halo_x) + global_x * (origin[1] - halo_y + y) +
+                                                 global_xy * (origin[2] - halo_z + z);
+                    const long long local_row = stride_y * y + stride_z * z;
+                    std::copy(u + (global_row + domain_begin[0]), u + (global_row + domain_end[0]),
+                              source + local_row + domain_begin[0]);
+                    std::copy(rhs + (global_row + domain_begin[0]), rhs + (global_row + domain_end[0]),
+                              local_rhs + local_row + domain_begin[0]);
+                }
+            }
+            std::copy(source, source + stride_z * local_sides[2], destination);
+
+            std::array<long long, NEIGHBOURS_COUNT> offsets{};
+            for (size_t k = 0; k < NEIGHBOURS_COUNT; ++k) {
+                offsets[k] = Stencil::NEIGHBOURS[k][0] + stride_y * Stencil::NEIGHBOURS[k][1] +
+                             stride_z * Stencil::NEIGHBOURS[k][2];
+            }
+            const float inverse_diagonal = 1.0f / static_cast<float>(NEIGHBOURS_COUNT);
+
+            for (size_t t = 1; t <= time_steps_; ++t) {
+                std::array<long long, 3> begin{};
+                std::array<long long, 3> end{};
+                for (size_t a = 0; a < 3; ++a) {
+                    const auto shrink = static_cast<long long>(a < DIMENSIONS ? t : 0);
+                    begin[a] = std::max(shrink, domain_begin[a]);
+                    end[a] = std::min(local_sides[a] - shrink, domain_end[a]);
+                }
+                for (long long z = begin[2]; z < end[2]; ++z) {
+                    for (long long y = begin[1]; y < end[1]; ++y) {
+                        const long long row = stride_y * y + stride_z * z;
+                        const float *src = source + row;
+                        const float *f = local_rhs + row;
+                        float *dst = destination + row;
+#pragma omp simd
+                        for (long long x = begin[0]; x < end[0]; ++x) {
+                            float sum = f[x];
+                            for (size_t k = 0; k < NEIGHBOURS_COUNT; ++k) {
+                                sum += src[x + offsets[k]];
+                            }
+                            dst[x] = sum * inverse_diagonal;
+                        }
+                    }
+                }
+                std::swap(source, destination);
+            }
+
+            /**
+             * Теперь source - итерация time_steps, destination - итерация time_steps - 1 (на внутренности тайла обе верны).
+             */
+            const auto diagonal = static_cast<float>(NEIGHBOURS_COUNT);
+            double residual_norm = 0.0;
+            for (long long z = halo_z; z < halo_z + extent[2]; ++z) {
+                for (long long y = halo_y; y < halo_y + extent[1]; ++y) {
+                    const long long local_row = stride_y * y + stride_z * z + halo_x;
+                    const long long global_row = origin[0] + global_x * (origin[1] - halo_y + y) +
+                                                 global_xy * (origin[2] - halo_z + z);
+                    const float *latest = source + local_row;
+                    const float *previous = destination + local_row;
+                    float *result = u_next + global_row;
+#pragma omp simd reduction(+:residual_norm)
+                    for (long long x = 0; x < extent[0]; ++x) {
+                        float residual = diagonal * (latest[x] - previous[x]);
+                        residual_norm += static_cast<double>(residual) * residual;
+                        result[x] = latest[x];
+                    }
+                }
+            }
+            return residual_norm;
+        }
+
+        std::array<size_t, 3> sides_;
+        size_t tile_size_;
+        size_t time_steps_;
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_STENCILJACOBISOLVER_H
@@ -0,0 +1,95 @@
+#include <cassert>
+#include <cmath>
+
+#include "BlasBackend.h"
+#include "VectorOperations.h"
+
+namespace linear_systems_library {
+
+    double VectorOperations::dot(size_t size, const float *x, const float *y) {
+        double sum = 0.0;
+#pragma omp parallel for simd schedule(static) default(none) shared(size, x, y) reduction(+:sum)
+        for (size_t i = 0; i < size; ++i) {
+            sum += static_cast<double>(x[i]) * y[i];
+        }
+        return sum;
+    }
+
+    double VectorOperations::norm2(size_t size, const float *x) {
+        return std::sqrt(dot(size, x, x));
+    }
+
+    void VectorOperations::dot_pair(size_t size, const float *x, const float *y, const float *z, double &xy, double &xz) {
+        double sum_y = 0.0;
+        double sum_z = 0.0;
+#pragma omp parallel for simd schedule(static) default(none) shared(size, x, y, z) reduction(+:sum_y, sum_z)
+        for (size_t i = 0; i < size; ++i) {
+            sum_y += static_cast<double>(x[i]) * y[i];
+            sum_z += static_cast<double>(x[i]) * z[i];
+        }
+        xy = sum_y;
+        xz = sum_z;
+    }
+
+    void VectorOperations::axpy(size_t size, float a, const float *x, float *y) {
+#pragma omp parallel for simd schedule(static) default(none) shared(size, a, x, y)
+        for (size_t i = 0; i < size; ++i) {
+            y[i] += a * x[i];
+        }
+    }
+
+    double VectorOperations::axpy_dot(size_t size, float a, const float *x, float *y) {
+        double sum = 0.0;
+#pragma omp parallel for simd schedule(static) default(none) shared(size, a, x, y) reduction(+:sum)
+        for (size_t i = 0; i < size; ++i) {
+            float value = y[i] + a * x[i];
+            y[i] = value;
+            sum += static_cast<double>(value) * value;
+        }
+        return sum;
+    }
+
+    void VectorOperations::xpay(size_t size, const float *x, float a, float *y) {
+#pragma omp parallel for simd schedule(static) default(none) shared(size, a, x, y)
+        for (size_t i = 0; i < size; ++i) {
+            y[i] = x[i] + a * y[i];
+        }
+    }
+
+    void VectorOperations::waxpby(size_t size, float a, const float *x, float b, const float *y, float *w) {
+#pragma omp parallel for simd schedule(static) default(none) shared(size, a, x, b, y, w)
+        for (size_t i = 0; i < size; ++i) {
+            w[i] = a * x[i] + b * y[i];
+        }
+    }
+
+    double VectorOperations::waxpby_dot(size_t size, float a, const float *x, float b, const float *y, float *w) {
+        double sum = 0.0;
+#pragma omp parallel for simd schedule(static) default(none) shared(size, a, x, b, y, w) reduction(+:sum)
+        for (size_t i = 0; i < size; ++i) {
+            float value = a * x[i] + b * y[i];
+            w[i] = value;
+            sum += static_cast<double>(value) * value;
+        }
+        return sum;
+    }
+
+    void VectorOperations::axpbypcz(size_t size, float a, const float *x, float b, const float *y, float c, float *z) {
+#pragma omp parallel for simd schedule(static) default(none) shared(size, a, x, b, y, c, z)
+        for (size_t i = 0; i < size; ++i) {
+            z[i] = a * x[i] + b * y[i] + c * z[i];
+        }
+    }
+
+    void VectorOperations::multiply(const matrix_library::Matrix &A, const float *x, float *y) {
+        matrix_library::BlasBackend::instance().sgemv(matrix_library::BlasTranspose::NO,
+                                                      A.get_row_count(), A.get_column_count(),
+                                                      1.0f, A.get_data(), A.get_column_count(), x, 0.0f, y);
+    }
+
+    double VectorOperations::residual(const matrix_library::Matrix &A, const float *x, const float *b, float *r) {
+        assert(A.get_row_count() == A.get_column_count());
+        multiply(A, x, r);
+        return waxpby_dot(A.get_row_count(), 1.0f, b, -1.0f, r, r);
+    }
+}
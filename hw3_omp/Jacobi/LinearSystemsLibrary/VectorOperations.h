@@ -0,0 +1,133 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_VECTOROPERATIONS_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_VECTOROPERATIONS_H
+
+#include <cstddef>
+
+#include <omp.h>
+
+#include "Matrix.h"
+
+namespace linear_systems_library {
+
+    /**
+     * @brief Операции над векторами для итерационных методов.
+     * @details Все операции работают с заранее выделенной памятью и ничего не выделяют сами,
+     * @details поэтому итерации методов на их основе не обращаются к аллокатору.
+     * @details Распараллелены OMP и векторизуются. Скалярные произведения накапливаются в double.
+     * @details Совмещённые операции (axpy_dot, waxpby_dot, dot_pair) проходят по векторам один раз
+     * @details вместо двух: итерационные методы упираются в память, и лишний проход стоит столько же, сколько сама операция.
+     */
+    class VectorOperations {
+    public:
+        /**
+         * @brief Скалярное произведение (x, y).
+         * @param size Длина векторов.
+         * @param x Первый вектор.
+         * @param y Второй вектор.
+         * @return Скалярное произведение.
+         */
+        static double dot(size_t size, const float *x, const float *y);
+
+        /**
+         * @brief Евклидова норма вектора.
+         * @param size Длина вектора.
+         * @param x Вектор.
+         * @return Норма вектора.
+         */
+        static double norm2(size_t size, const float *x);
+
+        /**
+         * @brief Два скалярных произведения с общим вектором за один проход: (x, y) и (x, z).
+         * @param size Длина векторов.
+         * @param x Общий вектор.
+         * @param y Второй вектор первого произведения.
+         * @param z Второй вектор второго произведения.
+         * @param xy Сюда записывается (x, y).
+         * @param xz Сюда записывается (x, z).
+         */
+        static void dot_pair(size_t size, const float *x, const float *y, const float *z, double &xy, double &xz);
+
+        /**
+         * @brief y = a * x + y.
+         * @param size Длина векторов.
+         * @param a Множитель.
+         * @param x Прибавляемый вектор.
+         * @param y Изменяемый вектор.
+         */
+        static void axpy(size_t size, float a, const float *x, float *y);
+
+        /**
+         * @brief y = a * x + y и (y, y) за один проход.
+         * @param size Длина векторов.
+         * @param a Множитель.
+         * @param x Прибавляемый вектор.
+         * @param y Изменяемый вектор.
+         * @return Квадрат нормы нового y.
+         */
+        static double axpy_dot(size_t size, float a, const float *x, float *y);
+
+        /**
+         * @brief y = x + a * y.
+         * @param size Длина векторов.
+         * @param x Прибавляемый вектор.
+         * @param a Множитель.
+         * @param y Изменяемый вектор.
+         */
+        static void xpay(size_t size, const float *x, float a, float *y);
+
+        /**
+         * @brief w = a * x + b * y. Прежнее содержимое w не читается.
+         * @param size Длина векторов.
+         * @param a Множитель x.
+         * @param x Первый вектор.
+         * @param b Множитель y.
+         * @param y Второй вектор.
+         * @param w Результат.
+         */
+        static void waxpby(size_t size, float a, const float *x, float b, const float *y, float *w);
+
+        /**
+         * @brief w = a * x + b * y и (w, w) за один проход.
+         * @param size Длина векторов.
+         * @param a Множитель x.
+         * @param x Первый вектор.
+         * @param b Множитель y.
+         * @param y Второй вектор.
+         * @param w Результат.
+         * @return Квадрат нормы w.
+         */
+        static double waxpby_dot(size_t size, float a, const float *x, float b, const float *y, float *w);
+
+        /**
+         * @brief z = a * x + b * y + c * z.
+         * @param size Длина векторов.
+         * @param a Множитель x.
+         * @param x Первый вектор.
+         * @param b Множитель y.
+         * @param y Второй вектор.
+         * @param c Множитель z.
+         * @param z Изменяемый вектор.
+         */
+        static void axpbypcz(size_t size, float a, const float *x, float b, const float *y, float c, float *z);
+
+        /**
+         * @brief y = A * x через выбранную реализацию BLAS.
+         * @param A Квадратная матрица.
+         * @param x Вектор длины A.get_column_count().
+         * @param y Результат длины A.get_row_count().
+         */
+        static void multiply(const matrix_library::Matrix &A, const float *x, float *y);
+
+        /**
+         * @brief r = b - A * x и (r, r).
+         * @param A Квадратная матрица.
+         * @param x Текущее приближение.
+         * @param b Правая часть.
+         * @param r Невязка.
+         * @return Квадрат нормы невязки.
+         */
+        static double residual(const matrix_library::Matrix &A, const float *x, const float *b, float *r);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_VECTOROPERATIONS_H
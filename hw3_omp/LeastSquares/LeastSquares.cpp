@@ -1,129 +1,452 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
 #include <random>
 #include <iostream>
-#include <iomanip>
-#include <chrono>
+#include <string>
 #include <tuple>
 #include <vector>
 #include <cassert>
 
 #include <omp.h>
 
+#include "CounterRandom.h"
+#include "LeastSquaresSolver.h"
+#include "LinearFit.h"
+#include "LinearFitAccumulator.h"
+#include "Matrix.h"
+#include "RobustLinearFit.h"
+#include "StreamingLinearFit.h"
+#include "Scaling.h"
+#include "SplitMix.h"
+#include "Tracing.h"
+
+/**
+ * @brief Зашумлённый линейный закон с выбросами. y = a * x + b + noise
+ */
+struct LinearDependence {
+    /**
+     * Коэффициент прямой при первой степени x.
+     */
+    double a = 1.0;
+
+    /**
+     * Свободный коэффициент прямой.
+     */
+    double b = 0.0;
+
+    /**
+     * Математическое ожидание шума.
+     */
+    double mean_noise = 0.0;
+
+    /**
+     * Стандартное отклонение шума.
+     */
+    double std_noise = 1.0;
+
+    /**
+     * Доля выбросов: y такой точки не зависит от закона и равномерно распределён на [b, b + outliers_span).
+     */
+    double outliers_fraction = 0.0;
+
+    /**
+     * Ширина отрезка значений выбросов.
+     */
+    double outliers_span = 0.0;
+
+    /**
+     * Зерно генераторов шума и выбросов.
+     */
+    uint64_t seed = 0;
+};
+
+/**
+ * @brief Заполнить блок зашумлённых наблюдений линейного закона. y = a * x + b + noise
+ * @details Точка с номером i имеет x = i, шум точки i - i-е число счётного генератора fill_normal,
+ * @details выброс ли она - по i-му числу fill_uniform, поэтому блоки можно заполнять в любом порядке
+ * @details и в разных потоках, а результат зависит только от зерна.
+ * @param dependence Закон.
+ * @param first_point Номер первой точки блока.
+ * @param count Количество точек в блоке.
+ * @param x Массив на count абсцисс.
+ * @param y Массив на count наблюдений.
+ */
+void fill_linear_points(const LinearDependence &dependence, size_t first_point, size_t count, double *x, double *y) {
+    const double a = dependence.a;
+    const double b = dependence.b;
+    regression_library::fill_normal(dependence.seed, first_point, count, dependence.mean_noise, dependence.std_noise, y);
+    if (dependence.outliers_fraction > 0.0) {
+        // x пока хранит равномерные на [0, 1) числа: меньшие доли выбросов, делённые на неё, снова равномерны
+        const double fraction = dependence.outliers_fraction;
+        const double span = dependence.outliers_span / fraction;
+        regression_library::fill_uniform(dependence.seed + 4, first_point, count, 0.0, 1.0, x);
+        for (size_t i = 0; i < count; ++i) {
+            double line = a * static_cast<double>(first_point + i) + b + y[i];
+            y[i] = x[i] < fraction ? b + span * x[i] : line;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = static_cast<double>(first_point + i);
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = static_cast<double>(first_point + i);
+        y[i] += a * x[i] + b;
+    }
+}
+
 /**
  * @brief Генерирует зашумлённые наблюдения линейного закона. y = a * x + b + noise
- * @details Переменная x инкрементится, начиная с нуля.
- * @tparam DistributionType Тип данных, описывающий распределение шума. Ожидается какой-либо из стандартных типов.
- * @param a Коэффициент прямой при первой степени x.
- * @param b Свободный коэффициент прямой.
- * @param noise_distribution Распределение шума.
+ * @details Переменная x инкрементится, начиная с нуля. Векторы выделяются сразу целиком и заполняются
+ * @details блоками по CHUNK_SIZE точек параллельно, результат не зависит от количества потоков.
+ * @param dependence Закон.
  * @param points_count Количество наблюдений.
  * @return Кортеж векторов (x, y). Зашумлённые наблюдения.
  */
-template <typename DistributionType>
-std::tuple<std::vector<double>, std::vector<double>> generate_linear_dependence_with_noise(double a, double b, DistributionType noise_distribution, size_t points_count=100) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
+std::tuple<std::vector<double>, std::vector<double>> generate_linear_dependence_with_noise(
+        const LinearDependence &dependence, size_t points_count) {
+    TRACE_SCOPE("generate_linear_dependence_with_noise");
     std::vector<double> x(points_count);
-    std::iota (std::begin(x), std::end(x), 0);
+    std::vector<double> y(points_count);
+    double *x_data = x.data();
+    double *y_data = y.data();
+    const size_t chunk_size = regression_library::CHUNK_SIZE;
+    const size_t chunks_count = (points_count + chunk_size - 1) / chunk_size;
 
-    std::vector<double> y;
-    y.reserve(points_count);
-    for(auto sample: x) {
-        y.push_back(a * sample + b + noise_distribution(gen));
+#pragma omp parallel for default(none) shared(dependence, points_count, x_data, y_data, chunk_size, chunks_count) schedule(static)
+    for (size_t chunk = 0; chunk < chunks_count; ++chunk) {
+        const size_t begin = chunk * chunk_size;
+        const size_t count = std::min(chunk_size, points_count - begin);
+        fill_linear_points(dependence, begin, count, x_data + begin, y_data + begin);
     }
 
-    return {x, y};
+    return {std::move(x), std::move(y)};
+}
+
+/**
+ * @brief Источник зашумлённых наблюдений линейного закона для потоковой обработки. y = a * x + b + noise
+ * @details Даёт те же точки, что и generate_linear_dependence_with_noise с тем же законом.
+ * @param dependence Закон.
+ * @return Источник точек для StreamingLinearFit.
+ */
+regression_library::PointsGenerator make_points_generator(const LinearDependence &dependence) {
+    return [=](size_t first_point, size_t count, double *x, double *y) {
+        fill_linear_points(dependence, first_point, count, x, y);
+    };
 }
 
 /**
- * @brief Метод наименьших квадратов. Поиск коэффициентов прямой по зашумлённым наблюдениям.
- * @param x Вектор точек, в которых производились наблюдения.
- * @param y Наблюдаемые значения функции с шумом.
- * @return Кортеж (a, b) оценок коэффициентов прямой y = a * x + b
+ * @brief Напечатать коэффициенты прямой, найденные потоковой оценкой.
+ * @param accumulator Накопитель по всем точкам.
  */
-std::tuple<double, double> find_linear_coefficients(const std::vector<double>& x, const std::vector<double>& y) {
-    assert(x.size() == y.size());
+void print_coefficients(const regression_library::LinearFitAccumulator &accumulator) {
+    auto [a_estimate, b_estimate] = accumulator.get_coefficients();
+    std::cout << "a = " << a_estimate << std::endl;
+    std::cout << "b = " << b_estimate << std::endl;
+}
 
-    double sum_x = 0.0;
-    double sum_y = 0.0;
-    double sum_x_squares = 0.0;
-    double sum_prod_x_y = 0.0;
+/**
+ * @brief Запустить метод наименьших квадратов для линейной модели одним способом и напечатать точность и скорость.
+ * @tparam Solve Функция (X, y) -> beta.
+ * @param description Название способа.
+ * @param flops Количество операций с плавающей точкой.
+ * @param X Матрица признаков.
+ * @param y Наблюдения.
+ * @param expected Известные коэффициенты.
+ * @param solve Способ решения.
+ */
+template <typename Solve>
+void run_linear_model(const std::string &description, double flops, const matrix_library::Matrix &X,
+                      const matrix_library::Matrix &y, const std::vector<double> &expected, Solve solve) {
+    tracing_library::ScopedTimer timer("least_squares_linear_model");
+    std::vector<double> beta;
+    try {
+        beta = solve(X, y);
+    } catch (const std::invalid_argument &error) {
+        std::cout << description << ": " << error.what() << std::endl;
+        return;
+    }
+    auto microseconds = static_cast<double>(timer.stop());
+    double max_error = 0.0;
+    for (size_t j = 0; j < beta.size(); ++j) {
+        max_error = std::max(max_error, std::abs(beta[j] - expected[j]));
+    }
+    std::cout << description << ": " << microseconds / 1000.0 << " ms (" << flops / microseconds / 1000.0
+              << " GFlop/s), max coefficient error " << max_error << ", relative residual "
+              << regression_library::LeastSquaresSolver::relative_residual(X, y, beta) << "." << std::endl;
+}
 
-#pragma omp parallel default(none) shared(x, y, sum_x, sum_y, sum_x_squares, sum_prod_x_y)
+/**
+ * @brief Сравнить нормальные уравнения и TSQR на линейной модели с известными коэффициентами.
+ * @details Наблюдения y = X beta + noise считаются в double и округляются до float.
+ * @param X Матрица признаков.
+ * @param noise_std Стандартное отклонение шума.
+ * @param seed Зерно генераторов коэффициентов и шума.
+ * @param scaling Измерить зависимость времени от количества потоков вместо одного запуска.
+ * @param threads_counts Количества потоков для измерения.
+ */
+void run_linear_models(const matrix_library::Matrix &X, double noise_std, uint64_t seed, bool scaling,
+                       const std::vector<size_t> &threads_counts) {
+    const size_t n = X.get_row_count();
+    const size_t p = X.get_column_count();
+    std::vector<double> beta(p);
+    regression_library::fill_uniform(seed + 2, 0, p, -1.0, 1.0, beta.data());
+    matrix_library::Matrix y(n, 1);
+    const size_t chunk_size = regression_library::CHUNK_SIZE;
+    const size_t chunks_count = (n + chunk_size - 1) / chunk_size;
+#pragma omp parallel default(none) shared(X, y, n, p, beta, noise_std, seed, chunk_size, chunks_count)
     {
-#pragma omp for reduction(+:sum_x) nowait
-        for (size_t i = 0; i < x.size(); ++i) {
-            sum_x += x[i];
+        std::vector<double> noise(chunk_size);
+#pragma omp for schedule(static)
+        for (size_t chunk = 0; chunk < chunks_count; ++chunk) {
+            const size_t begin = chunk * chunk_size;
+            const size_t count = std::min(chunk_size, n - begin);
+            regression_library::fill_normal(seed + 3, begin, count, 0.0, noise_std, noise.data());
+            for (size_t i = 0; i < count; ++i) {
+                double value = noise[i];
+                for (size_t j = 0; j < p; ++j) {
+                    value += X.get_element(begin + i, j) * beta[j];
+                }
+                y.get_element(begin + i, 0) = static_cast<float>(value);
+            }
         }
-#pragma omp for reduction(+:sum_y) nowait
-        for (size_t i = 0; i < y.size(); ++i) {
-            sum_y += y[i];
-        }
-#pragma omp for reduction(+:sum_x_squares) nowait
-        for (size_t i = 0; i < x.size(); ++i) {
-            sum_x_squares += x[i] * x[i];
-        }
-#pragma omp for reduction(+:sum_prod_x_y) nowait
-        for (size_t i = 0; i < x.size(); ++i) {
-            sum_prod_x_y += x[i] * y[i];
-        }
-#pragma omp barrier
     }
 
-    double square_of_sum_x = sum_x * sum_x;
-
-    double a_estimate = (static_cast<double>(x.size()) * sum_prod_x_y - sum_x * sum_y) / (static_cast<double>(x.size()) * sum_x_squares - square_of_sum_x);
-    double b_estimate = (sum_y - a_estimate * sum_x) / static_cast<double>(x.size());
+    auto rows = static_cast<double>(n);
+    auto columns = static_cast<double>(p + 1);
+    // SYRK по верхнему треугольнику [X y]^T [X y] и QR-разложение Хаусхолдера [X y]
+    const double normal_equations_flops = rows * columns * (columns + 1.0);
+    const double tsqr_flops = 2.0 * rows * columns * columns;
+    if (scaling) {
+        benchmark_library::ScalingStudy study([](size_t threads_count) {
+            omp_set_num_threads(static_cast<int>(threads_count));
+        }, threads_counts);
+        study.run("normal_equations", n, normal_equations_flops, rows * columns * sizeof(float), [&]() {
+            regression_library::LeastSquaresSolver::solve_normal_equations(X, y);
+        });
+        study.run("tsqr", n, tsqr_flops, rows * columns * sizeof(float), [&]() {
+            regression_library::LeastSquaresSolver::solve_tsqr(X, y);
+        });
+        study.write();
+        return;
+    }
 
-    return {a_estimate, b_estimate};
+    run_linear_model("normal equations", normal_equations_flops, X, y, beta,
+                     [](const matrix_library::Matrix &X, const matrix_library::Matrix &y) {
+                         return regression_library::LeastSquaresSolver::solve_normal_equations(X, y);
+                     });
+    run_linear_model("tsqr", tsqr_flops, X, y, beta,
+                     [](const matrix_library::Matrix &X, const matrix_library::Matrix &y) {
+                         return regression_library::LeastSquaresSolver::solve_tsqr(X, y);
+                     });
 }
 
 /**
- * @brief Конвертирует количество микросекунд в человекопонятный формат.
- * @param duration_us Длительность в микросекундах.
- * @return Строка с человекопонятной записью.
+ * @brief Номера потоков случайных чисел устойчивых методов. Зерно потока - splitmix64(seed ^ номер):
+ * @brief так пары точек выбираются независимо от шума и выбросов данных, зёрна которых - seed плюс малое число.
  */
-std::string convert_us_to_human_readable(uint64_t duration_us){
-    if (duration_us < 1e3) {
-        return std::to_string(duration_us) + " us";
-    }
+const uint64_t RANSAC_STREAM = 0x52414E534143ull;
+const uint64_t LMS_STREAM = 0x4C4D53ull;
 
-    std::stringstream ss;
-    ss << std::fixed;
-    ss << std::setprecision(2);
-    if (duration_us < 1e6) {
-        ss << static_cast<double>(duration_us) / 1e3 << " ms";
-        return ss.str();
-    }
-    if (duration_us < 1e9) {
-        ss << static_cast<double>(duration_us) / 1e6 << " s";
-        return ss.str();
+/**
+ * @brief Найти коэффициенты прямой устойчивым к выбросам способом и напечатать их.
+ * @details Бросает std::invalid_argument, если способ неизвестен или порог RANSAC не положителен.
+ * @param method Способ: ransac, huber или tukey.
+ * @param x Точки наблюдений.
+ * @param y Наблюдения.
+ * @param std_noise Стандартное отклонение шума, порог RANSAC - три стандартных отклонения.
+ * @param seed Зерно программы, из него выводятся зёрна выбора пар точек RANSAC и начальной прямой IRLS.
+ * @param verbose Напечатать коэффициенты и статистику.
+ */
+void run_robust_fit(const std::string &method, const std::vector<double> &x, const std::vector<double> &y,
+                    double std_noise, uint64_t seed, bool verbose) {
+    double a_estimate, b_estimate;
+    std::string statistics;
+    if (method == "ransac") {
+        regression_library::RansacOptions options;
+        options.threshold = 3.0 * std_noise;
+        options.seed = benchmark_library::splitmix64(seed ^ RANSAC_STREAM);
+        auto result = regression_library::find_ransac_linear_coefficients(x, y, options);
+        a_estimate = result.a;
+        b_estimate = result.b;
+        statistics = std::to_string(result.hypotheses_count) + " hypotheses, " +
+                     std::to_string(result.inliers_count) + " inliers";
+    } else if (method == "huber" || method == "tukey") {
+        regression_library::IrlsOptions options;
+        options.loss = method == "huber" ? regression_library::RobustLoss::HUBER : regression_library::RobustLoss::TUKEY;
+        options.seed = benchmark_library::splitmix64(seed ^ LMS_STREAM);
+        auto result = regression_library::find_irls_linear_coefficients(x, y, options);
+        a_estimate = result.a;
+        b_estimate = result.b;
+        statistics = std::to_string(result.sample_iterations) + " iterations on sample, " +
+                     std::to_string(result.iterations) + " passes over data, scale " + std::to_string(result.scale);
+    } else {
+        throw std::invalid_argument("Unknown robust method: " + method + ". Use ransac, huber or tukey.");
     }
-    if (duration_us < 1e9 * 60) {
-        ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
-        return ss.str();
+    if (verbose) {
+        std::cout << "Robust " << method << " (" << statistics << "):" << std::endl;
+        std::cout << "a = " << a_estimate << std::endl;
+        std::cout << "b = " << b_estimate << std::endl;
     }
-
-    return std::to_string(duration_us) + " us";
 }
 
 int main(int argc, char *argv[]) {
+    std::vector<size_t> threads_counts;
+    bool scaling = benchmark_library::handle_scaling_option(argc, argv, threads_counts);
+    std::optional<std::string> read_path = benchmark_library::take_option(argc, argv, "--read=");
+    std::optional<std::string> write_path = benchmark_library::take_option(argc, argv, "--write=");
+    bool streaming = benchmark_library::take_option(argc, argv, "--stream").has_value();
+    std::optional<std::string> features_option = benchmark_library::take_option(argc, argv, "--features=");
+    std::optional<std::string> degree_option = benchmark_library::take_option(argc, argv, "--degree=");
+    std::optional<std::string> seed_option = benchmark_library::take_option(argc, argv, "--seed=");
+    std::optional<std::string> outliers_option = benchmark_library::take_option(argc, argv, "--outliers=");
+    std::optional<std::string> robust_option = benchmark_library::take_option(argc, argv, "--robust=");
+    // одно зерно воспроизводит одни и те же данные при любом количестве потоков и в любом режиме
+    const uint64_t seed = seed_option ? std::stoull(seed_option.value()) : std::random_device{}();
+
+    omp_set_dynamic(0);  // отключаем динамический выбор количества потоков
+
+    if (features_option || degree_option) {
+        if (argc < 2) {
+            std::cout << "Specify parameters: path_to_program --features=<p> | --degree=<d> points_count [std_noise] [--seed=<n>].";
+            return -1;
+        }
+        const size_t n = std::stoul(argv[1]);
+        const double noise_std = argc > 2 ? std::stod(argv[2]) : 1e-3;
+        if (!scaling) {
+            std::cout << "Work in " << omp_get_num_procs() << " thread with omp." << std::endl;
+            omp_set_num_threads(omp_get_num_procs());
+        }
+        tracing_library::ScopedTimer timer_setup("least_squares_design_matrix");
+        matrix_library::Matrix X;
+        if (features_option) {
+            // первый признак - единица (свободный член), остальные - равномерные на [-1, 1]
+            const size_t features_count = std::stoul(features_option.value());
+            X = matrix_library::Matrix(n, features_count + 1);
+#pragma omp parallel default(none) shared(X, n, features_count, seed)
+            {
+                std::vector<double> row(features_count);
+#pragma omp for schedule(static)
+                for (size_t i = 0; i < n; ++i) {
+                    regression_library::fill_uniform(seed + 1, i * features_count, features_count, -1.0, 1.0, row.data());
+                    X.get_element(i, 0) = 1.0f;
+                    for (size_t j = 1; j <= features_count; ++j) {
+                        X.get_element(i, j) = static_cast<float>(row[j - 1]);
+                    }
+                }
+            }
+        } else {
+            std::vector<double> points(n);
+            regression_library::fill_uniform(seed + 1, 0, n, -1.0, 1.0, points.data());
+            X = regression_library::LeastSquaresSolver::polynomial_features(points, std::stoul(degree_option.value()));
+        }
+        std::cout << "Design matrix " << X.get_row_count() << " x " << X.get_column_count() << " is generated in "
+                  << timer_setup.stop_human_readable() << "." << std::endl;
+        run_linear_models(X, noise_std, seed, scaling, threads_counts);
+        return 0;
+    }
+
+    if (read_path) {
+        std::cout << "Work in " << omp_get_num_procs() << " thread with omp." << std::endl;
+        omp_set_num_threads(omp_get_num_procs());
+        tracing_library::ScopedTimer timer("least_squares_file");
+        auto accumulator = regression_library::fit_points_file(read_path.value());
+        auto microseconds = static_cast<double>(timer.stop());
+        auto megabytes = static_cast<double>(accumulator.get_count() * 2 * sizeof(double)) / (1 << 20);
+        std::cout << "Calculated from " << accumulator.get_count() << " points in file in " << microseconds / 1000.0
+                  << " ms (" << megabytes / microseconds * 1e6 << " Mb/s)." << std::endl;
+        print_coefficients(accumulator);
+        return 0;
+    }
+
     if (argc < 6) {
-        std::cout << "Specify all parameters: path_to_program a b mean_noise std_noise points_count.";
+        std::cout << "Specify all parameters: path_to_program a b mean_noise std_noise points_count [--stream | --write=<file>] [--seed=<n>] [--outliers=<fraction>] [--robust=ransac|huber|tukey] or --read=<file>.";
         return -1;
     }
 
-    omp_set_dynamic(0);  // отключаем динамический выбор количества потоков
-    std::cout << "Work in " << omp_get_num_procs() << " thread with omp." << std::endl;
-    omp_set_num_threads(omp_get_num_procs());
+    LinearDependence dependence;
+    dependence.a = std::stod(argv[1]);
+    dependence.b = std::stod(argv[2]);
+    dependence.mean_noise = std::stod(argv[3]);
+    dependence.std_noise = std::stod(argv[4]);
+    dependence.seed = seed;
+    const size_t points_count = std::stoul(argv[5]);
+    if (outliers_option) {
+        // выбросы равномерно покрывают весь диапазон значений прямой
+        dependence.outliers_fraction = std::stod(outliers_option.value());
+        dependence.outliers_span = dependence.a * static_cast<double>(points_count);
+    }
+
+    if (write_path || streaming) {
+        std::cout << "Work in " << omp_get_num_procs() << " thread with omp." << std::endl;
+        omp_set_num_threads(omp_get_num_procs());
+        auto generate = make_points_generator(dependence);
+        if (write_path) {
+            tracing_library::ScopedTimer timer_write("write_points_file");
+            regression_library::write_points_file(write_path.value(), points_count, generate);
+            std::cout << "Points are written in " << timer_write.stop_human_readable() << "." << std::endl;
+            tracing_library::ScopedTimer timer("least_squares_file");
+            auto accumulator = regression_library::fit_points_file(write_path.value());
+            std::cout << "Calculated from file in " << timer.stop_human_readable() << "." << std::endl;
+            print_coefficients(accumulator);
+        } else {
+            tracing_library::ScopedTimer timer("least_squares_stream");
+            auto accumulator = regression_library::fit_generated_points(points_count, generate);
+            std::cout << "Generated and calculated block by block in " << timer.stop_human_readable() << "." << std::endl;
+            print_coefficients(accumulator);
+        }
+        return 0;
+    }
+
+    if (!scaling) {
+        std::cout << "Work in " << omp_get_num_procs() << " thread with omp." << std::endl;
+        omp_set_num_threads(omp_get_num_procs());
+    }
+    tracing_library::ScopedTimer timer_generate("generate_linear_dependence_with_noise");
+    auto [x, y] = generate_linear_dependence_with_noise(dependence, points_count);
+    std::cout << "Points are generated in " << timer_generate.stop_human_readable() << "." << std::endl;
 
-    auto [x, y] = generate_linear_dependence_with_noise(std::stod(argv[1]), std::stod(argv[2]), std::normal_distribution(std::stod(argv[3]), std::stod(argv[4])), std::stoul(argv[5]));
+    if (scaling) {
+        benchmark_library::ScalingStudy study([](size_t threads_count) {
+            omp_set_num_threads(static_cast<int>(threads_count));
+        }, threads_counts);
+        auto points = static_cast<double>(points_count);
+        // четыре суммы по сдвинутым данным: 8 операций и два прочитанных вектора double на точку
+        study.run("least_squares", x.size(), 8.0 * points, 2.0 * points * sizeof(double), [&]() {
+            regression_library::find_linear_coefficients(x, y);
+        });
+        // то же через потоковые накопители: блоки копируются из x и y, как будто читаются из файла
+        study.run("linear_fit_accumulator", x.size(), 8.0 * points, 4.0 * points * sizeof(double), [&]() {
+            regression_library::fit_generated_points(x.size(), [&](size_t first_point, size_t count, double *x_block, double *y_block) {
+                std::copy_n(x.begin() + static_cast<std::ptrdiff_t>(first_point), count, x_block);
+                std::copy_n(y.begin() + static_cast<std::ptrdiff_t>(first_point), count, y_block);
+            });
+        });
+        if (robust_option) {
+            study.run("robust_" + robust_option.value(), x.size(), 0.0, 0.0, [&]() {
+                run_robust_fit(robust_option.value(), x, y, dependence.std_noise, seed, false);
+            });
+        }
+        study.write();
+        return 0;
+    }
 
-    auto begin = std::chrono::steady_clock::now();
-    auto [a_estimate, b_estimate] = find_linear_coefficients(x, y);
-    auto end = std::chrono::steady_clock::now();
-    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Calculated in " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    tracing_library::ScopedTimer timer("least_squares");
+    auto [a_estimate, b_estimate] = regression_library::find_linear_coefficients(x, y);
+    std::cout << "Calculated in " << timer.stop_human_readable() << "." << std::endl;
     std::cout << "a = " << a_estimate << std::endl;
     std::cout << "b = " << b_estimate << std::endl;
+
+    if (robust_option) {
+        tracing_library::ScopedTimer timer_robust("least_squares_robust");
+        try {
+            run_robust_fit(robust_option.value(), x, y, dependence.std_noise, seed, true);
+        } catch (const std::invalid_argument &error) {
+            std::cout << error.what() << std::endl;
+            return -1;
+        }
+        std::cout << "Robust fit is calculated in " << timer_robust.stop_human_readable() << "." << std::endl;
+    }
 }
\ No newline at end of file
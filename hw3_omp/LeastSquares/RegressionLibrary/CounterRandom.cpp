@@ -0,0 +1,157 @@
+#include <cmath>
+#include <cstring>
+
+#include "CounterRandom.h"
+#include "SplitMix.h"
+
+/**
+ * Заполняющие циклы компилируются в нескольких вариантах набора инструкций, нужный выбирается при запуске.
+ * Без этого сборка под базовый x86-64 векторизует только по два double и эмулирует 64-битное умножение.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define COUNTER_RANDOM_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define COUNTER_RANDOM_TARGET_CLONES
+#endif
+
+namespace regression_library {
+
+    using benchmark_library::splitmix64;
+
+    namespace {
+
+        /**
+         * @brief Число из [1, 2) из старших 52 случайных бит: биты становятся мантиссой, без преобразования целого в double.
+         * @param bits Случайные биты.
+         * @return Число из [1, 2).
+         */
+        inline double one_to_two(uint64_t bits) {
+            bits = (bits >> 12) | 0x3FF0000000000000ull;
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        /**
+         * @brief Натуральный логарифм числа из (0, 1].
+         * @details u = 2^e * f, f из [sqrt(2) / 2, sqrt(2)), ln f = 2 atanh((f - 1) / (f + 1)) - ряд по нечётным степеням.
+         * @param u Аргумент, не меньше 2^-52.
+         * @return ln(u) с ошибкой не больше 1e-11 - для шума в данных более чем достаточно.
+         */
+        inline double log_unit(double u) {
+            uint64_t bits;
+            std::memcpy(&bits, &u, sizeof(bits));
+            uint64_t exponent_bits = bits >> 52;
+            uint64_t mantissa_bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+            // f > sqrt(2): делим f на 2 уменьшением показателя, всё на целых - без ветвлений
+            const uint64_t large = (0x3FF6A09E667F3BCDull - mantissa_bits) >> 63;
+            mantissa_bits -= large << 52;
+            exponent_bits += large;
+            double f;
+            std::memcpy(&f, &mantissa_bits, sizeof(f));
+            // целое в double через магическое число 2^52: без cvtsi2sd, который не векторизуется
+            uint64_t exponent_magic = exponent_bits | 0x4330000000000000ull;
+            double exponent;
+            std::memcpy(&exponent, &exponent_magic, sizeof(exponent));
+            exponent -= 4503599627370496.0 + 1023.0;
+
+            const double s = (f - 1.0) / (f + 1.0);
+            const double s2 = s * s;
+            const double s4 = s2 * s2;
+            // схема Эстрина вместо Горнера: короче цепочка зависимых умножений
+            const double series = (1.0 + s2 * (1.0 / 3.0)) + s4 * ((1.0 / 5.0 + s2 * (1.0 / 7.0)) +
+                                                                    s4 * (1.0 / 9.0 + s2 * (1.0 / 11.0) + s4 * (1.0 / 13.0)));
+            return exponent * 0.6931471805599453 + 2.0 * s * series;
+        }
+
+        /**
+         * @brief Пара нормальных чисел по преобразованию Бокса-Мюллера.
+         * @details Радиус sqrt(-2 ln u), угол 2 pi v. Оба числа берутся из одного 64-битного значения:
+         * @details старшие 40 бит - u (радиус до 7.4 стандартных отклонений), младшие 24 бита - v.
+         * @details Угол делится на четверть оборота k и остаток theta из [-pi/4, pi/4],
+         * @details синус и косинус остатка - ряды Тейлора, четверть оборота - перестановка и знаки.
+         * @param bits Случайные биты.
+         * @param first Первое число.
+         * @param second Второе число.
+         */
+        inline void box_muller(uint64_t bits, double &first, double &second) {
+            const double u = 2.0 - one_to_two(bits & 0xFFFFFFFFFF000000ull);  // (0, 1]
+            const double radius = std::sqrt(-2.0 * log_unit(u));
+
+            const double turns = 4.0 * (one_to_two(bits << 40) - 1.0);  // [0, 4)
+            // округление до целого магическим числом 1.5 * 2^52: младшие биты - номер четверти
+            const double rounded = turns + 6755399441055744.0;
+            uint64_t rounded_bits;
+            std::memcpy(&rounded_bits, &rounded, sizeof(rounded_bits));
+            const uint64_t quarter = rounded_bits & 3;
+            const double theta = (turns - (rounded - 6755399441055744.0)) * 1.5707963267948966;
+            const double theta2 = theta * theta;
+            const double theta4 = theta2 * theta2;
+
+            // остаток ряда меньше 1e-11 при |theta| <= pi/4
+            const double sine = theta * ((1.0 - theta2 * (1.0 / 6.0)) +
+                                         theta4 * ((1.0 / 120.0 - theta2 * (1.0 / 5040.0)) +
+                                                   theta4 * (1.0 / 362880.0 - theta2 * (1.0 / 39916800.0))));
+            const double cosine = (1.0 - theta2 * 0.5) +
+                                  theta4 * ((1.0 / 24.0 - theta2 * (1.0 / 720.0)) +
+                                            theta4 * ((1.0 / 40320.0 - theta2 * (1.0 / 3628800.0)) +
+                                                      theta4 * (1.0 / 479001600.0)));
+
+            // поворот на k четвертей: (c, s), (-s, c), (-c, -s), (s, -c) - выбор и знаки масками битов
+            uint64_t sine_bits, cosine_bits;
+            std::memcpy(&sine_bits, &sine, sizeof(sine_bits));
+            std::memcpy(&cosine_bits, &cosine, sizeof(cosine_bits));
+            const uint64_t odd_mask = 0 - (quarter & 1);
+            uint64_t x_bits = (sine_bits & odd_mask) | (cosine_bits & ~odd_mask);
+            uint64_t y_bits = (cosine_bits & odd_mask) | (sine_bits & ~odd_mask);
+            x_bits ^= ((quarter + 1) & 2) << 62;
+            y_bits ^= (quarter & 2) << 62;
+            double x, y;
+            std::memcpy(&x, &x_bits, sizeof(x));
+            std::memcpy(&y, &y_bits, sizeof(y));
+            first = radius * x;
+            second = radius * y;
+        }
+    }
+
+    COUNTER_RANDOM_TARGET_CLONES
+    void fill_uniform(uint64_t seed, size_t first_index, size_t count, double lower, double upper, double *output) {
+        const uint64_t key = splitmix64(seed);
+        const double width = upper - lower;
+#pragma omp simd
+        for (size_t i = 0; i < count; ++i) {
+            output[i] = lower + width * (one_to_two(splitmix64(key + first_index + i)) - 1.0);
+        }
+    }
+
+    COUNTER_RANDOM_TARGET_CLONES
+    void fill_normal(uint64_t seed, size_t first_index, size_t count, double mean, double standard_deviation,
+                     double *output) {
+        if (count == 0) {
+            return;
+        }
+        const uint64_t key = splitmix64(seed);
+        size_t i = 0;
+        if (first_index % 2 == 1) {  // вторая половина пары
+            double first, second;
+            box_muller(splitmix64(key + first_index / 2), first, second);
+            output[i++] = mean + standard_deviation * second;
+        }
+        const size_t pairs_count = (count - i) / 2;
+        double *pairs = output + i;
+        const uint64_t first_pair_key = key + (first_index + i) / 2;
+#pragma omp simd
+        for (size_t pair = 0; pair < pairs_count; ++pair) {
+            double first, second;
+            box_muller(splitmix64(first_pair_key + pair), first, second);
+            pairs[2 * pair] = mean + standard_deviation * first;
+            pairs[2 * pair + 1] = mean + standard_deviation * second;
+        }
+        i += 2 * pairs_count;
+        if (i < count) {  // первая половина пары
+            double first, second;
+            box_muller(splitmix64(key + (first_index + i) / 2), first, second);
+            output[i] = mean + standard_deviation * first;
+        }
+    }
+}
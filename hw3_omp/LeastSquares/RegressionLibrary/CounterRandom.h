@@ -0,0 +1,40 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_COUNTERRANDOM_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_COUNTERRANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace regression_library {
+
+    /**
+     * @brief Заполнить массив равномерно распределёнными числами из [lower, upper).
+     * @details Счётный генератор: число с номером index зависит только от зерна и номера (splitmix64 от key + index),
+     * @details поэтому куски одного потока чисел можно генерировать в любом порядке и в разных потоках,
+     * @details а результат не зависит от разбиения на куски и количества потоков.
+     * @param seed Зерно потока чисел.
+     * @param first_index Номер первого числа.
+     * @param count Количество чисел.
+     * @param lower Нижняя граница.
+     * @param upper Верхняя граница.
+     * @param output Массив на count чисел.
+     */
+    void fill_uniform(uint64_t seed, size_t first_index, size_t count, double lower, double upper, double *output);
+
+    /**
+     * @brief Заполнить массив нормально распределёнными числами.
+     * @details Счётный генератор, как fill_uniform. Числа 2k и 2k + 1 - пара преобразования Бокса-Мюллера
+     * @details от k-го 64-битного случайного значения. Логарифм, синус и косинус считаются своими
+     * @details многочленами без ветвлений, поэтому цикл по парам векторизуется, а скалярные края куска
+     * @details дают те же значения, что и векторные.
+     * @param seed Зерно потока чисел.
+     * @param first_index Номер первого числа.
+     * @param count Количество чисел.
+     * @param mean Математическое ожидание.
+     * @param standard_deviation Стандартное отклонение.
+     * @param output Массив на count чисел.
+     */
+    void fill_normal(uint64_t seed, size_t first_index, size_t count, double mean, double standard_deviation,
+                     double *output);
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_COUNTERRANDOM_H
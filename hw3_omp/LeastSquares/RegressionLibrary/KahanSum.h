@@ -0,0 +1,41 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_KAHANSUM_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_KAHANSUM_H
+
+#include <cmath>
+
+namespace regression_library {
+
+    /**
+     * @brief Сумма с компенсацией ошибки округления (алгоритм Кэхэна в варианте Ноймайера).
+     * @details Потерянные при сложении младшие биты копятся в compensation, поэтому ошибка суммы
+     * @details не растёт с количеством слагаемых, даже если слагаемые сильно отличаются по величине.
+     */
+    struct KahanSum {
+        double sum{0.0};
+        double compensation{0.0};
+
+        /**
+         * @brief Прибавить слагаемое.
+         * @param value Слагаемое.
+         */
+        void add(double value) {
+            double total = sum + value;
+            if (std::abs(sum) >= std::abs(value)) {
+                compensation += (sum - total) + value;
+            } else {
+                compensation += (value - total) + sum;
+            }
+            sum = total;
+        }
+
+        /**
+         * @brief Получить сумму.
+         * @return Сумма с учётом компенсации.
+         */
+        double value() const {
+            return sum + compensation;
+        }
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_KAHANSUM_H
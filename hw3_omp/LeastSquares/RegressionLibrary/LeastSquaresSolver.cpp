@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <omp.h>
+
+#include "LeastSquaresSolver.h"
+#include "PerfCounters.h"
+#include "Tracing.h"
+
+namespace regression_library {
+
+    namespace {
+
+        /**
+         * @brief Скопировать строки [X y] в буфер double по столбцам - так удобнее отражениям Хаусхолдера.
+         * @param X Матрица признаков.
+         * @param y Наблюдения.
+         * @param first_row Первая строка.
+         * @param rows_count Количество строк.
+         * @param buffer Буфер, столбец j - buffer[j * rows_count ... (j + 1) * rows_count).
+         */
+        void copy_columns(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                          size_t first_row, size_t rows_count, double *buffer) {
+            const size_t p = X.get_column_count();
+            for (size_t r = 0; r < rows_count; ++r) {
+                const float *row = &X.get_element(first_row + r, 0);
+                for (size_t j = 0; j < p; ++j) {
+                    buffer[j * rows_count + r] = row[j];
+                }
+                buffer[p * rows_count + r] = y.get_element(first_row + r, 0);
+            }
+        }
+
+        /**
+         * @brief QR-разложение отражениями Хаусхолдера на месте. Q не сохраняется.
+         * @param A Матрица rows_count x columns_count по столбцам, rows_count >= columns_count.
+         * @param rows_count Количество строк.
+         * @param columns_count Количество столбцов.
+         * @return Верхний треугольник R по строкам, columns_count x columns_count.
+         */
+        std::vector<double> householder_r(double *A, size_t rows_count, size_t columns_count) {
+            /**
+             * Об алгоритме: Golub, Van Loan, Matrix Computations, 5.2.1.
+             */
+            assert(rows_count >= columns_count);
+            for (size_t k = 0; k < columns_count; ++k) {
+                double *v = A + k * rows_count;
+                double norm_squared = 0.0;
+#pragma omp simd reduction(+:norm_squared)
+                for (size_t i = k; i < rows_count; ++i) {
+                    norm_squared += v[i] * v[i];
+                }
+                if (norm_squared == 0.0) {
+                    continue;
+                }
+                const double alpha = v[k] > 0.0 ? -std::sqrt(norm_squared) : std::sqrt(norm_squared);
+                // v = x - alpha * e1, ||v||^2 = 2 * (||x||^2 - alpha * x_k)
+                const double v_norm_squared = 2.0 * (norm_squared - alpha * v[k]);
+                v[k] -= alpha;
+                for (size_t j = k + 1; j < columns_count; ++j) {
+                    double *a = A + j * rows_count;
+                    double dot = 0.0;
+#pragma omp simd reduction(+:dot)
+                    for (size_t i = k; i < rows_count; ++i) {
+                        dot += v[i] * a[i];
+                    }
+                    const double factor = 2.0 * dot / v_norm_squared;
+#pragma omp simd
+                    for (size_t i = k; i < rows_count; ++i) {
+                        a[i] -= factor * v[i];
+                    }
+                }
+                v[k] = alpha;
+            }
+            std::vector<double> R(columns_count * columns_count, 0.0);
+            for (size_t j = 0; j < columns_count; ++j) {
+                for (size_t i = 0; i <= j; ++i) {
+                    R[i * columns_count + j] = A[j * rows_count + i];
+                }
+            }
+            return R;
+        }
+
+        /**
+         * @brief Узел дерева TSQR: R от двух стоящих друг над другом треугольных матриц.
+         * @param top Верхняя R, size x size по строкам.
+         * @param bottom Нижняя R, size x size по строкам.
+         * @param size Размер R.
+         * @return R от [top; bottom].
+         */
+        std::vector<double> merge_r(const std::vector<double> &top, const std::vector<double> &bottom, size_t size) {
+            std::vector<double> stacked(2 * size * size);
+            for (size_t j = 0; j < size; ++j) {
+                for (size_t i = 0; i < size; ++i) {
+                    stacked[j * 2 * size + i] = top[i * size + j];
+                    stacked[j * 2 * size + size + i] = bottom[i * size + j];
+                }
+            }
+            return householder_r(stacked.data(), 2 * size, size);
+        }
+
+        /**
+         * @brief Решить R beta = c, где R - первые p строк и столбцов треугольника от [X y], а c - его последний столбец.
+         * @details И QR-разложение [X y], и разложение Холецкого его матрицы Грама дают такой треугольник.
+         * @details Бросает std::invalid_argument, если диагональ R вырождена.
+         * @param R Верхний треугольник (p + 1) x (p + 1) по строкам.
+         * @param size Размер R, p + 1.
+         * @return Коэффициенты beta, p штук.
+         */
+        std::vector<double> back_substitution(const std::vector<double> &R, size_t size) {
+            const size_t p = size - 1;
+            double max_diagonal = 0.0;
+            for (size_t i = 0; i < p; ++i) {
+                max_diagonal = std::max(max_diagonal, std::abs(R[i * size + i]));
+            }
+            const double tolerance = static_cast<double>(size) * std::numeric_limits<double>::epsilon() * max_diagonal;
+            std::vector<double> beta(p);
+            for (size_t i = p; i-- > 0;) {
+                if (!(std::abs(R[i * size + i]) > tolerance)) {
+                    throw std::invalid_argument("Columns of the design matrix are linearly dependent.");
+                }
+                double value = R[i * size + p];
+                for (size_t j = i + 1; j < p; ++j) {
+                    value -= R[i * size + j] * beta[j];
+                }
+                beta[i] = value / R[i * size + i];
+            }
+            return beta;
+        }
+    }
+
+    std::vector<double> LeastSquaresSolver::gram_matrix(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                                                        size_t block_rows) {
+        assert(X.get_row_count() == y.get_row_count());
+        assert(y.get_column_count() == 1);
+        assert(block_rows > 0);
+        const size_t n = X.get_row_count();
+        const size_t size = X.get_column_count() + 1;
+        const size_t blocks_count = (n + block_rows - 1) / block_rows;
+
+        TRACE_SCOPE("least_squares_gram_matrix");
+        benchmark_library::PerfRegion region("least_squares_gram_matrix",
+                                             static_cast<double>(n) * static_cast<double>(size * (size + 1)));
+        std::vector<std::vector<double>> thread_grams(static_cast<size_t>(omp_get_max_threads()));
+#pragma omp parallel default(none) shared(X, y, block_rows, n, size, blocks_count, thread_grams)
+        {
+            std::vector<double> gram(size * size, 0.0);
+            std::vector<double> block(block_rows * size);
+#pragma omp for schedule(static)
+            for (size_t b = 0; b < blocks_count; ++b) {
+                const size_t first_row = b * block_rows;
+                const size_t rows_count = std::min(block_rows, n - first_row);
+                copy_columns(X, y, first_row, rows_count, block.data());
+                /**
+                 * Элемент (i, j) - скалярное произведение столбцов i и j блока. Столбец i читается один раз
+                 * на четыре столбца j, суммы копятся в регистрах. Только j >= i: матрица симметрична, как в SYRK.
+                 */
+                for (size_t i = 0; i < size; ++i) {
+                    const double *column_i = block.data() + i * rows_count;
+                    double *gram_row = gram.data() + i * size;
+                    size_t j = i;
+                    for (; j + 4 <= size; j += 4) {
+                        const double *column_0 = block.data() + j * rows_count;
+                        const double *column_1 = column_0 + rows_count;
+                        const double *column_2 = column_1 + rows_count;
+                        const double *column_3 = column_2 + rows_count;
+                        double sum_0 = 0.0;
+                        double sum_1 = 0.0;
+                        double sum_2 = 0.0;
+                        double sum_3 = 0.0;
+#pragma omp simd reduction(+:sum_0, sum_1, sum_2, sum_3)
+                        for (size_t r = 0; r < rows_count; ++r) {
+                            sum_0 += column_i[r] * column_0[r];
+                            sum_1 += column_i[r] * column_1[r];
+                            sum_2 += column_i[r] * column_2[r];
+                            sum_3 += column_i[r] * column_3[r];
+                        }
+                        gram_row[j] += sum_0;
+                        gram_row[j + 1] += sum_1;
+                        gram_row[j + 2] += sum_2;
+                        gram_row[j + 3] += sum_3;
+                    }
+                    for (; j < size; ++j) {
+                        const double *column_j = block.data() + j * rows_count;
+                        double sum = 0.0;
+#pragma omp simd reduction(+:sum)
+                        for (size_t r = 0; r < rows_count; ++r) {
+                            sum += column_i[r] * column_j[r];
+                        }
+                        gram_row[j] += sum;
+                    }
+                }
+            }
+            thread_grams[static_cast<size_t>(omp_get_thread_num())] = std::move(gram);
+        }
+
+        std::vector<double> total(size * size, 0.0);
+        for (const auto &gram: thread_grams) {
+            for (size_t k = 0; k < gram.size(); ++k) {
+                total[k] += gram[k];
+            }
+        }
+        return total;
+    }
+
+    std::vector<double> LeastSquaresSolver::solve_normal_equations(const matrix_library::Matrix &X,
+                                                                   const matrix_library::Matrix &y, size_t block_rows) {
+        const size_t p = X.get_column_count();
+        const size_t size = p + 1;
+        std::vector<double> R = gram_matrix(X, y, block_rows);
+
+        TRACE_SCOPE("least_squares_cholesky");
+        /**
+         * Разложение Холецкого G = R^T R, правостороннее, по первым p строкам. Последний столбец
+         * при этом сам превращается в решение R^T z = X^T y, и остаётся только обратный ход.
+         */
+        for (size_t i = 0; i < p; ++i) {
+            double *pivot_row = R.data() + i * size;
+            if (!(pivot_row[i] > 0.0)) {
+                throw std::invalid_argument("Columns of the design matrix are linearly dependent.");
+            }
+            const double pivot = std::sqrt(pivot_row[i]);
+            for (size_t j = i; j < size; ++j) {
+                pivot_row[j] /= pivot;
+            }
+            for (size_t k = i + 1; k < size; ++k) {
+                double *row = R.data() + k * size;
+                const double factor = pivot_row[k];
+#pragma omp simd
+                for (size_t j = k; j < size; ++j) {
+                    row[j] -= factor * pivot_row[j];
+                }
+            }
+        }
+        return back_substitution(R, size);
+    }
+
+    std::vector<double> LeastSquaresSolver::solve_tsqr(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                                                       size_t block_rows) {
+        /**
+         * Об алгоритме: Demmel, Grigori, Hoemmen, Langou, Communication-optimal parallel and sequential QR and LU factorizations.
+         */
+        assert(X.get_row_count() == y.get_row_count());
+        assert(y.get_column_count() == 1);
+        const size_t n = X.get_row_count();
+        const size_t size = X.get_column_count() + 1;
+        if (n < size) {
+            throw std::invalid_argument("The number of observations must exceed the number of features.");
+        }
+        block_rows = std::max(block_rows, size);
+        // каждый лист получает не меньше block_rows строк, остаток делится между листами
+        const size_t leaves_count = std::max<size_t>(1, n / block_rows);
+
+        TRACE_SCOPE("least_squares_tsqr");
+        benchmark_library::PerfRegion region("least_squares_tsqr",
+                                             2.0 * static_cast<double>(n) * static_cast<double>(size * size));
+        std::vector<std::vector<double>> R(leaves_count);
+#pragma omp parallel default(none) shared(X, y, n, size, leaves_count, R)
+        {
+            std::vector<double> block;
+#pragma omp for schedule(static)
+            for (size_t leaf = 0; leaf < leaves_count; ++leaf) {
+                const size_t first_row = leaf * n / leaves_count;
+                const size_t rows_count = (leaf + 1) * n / leaves_count - first_row;
+                block.resize(rows_count * size);
+                copy_columns(X, y, first_row, rows_count, block.data());
+                R[leaf] = householder_r(block.data(), rows_count, size);
+            }
+        }
+
+        TRACE_SCOPE("least_squares_tsqr_tree");
+        for (size_t step = 1; step < leaves_count; step *= 2) {
+#pragma omp parallel for default(none) shared(size, leaves_count, R, step) schedule(dynamic)
+            for (size_t leaf = 0; leaf < leaves_count; leaf += 2 * step) {
+                if (leaf + step < leaves_count) {
+                    R[leaf] = merge_r(R[leaf], R[leaf + step], size);
+                }
+            }
+        }
+        return back_substitution(R[0], size);
+    }
+
+    matrix_library::Matrix LeastSquaresSolver::polynomial_features(const std::vector<double> &x, size_t degree) {
+        const size_t n = x.size();
+        matrix_library::Matrix X(n, degree + 1);
+#pragma omp parallel for default(none) shared(x, degree, n, X)
+        for (size_t i = 0; i < n; ++i) {
+            double power = 1.0;
+            for (size_t j = 0; j <= degree; ++j) {
+                X.get_element(i, j) = static_cast<float>(power);
+                power *= x[i];
+            }
+        }
+        return X;
+    }
+
+    double LeastSquaresSolver::relative_residual(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                                                 const std::vector<double> &beta) {
+        assert(X.get_column_count() == beta.size());
+        const size_t n = X.get_row_count();
+        const size_t p = X.get_column_count();
+        const double *coefficients = beta.data();
+        double residual_squared = 0.0;
+        double y_squared = 0.0;
+#pragma omp parallel for default(none) shared(X, y, n, p, coefficients) reduction(+:residual_squared, y_squared)
+        for (size_t i = 0; i < n; ++i) {
+            const float *row = &X.get_element(i, 0);
+            double value = y.get_element(i, 0);
+            y_squared += value * value;
+#pragma omp simd reduction(-:value)
+            for (size_t j = 0; j < p; ++j) {
+                value -= row[j] * coefficients[j];
+            }
+            residual_squared += value * value;
+        }
+        return std::sqrt(residual_squared / (y_squared > 0.0 ? y_squared : 1.0));
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_LEASTSQUARESSOLVER_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_LEASTSQUARESSOLVER_H
+
+#include <vector>
+
+#include "Matrix.h"
+
+namespace regression_library {
+
+    /**
+     * @brief Метод наименьших квадратов для линейной модели y = X beta: n наблюдений, p признаков, n >> p.
+     * @details Два способа решения:
+     * @details нормальные уравнения X^T X beta = X^T y - матрица Грама считается блочным параллельным ядром
+     * @details в духе SYRK (только верхний треугольник) и раскладывается по Холецкому. Быстро, но число
+     * @details обусловленности возводится в квадрат, и на плохо обусловленных X (полиномы высокой степени) точность теряется;
+     * @details TSQR (tall-skinny QR) - блоки строк [X y] независимо раскладываются отражениями Хаусхолдера,
+     * @details а получившиеся треугольные R попарно объединяются деревом редукции. Q не хранится: достаточно R
+     * @details от [X y], последний столбец которого - Q^T y. Вдвое больше операций, но устойчиво.
+     * @details Элементы X и y хранятся во float (matrix_library), все вычисления - в double.
+     */
+    class LeastSquaresSolver {
+    public:
+        /**
+         * @brief Решить нормальные уравнения.
+         * @details Бросает std::invalid_argument, если столбцы X линейно зависимы (в пределах точности).
+         * @param X Матрица признаков n x p, n >= p.
+         * @param y Наблюдения, вектор-столбец n x 1.
+         * @param block_rows Количество строк в блоке ядра SYRK.
+         * @return Коэффициенты beta, p штук.
+         */
+        static std::vector<double> solve_normal_equations(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                                                          size_t block_rows = 256);
+
+        /**
+         * @brief Решить через TSQR.
+         * @details Бросает std::invalid_argument, если столбцы X линейно зависимы (в пределах точности).
+         * @param X Матрица признаков n x p, n >= p.
+         * @param y Наблюдения, вектор-столбец n x 1.
+         * @param block_rows Количество строк в листовом блоке. Не меньше p + 1.
+         * @return Коэффициенты beta, p штук.
+         */
+        static std::vector<double> solve_tsqr(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                                              size_t block_rows = 2048);
+
+        /**
+         * @brief Посчитать матрицу Грама [X y]^T [X y] блочным ядром SYRK.
+         * @details Строки делятся на блоки по block_rows, каждый поток копит свою матрицу по своим блокам,
+         * @details затем матрицы потоков складываются. Считается только верхний треугольник.
+         * @param X Матрица признаков n x p.
+         * @param y Наблюдения, вектор-столбец n x 1.
+         * @param block_rows Количество строк в блоке.
+         * @return Верхний треугольник матрицы (p + 1) x (p + 1) по строкам, нижний - нули.
+         */
+        static std::vector<double> gram_matrix(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                                               size_t block_rows = 256);
+
+        /**
+         * @brief Построить матрицу признаков полиномиальной регрессии: строка i - 1, x_i, x_i^2, ..., x_i^degree.
+         * @param x Точки наблюдений.
+         * @param degree Степень полинома.
+         * @return Матрица x.size() x (degree + 1).
+         */
+        static matrix_library::Matrix polynomial_features(const std::vector<double> &x, size_t degree);
+
+        /**
+         * @brief Относительная невязка ||y - X beta|| / ||y||, посчитанная в double.
+         * @param X Матрица признаков n x p.
+         * @param y Наблюдения, вектор-столбец n x 1.
+         * @param beta Коэффициенты, p штук.
+         * @return Относительная невязка.
+         */
+        static double relative_residual(const matrix_library::Matrix &X, const matrix_library::Matrix &y,
+                                        const std::vector<double> &beta);
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_LEASTSQUARESSOLVER_H
@@ -0,0 +1,24 @@
+#include <cassert>
+
+#include "LinearFit.h"
+#include "Tracing.h"
+#include "WeightedMoments.h"
+
+namespace regression_library {
+
+    std::tuple<double, double> find_linear_coefficients(const std::vector<double> &x, const std::vector<double> &y) {
+        assert(x.size() == y.size());
+        assert(x.size() > 1);
+        TRACE_SCOPE("find_linear_coefficients");
+
+        const size_t points_count = x.size();
+        const double shift_x = x[points_count / 2];
+        const double shift_y = y[points_count / 2];
+        auto moments = accumulate_moments(x.data(), y.data(), points_count, shift_x, shift_y,
+                                          [](double, double) { return 1.0; });
+        auto [a_estimate, c_estimate] = shifted_coefficients(moments);
+        double b_estimate = shift_y - a_estimate * shift_x + c_estimate;
+
+        return {a_estimate, b_estimate};
+    }
+}
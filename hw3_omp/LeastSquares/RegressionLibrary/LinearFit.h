@@ -0,0 +1,29 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARFIT_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARFIT_H
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+namespace regression_library {
+
+    /**
+     * @brief Количество точек в куске, который суммируется одним векторизованным циклом (32 Кб x и y - в L1).
+     */
+    const size_t CHUNK_SIZE = 2048;
+
+    /**
+     * @brief Метод наименьших квадратов. Поиск коэффициентов прямой по зашумлённым наблюдениям.
+     * @details Все четыре суммы считаются за один проход по данным. Данные делятся на куски по CHUNK_SIZE точек:
+     * @details внутри куска суммы копятся векторизованным циклом (omp simd), частичные суммы кусков складываются
+     * @details с компенсацией (KahanSum) сначала в потоке, затем между потоками в порядке их номеров.
+     * @details Перед суммированием из x и y вычитается точка из середины выборки: коэффициенты от сдвига не зависят,
+     * @details а разность n * sum(x^2) - sum(x)^2 перестаёт терять точность из-за вычитания близких больших чисел.
+     * @param x Вектор точек, в которых производились наблюдения.
+     * @param y Наблюдаемые значения функции с шумом.
+     * @return Кортеж (a, b) оценок коэффициентов прямой y = a * x + b
+     */
+    std::tuple<double, double> find_linear_coefficients(const std::vector<double> &x, const std::vector<double> &y);
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARFIT_H
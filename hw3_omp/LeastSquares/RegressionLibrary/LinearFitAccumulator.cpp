@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "LinearFit.h"
+#include "LinearFitAccumulator.h"
+
+namespace regression_library {
+
+    void LinearFitAccumulator::add(double x, double y) {
+        /**
+         * Об алгоритме: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Welford's_online_algorithm
+         */
+        ++count_;
+        double dx = x - mean_x_;
+        mean_x_ += dx / static_cast<double>(count_);
+        mean_y_ += (y - mean_y_) / static_cast<double>(count_);
+        deviations_x_ += dx * (x - mean_x_);
+        deviations_x_y_ += dx * (y - mean_y_);
+    }
+
+    void LinearFitAccumulator::add(const double *x, const double *y, size_t count, size_t stride) {
+        assert(stride > 0);
+        /**
+         * Куски объединяются попарно, как при сложении двоичного счётчика: levels[k] хранит 2^k кусков.
+         * Тогда каждое значение проходит через O(log(count)) объединений одинаковых по размеру частей,
+         * и ошибка округления средних не копится, как при добавлении кусков по одному.
+         */
+        std::vector<LinearFitAccumulator> levels;
+        for (size_t begin = 0; begin < count; begin += CHUNK_SIZE) {
+            const size_t chunk_size = std::min(CHUNK_SIZE, count - begin);
+            LinearFitAccumulator carry;
+            if (stride == 1) {
+                carry.add_chunk<1>(x + begin, y + begin, chunk_size, 1);
+            } else if (stride == 2) {
+                carry.add_chunk<2>(x + 2 * begin, y + 2 * begin, chunk_size, 2);
+            } else {
+                carry.add_chunk<0>(x + begin * stride, y + begin * stride, chunk_size, stride);
+            }
+            size_t level = 0;
+            for (; level < levels.size() && levels[level].count_ > 0; ++level) {
+                levels[level].merge(carry);
+                carry = levels[level];
+                levels[level] = LinearFitAccumulator();
+            }
+            if (level == levels.size()) {
+                levels.emplace_back();
+            }
+            levels[level] = carry;
+        }
+        LinearFitAccumulator total;
+        for (auto level = levels.rbegin(); level != levels.rend(); ++level) {
+            total.merge(*level);
+        }
+        merge(total);
+    }
+
+    template<size_t Stride>
+    void LinearFitAccumulator::add_chunk(const double *x, const double *y, size_t count, size_t stride) {
+        assert(count_ == 0 && count > 0);
+        const size_t step = Stride > 0 ? Stride : stride;
+        /**
+         * Суммы считаются от первой точки куска: тогда переход к отклонениям от среднего куска
+         * теряет не больше пары знаков, даже если данные далеко от нуля.
+         */
+        const double shift_x = x[0];
+        const double shift_y = y[0];
+        double sum_x = 0.0;
+        double sum_y = 0.0;
+        double sum_x_squares = 0.0;
+        double sum_prod_x_y = 0.0;
+#pragma omp simd reduction(+:sum_x, sum_y, sum_x_squares, sum_prod_x_y)
+        for (size_t i = 0; i < count; ++i) {
+            double dx = x[i * step] - shift_x;
+            double dy = y[i * step] - shift_y;
+            sum_x += dx;
+            sum_y += dy;
+            sum_x_squares += dx * dx;
+            sum_prod_x_y += dx * dy;
+        }
+        const auto n = static_cast<double>(count);
+        count_ = count;
+        mean_x_ = shift_x + sum_x / n;
+        mean_y_ = shift_y + sum_y / n;
+        deviations_x_ = sum_x_squares - sum_x * sum_x / n;
+        deviations_x_y_ = sum_prod_x_y - sum_x * sum_y / n;
+    }
+
+    void LinearFitAccumulator::merge(const LinearFitAccumulator &other) {
+        /**
+         * Об алгоритме: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+         */
+        if (other.count_ == 0) {
+            return;
+        }
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        const auto n_a = static_cast<double>(count_);
+        const auto n_b = static_cast<double>(other.count_);
+        const double n = n_a + n_b;
+        const double delta_x = other.mean_x_ - mean_x_;
+        const double delta_y = other.mean_y_ - mean_y_;
+        deviations_x_ += other.deviations_x_ + delta_x * delta_x * n_a * n_b / n;
+        deviations_x_y_ += other.deviations_x_y_ + delta_x * delta_y * n_a * n_b / n;
+        mean_x_ += delta_x * n_b / n;
+        mean_y_ += delta_y * n_b / n;
+        count_ += other.count_;
+    }
+
+    size_t LinearFitAccumulator::get_count() const {
+        return count_;
+    }
+
+    double LinearFitAccumulator::get_mean_x() const {
+        return mean_x_;
+    }
+
+    double LinearFitAccumulator::get_mean_y() const {
+        return mean_y_;
+    }
+
+    double LinearFitAccumulator::get_variance_x() const {
+        assert(count_ > 0);
+        return deviations_x_ / static_cast<double>(count_);
+    }
+
+    double LinearFitAccumulator::get_covariance() const {
+        assert(count_ > 0);
+        return deviations_x_y_ / static_cast<double>(count_);
+    }
+
+    std::tuple<double, double> LinearFitAccumulator::get_coefficients() const {
+        assert(count_ > 1);
+        assert(deviations_x_ > 0.0);
+        double a_estimate = deviations_x_y_ / deviations_x_;
+        double b_estimate = mean_y_ - a_estimate * mean_x_;
+        return {a_estimate, b_estimate};
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARFITACCUMULATOR_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARFITACCUMULATOR_H
+
+#include <cstddef>
+#include <tuple>
+
+namespace regression_library {
+
+    /**
+     * @brief Потоковая оценка коэффициентов прямой y = a * x + b: достаточные статистики без хранения точек.
+     * @details Хранит количество точек, средние x и y, сумму квадратов отклонений x от среднего и сумму
+     * @details произведений отклонений x и y (алгоритм Уэлфорда). Точки можно добавлять по одной и кусками,
+     * @details а два накопителя, собранные по разным частям данных, можно объединить (формулы Чана) - поэтому
+     * @details данные делятся между потоками или процессами, и каждый копит свой накопитель.
+     * @details Отклонения считаются от среднего, поэтому точность не теряется на большом количестве точек
+     * @details и при большом сдвиге данных от нуля.
+     */
+    class LinearFitAccumulator {
+    public:
+        /**
+         * @brief Добавить точку.
+         * @param x Точка, в которой производилось наблюдение.
+         * @param y Наблюдаемое значение.
+         */
+        void add(double x, double y);
+
+        /**
+         * @brief Добавить кусок точек.
+         * @details Точки суммируются векторизованным циклом кусками по CHUNK_SIZE, статистики кусков
+         * @details объединяются попарно и затем с накопленными. Шаг позволяет читать x и y, записанные парами подряд.
+         * @param x Указатель на первый x.
+         * @param y Указатель на первый y.
+         * @param count Количество точек.
+         * @param stride Расстояние между соседними x (и соседними y) в элементах.
+         */
+        void add(const double *x, const double *y, size_t count, size_t stride = 1);
+
+        /**
+         * @brief Объединить с накопителем, собранным по другой части данных.
+         * @param other Другой накопитель.
+         */
+        void merge(const LinearFitAccumulator &other);
+
+        /**
+         * @brief Получить количество точек.
+         * @return Количество добавленных точек.
+         */
+        size_t get_count() const;
+
+        /**
+         * @brief Получить среднее x.
+         * @return Среднее x.
+         */
+        double get_mean_x() const;
+
+        /**
+         * @brief Получить среднее y.
+         * @return Среднее y.
+         */
+        double get_mean_y() const;
+
+        /**
+         * @brief Получить выборочную дисперсию x.
+         * @return sum((x - mean_x)^2) / count.
+         */
+        double get_variance_x() const;
+
+        /**
+         * @brief Получить выборочную ковариацию x и y.
+         * @return sum((x - mean_x) * (y - mean_y)) / count.
+         */
+        double get_covariance() const;
+
+        /**
+         * @brief Найти коэффициенты прямой по накопленным точкам.
+         * @details Нужны хотя бы две точки с разными x.
+         * @return Кортеж (a, b) оценок коэффициентов прямой y = a * x + b
+         */
+        std::tuple<double, double> get_coefficients() const;
+
+    private:
+        /**
+         * @brief Заполнить пустой накопитель статистиками одного куска.
+         * @tparam Stride Шаг, известный при компиляции, или 0, если шаг берётся из аргумента.
+         * @param x Указатель на первый x.
+         * @param y Указатель на первый y.
+         * @param count Количество точек, не больше CHUNK_SIZE.
+         * @param stride Шаг, если Stride == 0.
+         */
+        template<size_t Stride>
+        void add_chunk(const double *x, const double *y, size_t count, size_t stride);
+
+        size_t count_{0};
+        double mean_x_{0.0};
+        double mean_y_{0.0};
+        double deviations_x_{0.0};
+        double deviations_x_y_{0.0};
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_LINEARFITACCUMULATOR_H
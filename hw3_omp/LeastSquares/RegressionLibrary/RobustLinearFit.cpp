@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "CounterRandom.h"
+#include "RobustLinearFit.h"
+#include "Tracing.h"
+#include "WeightedMoments.h"
+
+namespace regression_library {
+
+    namespace {
+
+        /**
+         * @brief Количество гипотез RANSAC в раунде, после которого обновляется лучшая прямая.
+         */
+        const size_t RANSAC_ROUND_HYPOTHESES = 64;
+
+        /**
+         * @brief Количество точек, по которым выбирается начальная прямая IRLS.
+         */
+        const size_t LMS_SAMPLE_SIZE = 1 << 12;
+
+        /**
+         * @brief Количество точек, по которым пересчитывается масштаб остатков IRLS.
+         */
+        const size_t SCALE_SAMPLE_SIZE = 1 << 16;
+
+        /**
+         * @brief Отношение стандартного отклонения к медиане модуля нормальной величины.
+         */
+        const double MAD_TO_STD = 1.4826;
+
+        /**
+         * @brief Равномерная выборка из сдвинутых точек, сложенная подряд.
+         */
+        struct Sample {
+            std::vector<double> x;
+            std::vector<double> y;
+        };
+
+        /**
+         * @brief Взять каждую (n / sample_size)-ю точку и сдвинуть её.
+         * @param x Точки наблюдений.
+         * @param y Наблюдения.
+         * @param sample_size Количество точек в выборке, не больше x.size().
+         * @param shift_x Сдвиг x.
+         * @param shift_y Сдвиг y.
+         * @return Выборка dx, dy.
+         */
+        Sample make_sample(const std::vector<double> &x, const std::vector<double> &y, size_t sample_size,
+                           double shift_x, double shift_y) {
+            const size_t points_count = x.size();
+            Sample sample{std::vector<double>(sample_size), std::vector<double>(sample_size)};
+            for (size_t i = 0; i < sample_size; ++i) {
+                size_t index = i * points_count / sample_size;
+                sample.x[i] = x[index] - shift_x;
+                sample.y[i] = y[index] - shift_y;
+            }
+            return sample;
+        }
+
+        /**
+         * @brief Масштаб остатков выборки: 1.4826 * медиана |dy - a * dx - c|.
+         * @details Для прямой, точно проходящей через половину точек, масштаб нулевой, тогда возвращается
+         * @details наименьшее положительное число, чтобы веса оставались определены.
+         */
+        double residual_scale(const Sample &sample, double a, double c) {
+            std::vector<double> residuals(sample.x.size());
+            for (size_t i = 0; i < residuals.size(); ++i) {
+                residuals[i] = std::abs(sample.y[i] - a * sample.x[i] - c);
+            }
+            auto middle = residuals.begin() + static_cast<std::ptrdiff_t>(residuals.size() / 2);
+            std::nth_element(residuals.begin(), middle, residuals.end());
+            return std::max(MAD_TO_STD * *middle, std::numeric_limits<double>::min());
+        }
+
+        /**
+         * @brief Прямая через две точки выборки с номером гипотезы hypothesis: пары выбираются счётным генератором.
+         * @return false, если точки имеют одинаковый x и прямая не определена.
+         */
+        bool hypothesis_line(const Sample &sample, uint64_t seed, size_t hypothesis, double &a, double &c) {
+            const size_t sample_size = sample.x.size();
+            double positions[2];
+            fill_uniform(seed, 2 * hypothesis, 2, 0.0, static_cast<double>(sample_size), positions);
+            size_t i = std::min(static_cast<size_t>(positions[0]), sample_size - 1);
+            size_t j = std::min(static_cast<size_t>(positions[1]), sample_size - 1);
+            if (sample.x[i] == sample.x[j]) {
+                return false;  // вертикальная прямая или одна и та же точка
+            }
+            a = (sample.y[j] - sample.y[i]) / (sample.x[j] - sample.x[i]);
+            c = sample.y[i] - a * sample.x[i];
+            return true;
+        }
+
+        /**
+         * @brief Начальная прямая IRLS: из прямых через пары точек выборки - с наименьшей медианой |r| (LMS).
+         * @details Гипотезы проверяются параллельно, результат от количества потоков не зависит.
+         * @param seed Зерно выбора пар точек.
+         * @param a Коэффициент при dx.
+         * @param c Свободный коэффициент в сдвинутых координатах.
+         * @return Масштаб остатков лучшей прямой.
+         */
+        double least_median_line(const Sample &sample, uint64_t seed, size_t hypotheses_count, double &a, double &c) {
+            std::vector<double> scales(hypotheses_count, std::numeric_limits<double>::infinity());
+            std::vector<double> lines_a(hypotheses_count);
+            std::vector<double> lines_c(hypotheses_count);
+#pragma omp parallel for default(none) shared(sample, seed, hypotheses_count, scales, lines_a, lines_c) schedule(dynamic)
+            for (size_t h = 0; h < hypotheses_count; ++h) {
+                if (hypothesis_line(sample, seed, h, lines_a[h], lines_c[h])) {
+                    scales[h] = residual_scale(sample, lines_a[h], lines_c[h]);
+                }
+            }
+            size_t best = static_cast<size_t>(std::min_element(scales.begin(), scales.end()) - scales.begin());
+            a = lines_a[best];
+            c = lines_c[best];
+            return scales[best];
+        }
+
+        /**
+         * @brief Один проход IRLS: взвешенные суммы с весами функции потерь по остаткам прямой dy = a * dx + c.
+         * @param loss Функция потерь.
+         * @param bound k * s - остаток, с которого вес начинает уменьшаться (Хьюбер) или становится нулевым (Тьюки).
+         */
+        WeightedMoments weighted_pass(RobustLoss loss, const double *x, const double *y, size_t points_count,
+                                      double shift_x, double shift_y, double a, double c, double bound) {
+            if (loss == RobustLoss::HUBER) {
+                return accumulate_moments(x, y, points_count, shift_x, shift_y, [=](double dx, double dy) {
+                    return bound / std::max(std::abs(dy - a * dx - c), bound);
+                });
+            }
+            const double inverse_bound = 1.0 / bound;
+            return accumulate_moments(x, y, points_count, shift_x, shift_y, [=](double dx, double dy) {
+                double u = (dy - a * dx - c) * inverse_bound;
+                double t = std::max(1.0 - u * u, 0.0);
+                return t * t;
+            });
+        }
+
+        /**
+         * @brief Итерации IRLS до сходимости.
+         * @details Сходимость - прямая на отрезке в одно взвешенное среднеквадратичное отклонение dx сдвинулась
+         * @details меньше, чем на tolerance стандартных ошибок s / sqrt(сумма весов): дальше итерации меняют
+         * @details оценку меньше, чем её статистическая погрешность.
+         * @param scale_sample Выборка для пересчёта масштаба после каждой итерации или nullptr, чтобы масштаб не менять.
+         * @param a Коэффициент при dx, обновляется.
+         * @param c Свободный коэффициент в сдвинутых координатах, обновляется.
+         * @param scale Масштаб остатков, обновляется, если передана выборка.
+         * @param weights_sum Сумма весов последней итерации.
+         * @return Количество итераций.
+         */
+        size_t irls_iterations(RobustLoss loss, double tuning_constant, const IrlsOptions &options,
+                               const double *x, const double *y, size_t points_count, double shift_x, double shift_y,
+                               const Sample *scale_sample, double &a, double &c, double &scale, double &weights_sum) {
+            size_t iteration = 0;
+            while (iteration < options.max_iterations) {
+                ++iteration;
+                auto moments = weighted_pass(loss, x, y, points_count, shift_x, shift_y, a, c, tuning_constant * scale);
+                weights_sum = moments.sum_weights.value();
+                if (weights_sum <= 0.0) {
+                    break;  // все точки дальше k * s от прямой, оставляем предыдущую
+                }
+                auto [new_a, new_c] = shifted_coefficients(moments);
+                double spread_x = std::sqrt(moments.sum_x_squares.value() / weights_sum);
+                double shift = std::abs(new_a - a) * spread_x + std::abs(new_c - c);
+                a = new_a;
+                c = new_c;
+                if (scale_sample != nullptr) {
+                    scale = residual_scale(*scale_sample, a, c);
+                }
+                if (shift <= options.tolerance * scale / std::sqrt(weights_sum)) {
+                    break;
+                }
+            }
+            return iteration;
+        }
+
+        /**
+         * @brief Количество инлайеров выборки для прямой dy = a * dx + c.
+         */
+        double count_inliers(const Sample &sample, double a, double c, double threshold) {
+            const double *x = sample.x.data();
+            const double *y = sample.y.data();
+            const size_t sample_size = sample.x.size();
+            double inliers = 0.0;
+#pragma omp simd reduction(+:inliers)
+            for (size_t i = 0; i < sample_size; ++i) {
+                inliers += std::abs(y[i] - a * x[i] - c) <= threshold ? 1.0 : 0.0;
+            }
+            return inliers;
+        }
+    }
+
+    IrlsResult find_irls_linear_coefficients(const std::vector<double> &x, const std::vector<double> &y,
+                                             const IrlsOptions &options) {
+        assert(x.size() == y.size());
+        assert(x.size() > 1);
+        assert(options.sample_size > 1);
+        assert(options.start_hypotheses > 0);
+        TRACE_SCOPE("find_irls_linear_coefficients");
+
+        const size_t points_count = x.size();
+        const double shift_x = x[points_count / 2];
+        const double shift_y = y[points_count / 2];
+        const double tuning_constant = options.tuning_constant > 0.0 ? options.tuning_constant :
+                                       options.loss == RobustLoss::HUBER ? 1.345 : 4.685;
+        const Sample sample = make_sample(x, y, std::min(points_count, options.sample_size), shift_x, shift_y);
+        const Sample scale_sample = make_sample(x, y, std::min(points_count, SCALE_SAMPLE_SIZE), shift_x, shift_y);
+        const size_t sample_size = sample.x.size();
+
+        IrlsResult result;
+        double a, c;
+        result.scale = least_median_line(make_sample(x, y, std::min(points_count, LMS_SAMPLE_SIZE), shift_x, shift_y),
+                                         options.seed, options.start_hypotheses, a, c);
+        result.sample_iterations = irls_iterations(options.loss, tuning_constant, options, sample.x.data(),
+                                                   sample.y.data(), sample_size, 0.0, 0.0, &scale_sample, a, c,
+                                                   result.scale, result.weights_sum);
+        result.iterations = irls_iterations(options.loss, tuning_constant, options, x.data(), y.data(), points_count,
+                                            shift_x, shift_y, nullptr, a, c, result.scale, result.weights_sum);
+
+        result.a = a;
+        result.b = shift_y - a * shift_x + c;
+        return result;
+    }
+
+    RansacResult find_ransac_linear_coefficients(const std::vector<double> &x, const std::vector<double> &y,
+                                                 const RansacOptions &options) {
+        assert(x.size() == y.size());
+        assert(x.size() > 1);
+        if (!(options.threshold > 0.0)) {
+            throw std::invalid_argument("RANSAC threshold must be positive.");
+        }
+        TRACE_SCOPE("find_ransac_linear_coefficients");
+
+        const size_t points_count = x.size();
+        const double shift_x = x[points_count / 2];
+        const double shift_y = y[points_count / 2];
+        const double threshold = options.threshold;
+        const uint64_t seed = options.seed;
+        const Sample sample = make_sample(x, y, std::min(points_count, std::max<size_t>(options.sample_size, 2)),
+                                          shift_x, shift_y);
+        const size_t sample_size = sample.x.size();
+
+        RansacResult result;
+        double best_inliers = 0.0;
+        double best_a = 0.0;
+        double best_c = 0.0;
+        size_t required = options.max_hypotheses;
+        std::vector<double> round_inliers(RANSAC_ROUND_HYPOTHESES);
+        std::vector<double> round_a(RANSAC_ROUND_HYPOTHESES);
+        std::vector<double> round_c(RANSAC_ROUND_HYPOTHESES);
+        while (result.hypotheses_count < required) {
+            const size_t first_hypothesis = result.hypotheses_count;
+#pragma omp parallel for default(none) shared(sample, threshold, seed, first_hypothesis, round_inliers, round_a, round_c) schedule(static)
+            for (size_t h = 0; h < RANSAC_ROUND_HYPOTHESES; ++h) {
+                round_inliers[h] = 0.0;
+                if (hypothesis_line(sample, seed, first_hypothesis + h, round_a[h], round_c[h])) {
+                    round_inliers[h] = count_inliers(sample, round_a[h], round_c[h], threshold);
+                }
+            }
+            // лучшая - с наибольшим количеством инлайеров, при равенстве - с меньшим номером
+            for (size_t h = 0; h < RANSAC_ROUND_HYPOTHESES; ++h) {
+                if (round_inliers[h] > best_inliers) {
+                    best_inliers = round_inliers[h];
+                    best_a = round_a[h];
+                    best_c = round_c[h];
+                }
+            }
+            result.hypotheses_count += RANSAC_ROUND_HYPOTHESES;
+            if (best_inliers > 0.0) {
+                double inliers_fraction = best_inliers / static_cast<double>(sample_size);
+                double needed = std::ceil(std::log1p(-options.confidence) / std::log1p(-inliers_fraction * inliers_fraction));
+                if (needed < static_cast<double>(options.max_hypotheses)) {
+                    required = static_cast<size_t>(std::max(needed, 0.0));
+                }
+            }
+        }
+
+        double a = best_a;
+        double c = best_c;
+        for (size_t iteration = 0; iteration < options.refit_iterations; ++iteration) {
+            auto moments = accumulate_moments(x.data(), y.data(), points_count, shift_x, shift_y,
+                                              [=](double dx, double dy) {
+                                                  return std::abs(dy - a * dx - c) <= threshold ? 1.0 : 0.0;
+                                              });
+            result.inliers_count = static_cast<size_t>(moments.sum_weights.value());
+            if (result.inliers_count < 2) {
+                break;
+            }
+            std::tie(a, c) = shifted_coefficients(moments);
+        }
+
+        result.a = a;
+        result.b = shift_y - a * shift_x + c;
+        return result;
+    }
+}
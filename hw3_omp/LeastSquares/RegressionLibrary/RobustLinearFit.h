@@ -0,0 +1,190 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_ROBUSTLINEARFIT_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_ROBUSTLINEARFIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace regression_library {
+
+    /**
+     * @brief Функция потерь M-оценки.
+     */
+    enum class RobustLoss {
+        HUBER,  // квадратичная около нуля, линейная дальше: вес k * s / max(|r|, k * s)
+        TUKEY  // бивес Тьюки: вес (1 - (r / (k * s))^2)^2, точки дальше k * s не учитываются совсем
+    };
+
+    /**
+     * @brief Параметры итеративного перевзвешивания (IRLS).
+     */
+    struct IrlsOptions {
+        /**
+         * Функция потерь.
+         */
+        RobustLoss loss = RobustLoss::HUBER;
+
+        /**
+         * Константа k в единицах масштаба остатков; 0 - 1.345 для Хьюбера и 4.685 для Тьюки.
+         */
+        double tuning_constant = 0.0;
+
+        /**
+         * Наибольшее количество итераций на выборке и отдельно на всех данных.
+         */
+        size_t max_iterations = 50;
+
+        /**
+         * Итерации останавливаются, когда прямая сдвигается меньше, чем на tolerance стандартных ошибок оценки.
+         */
+        double tolerance = 0.1;
+
+        /**
+         * Количество точек в выборке для первых итераций.
+         */
+        size_t sample_size = 1 << 20;
+
+        /**
+         * Количество прямых через пары точек, из которых выбирается начальная.
+         * 64 пары находят прямую при доле выбросов до 2/3 с вероятностью 0.999.
+         */
+        size_t start_hypotheses = 64;
+
+        /**
+         * Зерно выбора пар точек начальной прямой.
+         */
+        uint64_t seed = 0;
+    };
+
+    /**
+     * @brief Результат IRLS.
+     */
+    struct IrlsResult {
+        /**
+         * Коэффициент при x.
+         */
+        double a = 0.0;
+
+        /**
+         * Свободный коэффициент.
+         */
+        double b = 0.0;
+
+        /**
+         * Масштаб остатков s = 1.4826 * медиана |r|.
+         */
+        double scale = 0.0;
+
+        /**
+         * Сумма весов на последнем проходе - эффективное количество точек.
+         */
+        double weights_sum = 0.0;
+
+        /**
+         * Итерации на выборке.
+         */
+        size_t sample_iterations = 0;
+
+        /**
+         * Проходы по всем данным.
+         */
+        size_t iterations = 0;
+    };
+
+    /**
+     * @brief M-оценка коэффициентов прямой y = a * x + b итеративным перевзвешиванием (IRLS).
+     * @details Каждая итерация - один проход ядром find_linear_coefficients (accumulate_moments), вес точки
+     * @details считается по остатку текущей прямой в том же векторизованном цикле. Первые итерации идут
+     * @details на равномерной выборке из sample_size точек. Начальная прямая - из прямых через пары точек
+     * @details меньшей выборки с наименьшей медианой модуля остатка (LMS): обычный МНК выбросы сдвигают сколь угодно далеко,
+     * @details а функция потерь Тьюки не выпукла, и из плохого приближения итерации сходятся не туда.
+     * @details Масштаб остатков пересчитывается по медиане на выборке после каждой итерации и фиксируется
+     * @details для итераций на всех данных. Итерации на выборке доводят оценку до её статистической точности,
+     * @details поэтому на всех данных остаётся несколько проходов.
+     * @param x Вектор точек, в которых производились наблюдения.
+     * @param y Наблюдаемые значения функции с шумом и выбросами.
+     * @param options Параметры.
+     * @return Коэффициенты и статистика итераций.
+     */
+    IrlsResult find_irls_linear_coefficients(const std::vector<double> &x, const std::vector<double> &y,
+                                             const IrlsOptions &options = IrlsOptions());
+
+    /**
+     * @brief Параметры RANSAC.
+     */
+    struct RansacOptions {
+        /**
+         * Точка - инлайер, если |r| <= threshold.
+         */
+        double threshold = 0.0;
+
+        /**
+         * Вероятность хотя бы раз выбрать пару из двух инлайеров.
+         */
+        double confidence = 0.999;
+
+        /**
+         * Наибольшее количество проверенных прямых.
+         */
+        size_t max_hypotheses = 100000;
+
+        /**
+         * Количество точек, по которым оценивается каждая прямая.
+         */
+        size_t sample_size = 1 << 16;
+
+        /**
+         * Проходы МНК по инлайерам всех данных.
+         */
+        size_t refit_iterations = 2;
+
+        /**
+         * Зерно выбора пар точек.
+         */
+        uint64_t seed = 0;
+    };
+
+    /**
+     * @brief Результат RANSAC.
+     */
+    struct RansacResult {
+        /**
+         * Коэффициент при x.
+         */
+        double a = 0.0;
+
+        /**
+         * Свободный коэффициент.
+         */
+        double b = 0.0;
+
+        /**
+         * Проверенные прямые.
+         */
+        size_t hypotheses_count = 0;
+
+        /**
+         * Инлайеры среди всех данных на последнем проходе.
+         */
+        size_t inliers_count = 0;
+    };
+
+    /**
+     * @brief Оценка коэффициентов прямой y = a * x + b методом RANSAC.
+     * @details Гипотезы - прямые через две случайные точки выборки из sample_size точек, каждая оценивается
+     * @details количеством инлайеров в выборке. Гипотезы проверяются раундами по 64: потоки делят гипотезы
+     * @details раунда, после раунда лучшая прямая обновляется, и по доле её инлайеров w пересчитывается нужное
+     * @details количество гипотез log(1 - confidence) / log(1 - w^2). Как только проверено достаточно, поиск
+     * @details останавливается. Пары выбираются счётным генератором по номеру гипотезы, поэтому результат
+     * @details не зависит от количества потоков. Затем МНК по инлайерам всех данных ядром find_linear_coefficients
+     * @details с весами 0 и 1. Бросает std::invalid_argument, если порог не положителен.
+     * @param x Вектор точек, в которых производились наблюдения.
+     * @param y Наблюдаемые значения функции с шумом и выбросами.
+     * @param options Параметры.
+     * @return Коэффициенты и статистика поиска.
+     */
+    RansacResult find_ransac_linear_coefficients(const std::vector<double> &x, const std::vector<double> &y,
+                                                 const RansacOptions &options);
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_ROBUSTLINEARFIT_H
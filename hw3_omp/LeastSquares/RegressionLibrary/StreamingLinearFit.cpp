@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <omp.h>
+
+#include "StreamingLinearFit.h"
+#include "Tracing.h"
+
+namespace regression_library {
+
+    namespace {
+
+        /**
+         * Сигнатура в начале файла точек.
+         */
+        const char FILE_MAGIC[8] = {'L', 'S', 'Q', 'P', 'T', 'S', '0', '1'};
+
+        /**
+         * @brief Заголовок файла точек. За ним идут пары (x, y), double.
+         */
+        struct FileHeader {
+            char magic[8];
+            uint64_t count;
+        };
+
+        /**
+         * @brief Объединить накопители потоков в порядке их номеров.
+         * @param accumulators Накопители потоков.
+         * @return Общий накопитель.
+         */
+        LinearFitAccumulator merge_all(const std::vector<LinearFitAccumulator> &accumulators) {
+            LinearFitAccumulator total;
+            for (const auto &accumulator: accumulators) {
+                total.merge(accumulator);
+            }
+            return total;
+        }
+    }
+
+    void write_points_file(const std::string &path, size_t points_count, const PointsGenerator &generate,
+                           size_t block_points) {
+        assert(block_points > 0);
+        TRACE_SCOPE("write_points_file");
+        std::ofstream output(path, std::ios_base::binary);
+        if (!output) {
+            throw std::runtime_error("Unable to open the points file for writing: " + path);
+        }
+        FileHeader header{};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.count = points_count;
+        output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        const size_t blocks_count = (points_count + block_points - 1) / block_points;
+#pragma omp parallel default(none) shared(points_count, generate, block_points, blocks_count, output)
+        {
+            std::vector<double> x(block_points);
+            std::vector<double> y(block_points);
+            std::vector<double> pairs(2 * block_points);
+#pragma omp for ordered schedule(static, 1)
+            for (size_t block = 0; block < blocks_count; ++block) {
+                const size_t first_point = block * block_points;
+                const size_t count = std::min(block_points, points_count - first_point);
+                generate(first_point, count, x.data(), y.data());
+                for (size_t i = 0; i < count; ++i) {
+                    pairs[2 * i] = x[i];
+                    pairs[2 * i + 1] = y[i];
+                }
+#pragma omp ordered
+                output.write(reinterpret_cast<const char *>(pairs.data()),
+                             static_cast<std::streamsize>(2 * count * sizeof(double)));
+            }
+        }
+        if (!output) {
+            throw std::runtime_error("Unable to write the points file: " + path);
+        }
+    }
+
+    size_t read_points_count(const std::string &path) {
+        std::ifstream input(path, std::ios_base::binary);
+        if (!input) {
+            throw std::runtime_error("Unable to open the points file: " + path);
+        }
+        FileHeader header{};
+        input.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!input || std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+            throw std::runtime_error("Unrecognized points file format: " + path);
+        }
+        return header.count;
+    }
+
+    LinearFitAccumulator fit_points_file(const std::string &path, size_t block_points) {
+        assert(block_points > 0);
+        TRACE_SCOPE("fit_points_file");
+        const size_t points_count = read_points_count(path);
+        const size_t blocks_count = (points_count + block_points - 1) / block_points;
+        std::vector<LinearFitAccumulator> accumulators(static_cast<size_t>(omp_get_max_threads()));
+        bool failed = false;
+#pragma omp parallel default(none) shared(path, points_count, block_points, blocks_count, accumulators, failed)
+        {
+            /**
+             * У каждого потока свой поток чтения: блоки читаются независимо, без общей позиции в файле.
+             */
+            std::ifstream input(path, std::ios_base::binary);
+            std::vector<double> pairs(2 * block_points);
+            LinearFitAccumulator local;
+#pragma omp for schedule(static)
+            for (size_t block = 0; block < blocks_count; ++block) {
+                const size_t first_point = block * block_points;
+                const size_t count = std::min(block_points, points_count - first_point);
+                input.seekg(static_cast<std::streamoff>(sizeof(FileHeader) + 2 * first_point * sizeof(double)));
+                input.read(reinterpret_cast<char *>(pairs.data()),
+                           static_cast<std::streamsize>(2 * count * sizeof(double)));
+                if (input) {
+                    local.add(pairs.data(), pairs.data() + 1, count, 2);
+                }
+            }
+            if (!input) {
+#pragma omp atomic write
+                failed = true;
+            }
+            accumulators[static_cast<size_t>(omp_get_thread_num())] = local;
+        }
+        if (failed) {
+            throw std::runtime_error("Unable to read the points file: " + path);
+        }
+        return merge_all(accumulators);
+    }
+
+    LinearFitAccumulator fit_generated_points(size_t points_count, const PointsGenerator &generate,
+                                              size_t block_points) {
+        assert(block_points > 0);
+        TRACE_SCOPE("fit_generated_points");
+        const size_t blocks_count = (points_count + block_points - 1) / block_points;
+        std::vector<LinearFitAccumulator> accumulators(static_cast<size_t>(omp_get_max_threads()));
+#pragma omp parallel default(none) shared(points_count, generate, block_points, blocks_count, accumulators)
+        {
+            std::vector<double> x(block_points);
+            std::vector<double> y(block_points);
+            LinearFitAccumulator local;
+#pragma omp for schedule(static)
+            for (size_t block = 0; block < blocks_count; ++block) {
+                const size_t first_point = block * block_points;
+                const size_t count = std::min(block_points, points_count - first_point);
+                generate(first_point, count, x.data(), y.data());
+                local.add(x.data(), y.data(), count);
+            }
+            accumulators[static_cast<size_t>(omp_get_thread_num())] = local;
+        }
+        return merge_all(accumulators);
+    }
+}
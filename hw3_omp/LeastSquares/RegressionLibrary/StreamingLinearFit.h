@@ -0,0 +1,66 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_STREAMINGLINEARFIT_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_STREAMINGLINEARFIT_H
+
+#include <functional>
+#include <string>
+
+#include "LinearFitAccumulator.h"
+
+namespace regression_library {
+
+    /**
+     * @brief Количество точек в блоке, который поток генерирует или читает из файла за раз (16 Мб).
+     */
+    const size_t STREAM_BLOCK_POINTS = size_t(1) << 20;
+
+    /**
+     * @brief Источник точек: заполняет x и y точками с номерами [first_point, first_point + count).
+     * @details Вызывается из нескольких потоков одновременно для разных блоков, поэтому точки должны
+     * @details зависеть только от своих номеров (например, генератор с зерном от номера блока).
+     */
+    using PointsGenerator = std::function<void(size_t first_point, size_t count, double *x, double *y)>;
+
+    /**
+     * @brief Записать точки в файл, не держа их в памяти целиком.
+     * @details Формат: заголовок {char magic[8] = "LSQPTS01", uint64 count}, затем пары (x, y) типа double.
+     * @details Блоки генерируются параллельно и записываются по порядку.
+     * @details Бросает std::runtime_error, если файл не удалось открыть или записать.
+     * @param path Путь к файлу.
+     * @param points_count Количество точек.
+     * @param generate Источник точек.
+     * @param block_points Количество точек в блоке.
+     */
+    void write_points_file(const std::string &path, size_t points_count, const PointsGenerator &generate,
+                           size_t block_points = STREAM_BLOCK_POINTS);
+
+    /**
+     * @brief Прочитать количество точек из заголовка файла.
+     * @details Бросает std::runtime_error, если файл не удалось открыть или формат не распознан.
+     * @param path Путь к файлу.
+     * @return Количество точек.
+     */
+    size_t read_points_count(const std::string &path);
+
+    /**
+     * @brief Найти коэффициенты прямой по точкам из файла, читая его блоками.
+     * @details Каждый поток открывает файл сам и читает свои блоки, накопители потоков объединяются
+     * @details в порядке номеров потоков. Памяти нужно по блоку на поток, файл может быть больше памяти.
+     * @details Бросает std::runtime_error, если файл не удалось открыть или прочитать.
+     * @param path Путь к файлу.
+     * @param block_points Количество точек в блоке.
+     * @return Накопитель по всем точкам файла.
+     */
+    LinearFitAccumulator fit_points_file(const std::string &path, size_t block_points = STREAM_BLOCK_POINTS);
+
+    /**
+     * @brief Найти коэффициенты прямой по точкам, которые генерируются блоками и нигде не хранятся.
+     * @param points_count Количество точек.
+     * @param generate Источник точек.
+     * @param block_points Количество точек в блоке.
+     * @return Накопитель по всем точкам.
+     */
+    LinearFitAccumulator fit_generated_points(size_t points_count, const PointsGenerator &generate,
+                                              size_t block_points = STREAM_BLOCK_POINTS);
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_STREAMINGLINEARFIT_H
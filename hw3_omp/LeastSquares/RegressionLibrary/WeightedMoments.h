@@ -0,0 +1,111 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_WEIGHTEDMOMENTS_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_WEIGHTEDMOMENTS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include <omp.h>
+
+#include "KahanSum.h"
+#include "LinearFit.h"
+
+namespace regression_library {
+
+    /**
+     * @brief Взвешенные суммы, по которым считаются коэффициенты прямой: w, w * x, w * y, w * x^2 и w * x * y.
+     * @details x и y здесь - отклонения от точки сдвига.
+     */
+    struct WeightedMoments {
+        KahanSum sum_weights;
+        KahanSum sum_x;
+        KahanSum sum_y;
+        KahanSum sum_x_squares;
+        KahanSum sum_prod_x_y;
+    };
+
+    /**
+     * @brief Посчитать взвешенные суммы за один проход по данным.
+     * @details Ядро find_linear_coefficients: куски по CHUNK_SIZE точек делятся между потоками, внутри куска суммы
+     * @details копятся векторизованным циклом, частичные суммы кусков складываются с компенсацией сначала в потоке,
+     * @details затем между потоками в порядке их номеров. Вес считается по сдвинутой точке в том же цикле,
+     * @details поэтому для векторизации он не должен ветвиться.
+     * @tparam Weight Функция (dx, dy) -> вес точки.
+     * @param x Указатель на первый x.
+     * @param y Указатель на первый y.
+     * @param points_count Количество точек.
+     * @param shift_x Сдвиг x.
+     * @param shift_y Сдвиг y.
+     * @param weight Вес точки.
+     * @return Суммы по отклонениям dx = x - shift_x, dy = y - shift_y.
+     */
+    template <typename Weight>
+    WeightedMoments accumulate_moments(const double *x, const double *y, size_t points_count,
+                                       double shift_x, double shift_y, Weight weight) {
+        const size_t chunks_count = (points_count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        std::vector<WeightedMoments> thread_moments(static_cast<size_t>(omp_get_max_threads()));
+        WeightedMoments *moments = thread_moments.data();
+
+#pragma omp parallel default(none) shared(x, y, points_count, chunks_count, shift_x, shift_y, weight, moments)
+        {
+            WeightedMoments local;
+#pragma omp for schedule(static) nowait
+            for (size_t chunk = 0; chunk < chunks_count; ++chunk) {
+                const size_t begin = chunk * CHUNK_SIZE;
+                const size_t end = std::min(points_count, begin + CHUNK_SIZE);
+                double sum_weights = 0.0;
+                double sum_x = 0.0;
+                double sum_y = 0.0;
+                double sum_x_squares = 0.0;
+                double sum_prod_x_y = 0.0;
+#pragma omp simd reduction(+:sum_weights, sum_x, sum_y, sum_x_squares, sum_prod_x_y)
+                for (size_t i = begin; i < end; ++i) {
+                    double dx = x[i] - shift_x;
+                    double dy = y[i] - shift_y;
+                    double w = weight(dx, dy);
+                    double w_dx = w * dx;
+                    sum_weights += w;
+                    sum_x += w_dx;
+                    sum_y += w * dy;
+                    sum_x_squares += w_dx * dx;
+                    sum_prod_x_y += w_dx * dy;
+                }
+                local.sum_weights.add(sum_weights);
+                local.sum_x.add(sum_x);
+                local.sum_y.add(sum_y);
+                local.sum_x_squares.add(sum_x_squares);
+                local.sum_prod_x_y.add(sum_prod_x_y);
+            }
+            moments[omp_get_thread_num()] = local;
+        }
+
+        WeightedMoments total;
+        for (const auto &thread: thread_moments) {
+            total.sum_weights.add(thread.sum_weights.value());
+            total.sum_x.add(thread.sum_x.value());
+            total.sum_y.add(thread.sum_y.value());
+            total.sum_x_squares.add(thread.sum_x_squares.value());
+            total.sum_prod_x_y.add(thread.sum_prod_x_y.value());
+        }
+        return total;
+    }
+
+    /**
+     * @brief Коэффициенты взвешенной прямой в сдвинутых координатах: dy = a * dx + c.
+     * @details Сумма весов должна быть положительной, а взвешенные dx - не все равны.
+     * @param moments Суммы accumulate_moments.
+     * @return Кортеж (a, c).
+     */
+    inline std::tuple<double, double> shifted_coefficients(const WeightedMoments &moments) {
+        const double sum_weights = moments.sum_weights.value();
+        const double sum_x = moments.sum_x.value();
+        const double sum_y = moments.sum_y.value();
+        double a = (sum_weights * moments.sum_prod_x_y.value() - sum_x * sum_y) /
+                   (sum_weights * moments.sum_x_squares.value() - sum_x * sum_x);
+        double c = (sum_y - a * sum_x) / sum_weights;
+        return {a, c};
+    }
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_WEIGHTEDMOMENTS_H
@@ -1,10 +1,19 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
 #include <random>
 #include <iostream>
-#include <iomanip>
-#include <chrono>
+#include <sstream>
 
 #include <omp.h>
 
+#include "MonteCarloIntegration.h"
+#include "Scaling.h"
+#include "SplitMix.h"
+#include "Tracing.h"
+#include "XoshiroLanes.h"
+
 /**
  * @brief Класс для промежуточной потоковой записи перед отправкой в shared поток.
  */
@@ -23,15 +32,85 @@ private:
     std::stringstream stream_;
 };
 
+using monte_carlo::LANES;
+using monte_carlo::XoshiroLanes;
+
+/**
+ * @brief Посчитать точки, попавшие в круг: все генераторы делают шаг одновременно, LANES точек за шаг.
+ * @details Сравнение с кругом векторизованно даёт маску, которая прибавляется к счётчикам попаданий
+ * @details каждого генератора без ветвлений. Счётчики 32-битные, поэтому сливаются в общий через каждые 2^24 шага.
+ * @param generator Генераторы, состояние продвигается.
+ * @param points_count Количество точек. Если оно не кратно LANES, в последнем шаге лишние точки не считаются.
+ * @return Количество точек в круге.
+ */
+MONTE_CARLO_TARGET_CLONES
+size_t count_in_circle_points(XoshiroLanes &generator, size_t points_count) {
+    uint32_t s0[LANES], s1[LANES], s2[LANES], s3[LANES];
+    std::copy_n(generator.s0, LANES, s0);
+    std::copy_n(generator.s1, LANES, s1);
+    std::copy_n(generator.s2, LANES, s2);
+    std::copy_n(generator.s3, LANES, s3);
+
+    const size_t steps_per_flush = size_t(1) << 24;
+    size_t in_circle_points = 0;
+    size_t steps_count = (points_count + LANES - 1) / LANES;
+    for (size_t step = 0; step < steps_count; step += steps_per_flush) {
+        const size_t block_steps = std::min(steps_per_flush, steps_count - step);
+        uint32_t hits[LANES] = {};
+        for (size_t block_step = 0; block_step < block_steps; ++block_step) {
+            // в последнем шаге считаются только первые active точек
+            const size_t first_point = (step + block_step) * LANES;
+            const uint32_t active = static_cast<uint32_t>(std::min(LANES, points_count - first_point));
+#pragma omp simd
+            for (uint32_t lane = 0; lane < LANES; ++lane) {
+                float x = XoshiroLanes::to_coordinate(XoshiroLanes::next(s0[lane], s1[lane], s2[lane], s3[lane]));
+                float y = XoshiroLanes::to_coordinate(XoshiroLanes::next(s0[lane], s1[lane], s2[lane], s3[lane]));
+                hits[lane] += static_cast<uint32_t>(x * x + y * y <= 1.0f) & static_cast<uint32_t>(lane < active);
+            }
+        }
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            in_circle_points += hits[lane];
+        }
+    }
+
+    std::copy_n(s0, LANES, generator.s0);
+    std::copy_n(s1, LANES, generator.s1);
+    std::copy_n(s2, LANES, generator.s2);
+    std::copy_n(s3, LANES, generator.s3);
+    return in_circle_points;
+}
+
+/**
+ * @brief То же, что count_in_circle_points, но каждая точка печатается. Для отладки на небольшом количестве точек.
+ */
+size_t count_in_circle_points_verbose(XoshiroLanes &generator, size_t points_count) {
+    size_t in_circle_points = 0;
+    for (size_t first_point = 0; first_point < points_count; first_point += LANES) {
+        for (size_t lane = 0; lane < std::min(LANES, points_count - first_point); ++lane) {
+            float x = XoshiroLanes::to_coordinate(XoshiroLanes::next(generator.s0[lane], generator.s1[lane],
+                                                                     generator.s2[lane], generator.s3[lane]));
+            float y = XoshiroLanes::to_coordinate(XoshiroLanes::next(generator.s0[lane], generator.s1[lane],
+                                                                     generator.s2[lane], generator.s3[lane]));
+            std::cout << (ParallelStream() << "Thread №" << omp_get_thread_num() << " generated point (" << x << ";" << y <<"). \n").str();
+            if (x * x + y * y <= 1) {  // проверка, принадлежат ли точки кругу
+                ++in_circle_points;
+            }
+        }
+    }
+    return in_circle_points;
+}
+
 /**
  * @brief Вычисление числа Пи методом Монте-Карло.
  * @details Вычисление производится параллельно. Используется OMP.
  * @details Для выбора количества потоков нужно вызвать omp_set_num_threads или установить переменную окружения OMP_NUM_THREADS до вызова этой функции.
+ * @details Каждый поток считает свою часть точек своими LANES генераторами (XoshiroLanes), которые шагают одновременно.
  * @param points_count Количество точек, которые генерируются для оценки числа Пи.
+ * @param seed Зерно: при одном зерне и одном количестве потоков результат повторяется.
  * @param verbose True, если требуется вывод в консоль отладочных сообщений, иначе - false.
  * @return Оценённое значение числа Пи.
  */
-float calculate_pi_with_monte_carlo(size_t points_count=100, bool verbose=false) {
+float calculate_pi_with_monte_carlo(size_t points_count=100, uint64_t seed=0, bool verbose=false) {
     /**
      * Случайным образом кидаете точку в единичный квадрат.
      * В этот же квадрат вписан круг.
@@ -42,8 +121,9 @@ float calculate_pi_with_monte_carlo(size_t points_count=100, bool verbose=false)
 
     size_t in_circle_points = 0;  // общее количество попавших в круг точек
 
-#pragma omp parallel default(none) shared(points_count, in_circle_points, verbose, std::cout)
+#pragma omp parallel default(none) shared(points_count, seed, in_circle_points, verbose, std::cout)
     {
+        TRACE_SCOPE("monte_carlo_thread");
 #pragma omp single
         {  // вывод отладочной информации о количестве запущенных потоков.
             if (verbose) {
@@ -51,74 +131,170 @@ float calculate_pi_with_monte_carlo(size_t points_count=100, bool verbose=false)
             }
         }
 
-        // Инициализируем генератор случайных чисел. Seed в каждом потоке должен быть разный.
-        std::random_device rd;
-        uint32_t seed = rd();
-        seed = (seed & 0xFFFFFFF0) | (omp_get_thread_num() + 1);  // привязываем seed к номеру потока
-        std::mt19937 gen(seed);
-        std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+        // статическое разбиение, как у schedule(static): потоку достаётся отрезок точек подряд
+        const auto threads_count = static_cast<size_t>(omp_get_num_threads());
+        const auto thread_number = static_cast<size_t>(omp_get_thread_num());
+
+        // потоки засеваются, как в integrate_in_rounds: у каждого свои 2 * LANES начальных значений подряд
+        XoshiroLanes generator(benchmark_library::splitmix64(seed) + thread_number * 2 * LANES);
+        const size_t local_points_count = points_count / threads_count + (thread_number < points_count % threads_count ? 1 : 0);
 
         /**
          * Чтобы реже делать блокировки при обращении к in_circle_points,
          * я в каждом потоке отдельно подсчитываю это значение в local_in_circle_points,
          * а потом только единожды суммирую с общим.
+         * Проверка verbose вынесена из цикла: печатающий вариант - отдельная функция.
          */
-        size_t local_in_circle_points = 0;
-#pragma omp for schedule(static)
-        for (size_t i = 0; i < points_count; ++i) {
-            float x = dis(gen);
-            float y = dis(gen);
-            if (verbose){  // вывод отладочной информации о сгенерированной точке.
-                std::cout << (ParallelStream() << "Thread №" << omp_get_thread_num() << " generated point (" << x << ";" << y <<"). \n").str();
-            }
-            if (x * x + y * y <= 1) {  // проверка, принадлежат ли точки кругу
-                ++local_in_circle_points;
-            }
-        }
+        size_t local_in_circle_points = verbose ? count_in_circle_points_verbose(generator, local_points_count) :
+                                        count_in_circle_points(generator, local_points_count);
 #pragma omp atomic
         in_circle_points += local_in_circle_points;
     }
 
-    // рассчитаем pi
-    const float total_square = 4.0f;
-    float square_relation_monte_carlo = static_cast<float >(points_count) / static_cast<float >(in_circle_points);
-    float pi = total_square / square_relation_monte_carlo;
+    // рассчитаем pi, отношение считается в double: во float счётчики точек больше 2^24 округляются
+    const double total_square = 4.0;
+    double square_relation_monte_carlo = static_cast<double>(points_count) / static_cast<double>(in_circle_points);
+    auto pi = static_cast<float>(total_square / square_relation_monte_carlo);
 
     return pi;
 }
 
 /**
- * @brief Конвертирует количество микросекунд в человекопонятный формат.
- * @param duration_us Длительность в микросекундах.
- * @return Строка с человекопонятной записью.
+ * @brief Функция стандартного нормального распределения.
  */
-std::string convert_us_to_human_readable(uint64_t duration_us){
-    if (duration_us < 1e3) {
-        return std::to_string(duration_us) + " us";
-    }
+double normal_cdf(double x) {
+    return 0.5 * std::erfc(-x * 0.7071067811865476);
+}
 
-    std::stringstream ss;
-    ss << std::fixed;
-    ss << std::setprecision(2);
-    if (duration_us < 1e6) {
-        ss << static_cast<double>(duration_us) / 1e3 << " ms";
-        return ss.str();
-    }
-    if (duration_us < 1e9) {
-        ss << static_cast<double>(duration_us) / 1e6 << " s";
-        return ss.str();
-    }
-    if (duration_us < 1e9 * 60) {
-        ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
-        return ss.str();
+/**
+ * @brief Вычислить интеграл движком monte_carlo_integrate и напечатать его рядом с точным значением.
+ * @param name Название интеграла.
+ * @param integrand Функция от BatchPoint<Dim> по значению.
+ * @param domain Область.
+ * @param exact Точное значение интеграла.
+ * @param points_count Количество точек (с целевой ошибкой - наибольшее).
+ * @param options Параметры интегрирования.
+ * @param scaling True, если нужно сравнение по количеству потоков, иначе - один расчёт.
+ * @param threads_counts Количества потоков для сравнения.
+ */
+template <size_t Dim, typename Integrand>
+void run_integral(const std::string &name, const Integrand &integrand, const monte_carlo::Domain<Dim> &domain,
+                  double exact, size_t points_count, const monte_carlo::IntegrationOptions &options,
+                  bool scaling, const std::vector<size_t> &threads_counts) {
+    if (scaling) {
+        benchmark_library::ScalingStudy study([](size_t threads_count) {
+            omp_set_num_threads(static_cast<int>(threads_count));
+        }, threads_counts);
+        study.run("monte_carlo_" + name, points_count, 0.0, 0.0, [&]() {
+            monte_carlo::monte_carlo_integrate(integrand, domain, points_count, options);
+        });
+        study.write();
+        return;
     }
 
-    return std::to_string(duration_us) + " us";
+    tracing_library::ScopedTimer timer("monte_carlo_integral");
+    const monte_carlo::IntegrationResult result = monte_carlo::monte_carlo_integrate(integrand, domain, points_count, options);
+    const double microseconds = timer.stop();
+    std::cout << "Integral " << name << " (dimension " << Dim << ") is calculated by " << result.samples_count
+              << " points in " << microseconds / 1000.0 << " ms ("
+              << microseconds * 1000.0 / static_cast<double>(result.samples_count) << " ns per point, "
+              << result.rounds_count << " rounds)." << std::endl;
+    std::cout << "Value " << result.value << ", standard error " << result.standard_error << ", "
+              << options.confidence * 100.0 << "% confidence interval [" << result.confidence_lower << "; "
+              << result.confidence_upper << "]." << std::endl;
+    std::cout << "Exact value " << exact << ", error is " << std::abs(result.value - exact) / result.standard_error
+              << " standard errors." << std::endl;
+}
+
+/**
+ * @brief Вычислить один из примеров интегралов.
+ * @details circle - площадь единичного круга, pi: индикатор на [-1, 1]^2, то же, что считает calculate_pi_with_monte_carlo.
+ * @details peak - интеграл Генца "product peak" по [0, 1]^6: произведение 1 / (0.25 + (x_d - 0.5)^2), точно pi^6.
+ * @details call - европейский опцион колл в модели Блэка-Шоулза: цена в момент T - S0 exp((r - sigma^2 / 2) T + sigma sqrt(T) z),
+ * @details z - нормальное число из двух равномерных (Бокс-Мюллер); точно - формула Блэка-Шоулза.
+ * @details asian - азиатский опцион колл на среднее геометрическое 16 цен через равные промежутки: 16 приращений
+ * @details броуновского движения из 16 равномерных чисел; логарифм среднего нормален, поэтому тоже есть точная формула.
+ * @param name Название интеграла.
+ * @param points_count Количество точек (с целевой ошибкой - наибольшее).
+ * @param options Параметры интегрирования.
+ * @param scaling True, если нужно сравнение по количеству потоков, иначе - один расчёт.
+ * @param threads_counts Количества потоков для сравнения.
+ * @return False, если интеграла с таким названием нет.
+ */
+bool run_named_integral(const std::string &name, size_t points_count, const monte_carlo::IntegrationOptions &options,
+                        bool scaling, const std::vector<size_t> &threads_counts) {
+    const double pi = 3.141592653589793;
+    // параметры опционов: цена актива, цена исполнения, ставка, волатильность, срок в годах
+    const double spot = 100.0;
+    const double strike = 100.0;
+    const double rate = 0.05;
+    const double volatility = 0.2;
+    const double maturity = 1.0;
+    const double discount = std::exp(-rate * maturity);
+
+    if (name == "circle") {
+        monte_carlo::Domain<2> domain;
+        domain.lower.fill(-1.0);
+        domain.upper.fill(1.0);
+        run_integral(name, [](monte_carlo::BatchPoint<2> x) {
+            return x[0] * x[0] + x[1] * x[1] <= 1.0 ? 1.0 : 0.0;
+        }, domain, pi, points_count, options, scaling, threads_counts);
+    } else if (name == "peak") {
+        const size_t dimensions = 6;
+        run_integral(name, [](monte_carlo::BatchPoint<dimensions> x) {
+            double denominator = 1.0;  // одно деление на точку вместо шести
+            for (size_t d = 0; d < dimensions; ++d) {
+                denominator *= 0.25 + (x[d] - 0.5) * (x[d] - 0.5);
+            }
+            return 1.0 / denominator;
+        }, monte_carlo::unit_cube<dimensions>(), std::pow(pi, 6.0), points_count, options, scaling, threads_counts);
+    } else if (name == "call") {
+        const double drift = (rate - 0.5 * volatility * volatility) * maturity;
+        const double diffusion = volatility * std::sqrt(maturity);
+        const double d1 = (std::log(spot / strike) + drift + diffusion * diffusion) / diffusion;
+        const double exact = spot * normal_cdf(d1) - strike * discount * normal_cdf(d1 - diffusion);
+        run_integral(name, [=](monte_carlo::BatchPoint<2> u) {
+            const double z = std::sqrt(-2.0 * std::log(u[0])) * std::cos(2.0 * pi * u[1]);
+            return discount * std::max(spot * std::exp(drift + diffusion * z) - strike, 0.0);
+        }, monte_carlo::unit_cube<2>(), exact, points_count, options, scaling, threads_counts);
+    } else if (name == "asian") {
+        const size_t fixings = 16;
+        const auto n = static_cast<double>(fixings);
+        // ln G = ln S0 + (r - sigma^2 / 2) T (n + 1) / (2 n) + sigma sqrt(T / n) / n * sum((n - k) z_k)
+        const double log_mean = std::log(spot) + (rate - 0.5 * volatility * volatility) * maturity * (n + 1.0) / (2.0 * n);
+        const double step_diffusion = volatility * std::sqrt(maturity / n) / n;
+        const double log_variance = volatility * volatility * maturity * (n + 1.0) * (2.0 * n + 1.0) / (6.0 * n * n);
+        const double d2 = (log_mean - std::log(strike)) / std::sqrt(log_variance);
+        const double exact = discount * (std::exp(log_mean + 0.5 * log_variance) * normal_cdf(d2 + std::sqrt(log_variance)) -
+                                         strike * normal_cdf(d2));
+        run_integral(name, [=](monte_carlo::BatchPoint<fixings> u) {
+            double weighted_sum = 0.0;
+            for (size_t k = 0; k < fixings; k += 2) {  // пара приращений из пары равномерных чисел
+                const double radius = std::sqrt(-2.0 * std::log(u[k]));
+                // sin(2 pi v) = cos(2 pi (v - 1/4)): синус и косинус одного угла GCC сливает в скалярный sincos,
+                // и цикл не векторизуется
+                const double cosine = std::cos(2.0 * pi * u[k + 1]);
+                const double sine = std::cos(2.0 * pi * (u[k + 1] - 0.25));
+                weighted_sum += static_cast<double>(fixings - k) * radius * cosine +
+                                static_cast<double>(fixings - k - 1) * radius * sine;
+            }
+            return discount * std::max(std::exp(log_mean + step_diffusion * weighted_sum) - strike, 0.0);
+        }, monte_carlo::unit_cube<fixings>(), exact, points_count, options, scaling, threads_counts);
+    } else {
+        return false;
+    }
+    return true;
 }
 
 int main(int argc, char *argv[]) {
+    std::vector<size_t> threads_counts;
+    bool scaling = benchmark_library::handle_scaling_option(argc, argv, threads_counts);
+    std::optional<std::string> integral_option = benchmark_library::take_option(argc, argv, "--integral=");
+    std::optional<std::string> target_error_option = benchmark_library::take_option(argc, argv, "--target-error=");
+    std::optional<std::string> seed_option = benchmark_library::take_option(argc, argv, "--seed=");
+
     if (argc < 2) {
-        std::cout << "Specify the point count.";
+        std::cout << "Specify the point count: path_to_program points_count [verbose] [--seed=<n>] [--integral=circle|peak|call|asian [--target-error=<e>]].";
         return -1;
     }
     const size_t points_count = std::stoul(argv[1]);  // первым параметром передано количество точек
@@ -138,11 +314,32 @@ int main(int argc, char *argv[]) {
      *  установкой переменной окружения export OMP_NUM_THREADS=4
      */
 
-    auto begin = std::chrono::steady_clock::now();
-    float pi = calculate_pi_with_monte_carlo(points_count, verbose);
-    auto end = std::chrono::steady_clock::now();
-    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Pi is calculated by " << points_count << " points in " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    const uint64_t seed = seed_option ? std::stoull(seed_option.value()) : std::random_device{}();
+    if (integral_option) {
+        monte_carlo::IntegrationOptions options;
+        options.target_standard_error = target_error_option ? std::stod(target_error_option.value()) : 0.0;
+        options.seed = seed;
+        if (!run_named_integral(integral_option.value(), points_count, options, scaling, threads_counts)) {
+            std::cout << "Unknown integral " << integral_option.value() << ", use circle, peak, call or asian.";
+            return -1;
+        }
+        return 0;
+    }
+
+    if (scaling) {
+        benchmark_library::ScalingStudy study([](size_t threads_count) {
+            omp_set_num_threads(static_cast<int>(threads_count));
+        }, threads_counts);
+        study.run("monte_carlo", points_count, 0.0, 0.0, [&]() {
+            calculate_pi_with_monte_carlo(points_count, seed, false);
+        });
+        study.write();
+        return 0;
+    }
+
+    tracing_library::ScopedTimer timer("monte_carlo");
+    float pi = calculate_pi_with_monte_carlo(points_count, seed, verbose);
+    std::cout << "Pi is calculated by " << points_count << " points in " << timer.stop_human_readable() << "." << std::endl;
     std::cout << "Pi approximately equal " << pi << std::endl;
 
     return 0;
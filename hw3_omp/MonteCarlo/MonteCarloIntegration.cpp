@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <omp.h>
+
+#include "MonteCarloIntegration.h"
+#include "SplitMix.h"
+
+namespace monte_carlo {
+
+    void SampleStatistics::merge(const SampleStatistics &other) {
+        if (other.count == 0) {
+            return;
+        }
+        const double total = static_cast<double>(count + other.count);
+        const double delta = other.mean - mean;
+        mean += delta * (static_cast<double>(other.count) / total);
+        squared_deviations += other.squared_deviations +
+                              delta * delta * (static_cast<double>(count) * static_cast<double>(other.count) / total);
+        count += other.count;
+    }
+
+    double SampleStatistics::variance() const {
+        return squared_deviations / static_cast<double>(count - 1);
+    }
+
+    double normal_quantile(double confidence) {
+        double lower = 0.0;
+        double upper = 40.0;
+        for (int iteration = 0; iteration < 100; ++iteration) {
+            const double middle = 0.5 * (lower + upper);
+            // P(|N(0, 1)| > z) = erfc(z / sqrt(2))
+            if (std::erfc(middle * 0.7071067811865476) > 1.0 - confidence) {
+                lower = middle;
+            } else {
+                upper = middle;
+            }
+        }
+        return 0.5 * (lower + upper);
+    }
+
+    void check_integration_arguments(const double *lower, const double *upper, size_t dimensions, size_t samples_count,
+                                     const IntegrationOptions &options) {
+        if (samples_count < 2) {
+            throw std::invalid_argument("At least two samples are required.");
+        }
+        for (size_t dimension = 0; dimension < dimensions; ++dimension) {
+            if (!(std::isfinite(lower[dimension]) && std::isfinite(upper[dimension]) &&
+                  lower[dimension] < upper[dimension])) {
+                throw std::invalid_argument("Domain lower bounds must be less than upper bounds.");
+            }
+        }
+        if (!(options.confidence > 0.0 && options.confidence < 1.0)) {
+            throw std::invalid_argument("Confidence must be in (0, 1).");
+        }
+        if (!(options.target_standard_error >= 0.0)) {
+            throw std::invalid_argument("Target standard error must be non-negative.");
+        }
+    }
+
+    IntegrationResult integrate_in_rounds(double volume, size_t samples_count, const IntegrationOptions &options,
+                                          const SampleAccumulator &accumulate) {
+        const bool by_error = options.target_standard_error > 0.0;
+        std::vector<SampleStatistics> thread_statistics(static_cast<size_t>(omp_get_max_threads()));
+        SampleStatistics total;
+        size_t round_samples = by_error ? std::min(samples_count, std::max<size_t>(2, options.first_round_samples)) :
+                               samples_count;
+        size_t rounds_count = 0;
+
+#pragma omp parallel default(none) shared(accumulate, samples_count, options, volume, by_error, thread_statistics, total, round_samples, rounds_count)
+        {
+            const auto threads_count = static_cast<size_t>(omp_get_num_threads());
+            const auto thread_number = static_cast<size_t>(omp_get_thread_num());
+            // у потоков непересекающиеся номера генераторов: зерно перемешивается целиком, номер потока прибавляется
+            XoshiroLanes generator(benchmark_library::splitmix64(options.seed) + thread_number * 2 * LANES);
+            SampleStatistics local;
+
+            while (round_samples > 0) {
+                // статическое разбиение, как у schedule(static)
+                const size_t local_samples = round_samples / threads_count +
+                                             (thread_number < round_samples % threads_count ? 1 : 0);
+                accumulate(generator, local_samples, local);
+                thread_statistics[thread_number] = local;
+#pragma omp barrier
+#pragma omp single
+                {
+                    total = SampleStatistics();
+                    for (const auto &statistics: thread_statistics) {
+                        total.merge(statistics);
+                    }
+                    ++rounds_count;
+                    const double standard_error = volume * std::sqrt(total.variance() / static_cast<double>(total.count));
+                    if (!by_error || standard_error <= options.target_standard_error || total.count >= samples_count) {
+                        round_samples = 0;
+                    } else {
+                        const double ratio = standard_error / options.target_standard_error;
+                        const double needed = 1.05 * static_cast<double>(total.count) * ratio * ratio;
+                        const auto remaining = static_cast<double>(samples_count - total.count);
+                        round_samples = static_cast<size_t>(std::min(remaining, needed - static_cast<double>(total.count)));
+                        round_samples = std::max(round_samples, std::min(samples_count - total.count,
+                                                                         options.first_round_samples));
+                    }
+                }
+            }
+        }
+
+        IntegrationResult result;
+        result.value = volume * total.mean;
+        result.standard_error = volume * std::sqrt(total.variance() / static_cast<double>(total.count));
+        const double half_width = normal_quantile(options.confidence) * result.standard_error;
+        result.confidence_lower = result.value - half_width;
+        result.confidence_upper = result.value + half_width;
+        result.samples_count = total.count;
+        result.rounds_count = rounds_count;
+        return result;
+    }
+}
@@ -0,0 +1,321 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_MONTECARLOINTEGRATION_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_MONTECARLOINTEGRATION_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "XoshiroLanes.h"
+
+namespace monte_carlo {
+
+    /**
+     * @brief Количество точек, которые генерируются и вычисляются за один раз: по четыре шага каждого генератора.
+     */
+    const size_t BATCH_SIZE = 4 * LANES;
+
+    /**
+     * @brief Область интегрирования - прямоугольный параллелепипед.
+     * @tparam Dim Размерность.
+     */
+    template <size_t Dim>
+    struct Domain {
+        /**
+         * Нижние границы по каждой координате.
+         */
+        std::array<double, Dim> lower{};
+
+        /**
+         * Верхние границы по каждой координате, больше нижних.
+         */
+        std::array<double, Dim> upper{};
+
+        /**
+         * @brief Объём области.
+         */
+        double volume() const {
+            double result = 1.0;
+            for (size_t dimension = 0; dimension < Dim; ++dimension) {
+                result *= upper[dimension] - lower[dimension];
+            }
+            return result;
+        }
+    };
+
+    /**
+     * @brief Единичный куб [0, 1]^Dim: интеграл по нему - математическое ожидание функции от Dim равномерных чисел.
+     */
+    template <size_t Dim>
+    Domain<Dim> unit_cube() {
+        Domain<Dim> domain;
+        domain.upper.fill(1.0);
+        return domain;
+    }
+
+    /**
+     * @brief Пачка из BATCH_SIZE точек, хранящаяся по координатам.
+     */
+    template <size_t Dim>
+    struct SampleBatch {
+        alignas(64) double coordinates[Dim][BATCH_SIZE];
+    };
+
+    /**
+     * @brief Точка пачки, которую получает интегрируемая функция: номер точки и указатель на пачку.
+     * @details Функция вызывается в векторизованном цикле по точкам пачки, и x[d] - это обращение к строке
+     * @details координат пачки, а не к копии точки в памяти. Поэтому функция должна принимать точку по значению:
+     * @details по ссылке компилятор кладёт её в память для каждой точки отдельно, и цикл остаётся скалярным.
+     */
+    template <size_t Dim>
+    class BatchPoint {
+    public:
+        BatchPoint(const SampleBatch<Dim> &batch, size_t index) : batch_(&batch), index_(index) {}
+
+        /**
+         * @brief Координата точки.
+         * @param dimension Номер координаты, меньше Dim.
+         */
+        double operator[](size_t dimension) const {
+            return batch_->coordinates[dimension][index_];
+        }
+
+        static constexpr size_t size() {
+            return Dim;
+        }
+
+    private:
+        const SampleBatch<Dim> *batch_;
+        size_t index_;
+    };
+
+    /**
+     * @brief Количество значений, их среднее и сумма квадратов отклонений от среднего (алгоритм Уэлфорда).
+     */
+    struct SampleStatistics {
+        /**
+         * Количество значений.
+         */
+        size_t count = 0;
+
+        /**
+         * Среднее.
+         */
+        double mean = 0.0;
+
+        /**
+         * Сумма квадратов отклонений от среднего.
+         */
+        double squared_deviations = 0.0;
+
+        /**
+         * @brief Добавить статистику по другой части значений (формулы Чана).
+         */
+        void merge(const SampleStatistics &other);
+
+        /**
+         * @brief Несмещённая оценка дисперсии значений, нужно хотя бы два значения.
+         */
+        double variance() const;
+    };
+
+    /**
+     * @brief Параметры интегрирования.
+     */
+    struct IntegrationOptions {
+        /**
+         * Остановиться, как только стандартная ошибка станет не больше этой; 0 - вычислить все точки.
+         */
+        double target_standard_error = 0.0;
+
+        /**
+         * Доверительная вероятность интервала.
+         */
+        double confidence = 0.95;
+
+        /**
+         * Зерно генераторов. Результат зависит от зерна и количества потоков.
+         */
+        uint64_t seed = 0;
+
+        /**
+         * Количество точек первого раунда при остановке по стандартной ошибке.
+         */
+        size_t first_round_samples = 1 << 20;
+    };
+
+    /**
+     * @brief Результат интегрирования.
+     */
+    struct IntegrationResult {
+        /**
+         * Оценка интеграла.
+         */
+        double value = 0.0;
+
+        /**
+         * Стандартная ошибка оценки.
+         */
+        double standard_error = 0.0;
+
+        /**
+         * Нижняя граница доверительного интервала.
+         */
+        double confidence_lower = 0.0;
+
+        /**
+         * Верхняя граница доверительного интервала.
+         */
+        double confidence_upper = 0.0;
+
+        /**
+         * Количество вычисленных точек.
+         */
+        size_t samples_count = 0;
+
+        /**
+         * Количество раундов.
+         */
+        size_t rounds_count = 0;
+    };
+
+    /**
+     * @brief Квантиль стандартного нормального распределения для двустороннего доверительного интервала.
+     * @details Делением отрезка пополам по erfc: вызывается один раз, скорость не важна.
+     * @param confidence Доверительная вероятность из (0, 1).
+     * @return z, при котором P(|N(0, 1)| <= z) = confidence.
+     */
+    double normal_quantile(double confidence);
+
+    /**
+     * @brief Ядро потока: вычислить функцию в заданном количестве точек генераторами потока и добавить к статистике.
+     */
+    using SampleAccumulator = std::function<void(XoshiroLanes &generator, size_t samples_count,
+                                                 SampleStatistics &statistics)>;
+
+    /**
+     * @brief Проверить параметры интегрирования, см. monte_carlo_integrate.
+     * @details Бросает std::invalid_argument. Вынесена из шаблона в MonteCarloIntegration.cpp, который собирается
+     * @details без -ffast-math: с ним компилятор считает, что NaN не бывает, и сравнения пропускают NaN.
+     * @param lower Нижние границы области.
+     * @param upper Верхние границы области.
+     * @param dimensions Размерность.
+     * @param samples_count Количество точек.
+     * @param options Параметры.
+     */
+    void check_integration_arguments(const double *lower, const double *upper, size_t dimensions, size_t samples_count,
+                                     const IntegrationOptions &options);
+
+    /**
+     * @brief Раунды интегрирования: параллельный вызов ядра, объединение статистик потоков и доверительный интервал.
+     * @details Не шаблон и собирается без -ffast-math, поэтому объединение статистик и интервал считаются
+     * @details в порядке, записанном в коде. С -ffast-math собираются только ядра с интегрируемыми функциями.
+     * @param volume Объём области.
+     * @param samples_count Количество точек (с target_standard_error - наибольшее).
+     * @param options Параметры.
+     * @param accumulate Ядро потока.
+     * @return Оценка, стандартная ошибка и доверительный интервал.
+     */
+    IntegrationResult integrate_in_rounds(double volume, size_t samples_count, const IntegrationOptions &options,
+                                          const SampleAccumulator &accumulate);
+
+    /**
+     * @brief Вычислить функцию в samples_count случайных точках области и добавить значения к статистике.
+     * @details Ядро потока: пачка координат генерируется всеми генераторами сразу, затем функция вычисляется
+     * @details векторизованным циклом по точкам пачки, среднее и сумма квадратов отклонений пачки добавляются
+     * @details к статистике потока. Если samples_count не кратно BATCH_SIZE, лишние точки последней пачки
+     * @details вычисляются, но не учитываются.
+     * @param integrand Функция от BatchPoint<Dim> по значению, возвращающая double.
+     * @param generator Генераторы потока, состояние продвигается.
+     * @param domain Область.
+     * @param samples_count Количество точек.
+     * @param statistics Статистика потока.
+     */
+    template <size_t Dim, typename Integrand>
+    MONTE_CARLO_TARGET_CLONES
+    void accumulate_samples(const Integrand &integrand, XoshiroLanes &generator, const Domain<Dim> &domain,
+                            size_t samples_count, SampleStatistics &statistics) {
+        uint32_t s0[LANES], s1[LANES], s2[LANES], s3[LANES];
+        std::copy_n(generator.s0, LANES, s0);
+        std::copy_n(generator.s1, LANES, s1);
+        std::copy_n(generator.s2, LANES, s2);
+        std::copy_n(generator.s3, LANES, s3);
+
+        SampleBatch<Dim> batch;
+        alignas(64) double values[BATCH_SIZE];
+        for (size_t first_sample = 0; first_sample < samples_count; first_sample += BATCH_SIZE) {
+            for (size_t dimension = 0; dimension < Dim; ++dimension) {
+                const double lower = domain.lower[dimension];
+                const double width = domain.upper[dimension] - lower;
+                double *row = batch.coordinates[dimension];
+                for (size_t step = 0; step < BATCH_SIZE; step += LANES) {
+#pragma omp simd
+                    for (size_t lane = 0; lane < LANES; ++lane) {
+                        row[step + lane] = lower + width * XoshiroLanes::to_unit(
+                                XoshiroLanes::next(s0[lane], s1[lane], s2[lane], s3[lane]));
+                    }
+                }
+            }
+
+            const size_t active = std::min(BATCH_SIZE, samples_count - first_sample);
+            double sum = 0.0;
+#pragma omp simd reduction(+:sum)
+            for (size_t i = 0; i < BATCH_SIZE; ++i) {
+                const double value = integrand(BatchPoint<Dim>(batch, i));
+                values[i] = value;
+                sum += i < active ? value : 0.0;
+            }
+            SampleStatistics batch_statistics;
+            batch_statistics.count = active;
+            batch_statistics.mean = sum / static_cast<double>(active);
+            double squared_deviations = 0.0;
+#pragma omp simd reduction(+:squared_deviations)
+            for (size_t i = 0; i < BATCH_SIZE; ++i) {
+                const double deviation = values[i] - batch_statistics.mean;
+                squared_deviations += i < active ? deviation * deviation : 0.0;
+            }
+            batch_statistics.squared_deviations = squared_deviations;
+            statistics.merge(batch_statistics);
+        }
+
+        std::copy_n(s0, LANES, generator.s0);
+        std::copy_n(s1, LANES, generator.s1);
+        std::copy_n(s2, LANES, generator.s2);
+        std::copy_n(s3, LANES, generator.s3);
+    }
+
+    /**
+     * @brief Интеграл функции по области методом Монте-Карло.
+     * @details Вычисление производится параллельно. Используется OMP. У каждого потока свои LANES генераторов
+     * @details (XoshiroLanes) и своя статистика значений (среднее и сумма квадратов отклонений), после каждого
+     * @details раунда статистики потоков объединяются в порядке номеров потоков. Интеграл - объём области,
+     * @details умноженный на среднее, стандартная ошибка - объём, умноженный на sqrt(дисперсия / n).
+     * @details Без target_standard_error один раунд из samples_count точек. С ним первый раунд -
+     * @details first_round_samples точек, после каждого раунда по текущей дисперсии оценивается, сколько
+     * @details точек нужно для заданной ошибки (ошибка убывает как 1 / sqrt(n)), и следующий раунд добирает их
+     * @details с запасом 5%; samples_count - наибольшее количество точек.
+     * @details Бросает std::invalid_argument, если точек меньше двух, границы области не упорядочены,
+     * @details доверительная вероятность не из (0, 1) или целевая ошибка отрицательна (NaN тоже отвергается).
+     * @details Ядро (accumulate_samples) создаётся в единице трансляции вызывающего, раунды - integrate_in_rounds.
+     * @details Функция вызывается в векторизованном цикле, поэтому должна быть без ветвлений: условия - через
+     * @details тернарный оператор, математические функции векторизуются библиотекой glibc (libmvec) с -ffast-math.
+     * @tparam Dim Размерность, известна при компиляции: цикл по координатам внутри функции разворачивается.
+     * @param integrand Функция от BatchPoint<Dim> по значению, возвращающая double.
+     * @param domain Область.
+     * @param samples_count Количество точек (с target_standard_error - наибольшее).
+     * @param options Параметры.
+     * @return Оценка, стандартная ошибка и доверительный интервал.
+     */
+    template <size_t Dim, typename Integrand>
+    IntegrationResult monte_carlo_integrate(const Integrand &integrand, const Domain<Dim> &domain, size_t samples_count,
+                                            const IntegrationOptions &options = IntegrationOptions()) {
+        check_integration_arguments(domain.lower.data(), domain.upper.data(), Dim, samples_count, options);
+        return integrate_in_rounds(domain.volume(), samples_count, options, [&integrand, &domain](
+                XoshiroLanes &generator, size_t local_samples, SampleStatistics &statistics) {
+            accumulate_samples(integrand, generator, domain, local_samples, statistics);
+        });
+    }
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_MONTECARLOINTEGRATION_H
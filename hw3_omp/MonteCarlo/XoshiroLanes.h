@@ -0,0 +1,88 @@
+#ifndef HIGHPERFOMANCECOMPUTINGHOMEWORKS_XOSHIROLANES_H
+#define HIGHPERFOMANCECOMPUTINGHOMEWORKS_XOSHIROLANES_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SplitMix.h"
+
+/**
+ * Ядра, которые шагают генераторами, компилируются в вариантах для AVX-512, AVX2 и базового x86-64, нужный выбирается при запуске.
+ * Без этого сборка под базовый x86-64 обрабатывает по четыре 32-битных числа за инструкцию вместо шестнадцати.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define MONTE_CARLO_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define MONTE_CARLO_TARGET_CLONES
+#endif
+
+namespace monte_carlo {
+
+    /**
+     * @brief Количество независимых генераторов, которые шагают одновременно: 16 32-битных чисел - один регистр AVX-512.
+     */
+    const size_t LANES = 16;
+
+    /**
+     * @brief Шестнадцать независимых генераторов xoshiro128+, хранящиеся по столбцам.
+     * @details xoshiro128+ - только сложения, сдвиги и исключающие или над 32-битными словами, поэтому шаг всех
+     * @details генераторов сразу векторизуется без 64-битных умножений. Младшие биты xoshiro128+ слабые,
+     * @details координаты точек берутся из старших 24 бит.
+     */
+    struct XoshiroLanes {
+        alignas(64) uint32_t s0[LANES];
+        alignas(64) uint32_t s1[LANES];
+        alignas(64) uint32_t s2[LANES];
+        alignas(64) uint32_t s3[LANES];
+
+        /**
+         * @brief Инициализировать состояния генераторов.
+         * @details Состояние каждого генератора - выход splitmix64 от зерна и номера генератора.
+         * @param seed Зерно. У разных потоков должно быть разным.
+         */
+        explicit XoshiroLanes(uint64_t seed) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                uint64_t first = benchmark_library::splitmix64(seed + 2 * lane);
+                uint64_t second = benchmark_library::splitmix64(seed + 2 * lane + 1);
+                s0[lane] = static_cast<uint32_t>(first);
+                s1[lane] = static_cast<uint32_t>(first >> 32);
+                s2[lane] = static_cast<uint32_t>(second);
+                s3[lane] = static_cast<uint32_t>(second >> 32) | 1u;  // состояние не должно быть нулевым
+            }
+        }
+
+        /**
+         * @brief Шаг одного генератора.
+         * @return Случайное 32-битное число.
+         */
+        static inline uint32_t next(uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d) {
+            const uint32_t result = a + d;
+            const uint32_t t = b << 9;
+            c ^= a;
+            d ^= b;
+            b ^= c;
+            a ^= d;
+            c ^= t;
+            d = (d << 11) | (d >> 21);
+            return result;
+        }
+
+        /**
+         * @brief Координата на [-1, 1) из старших 24 бит: преобразование в float точное.
+         */
+        static inline float to_coordinate(uint32_t bits) {
+            return static_cast<float>(static_cast<int32_t>(bits) >> 8) * 0x1p-23f;
+        }
+
+        /**
+         * @brief Число из (0, 1) из старших 24 бит: середина одного из 2^24 равных отрезков.
+         * @details Ноль и единица не выпадают, поэтому логарифм от числа всегда конечен. Сетка из середин отрезков
+         * @details смещает среднее гладкой функции на O(2^-48) - много меньше статистической ошибки.
+         */
+        static inline double to_unit(uint32_t bits) {
+            return (static_cast<double>(static_cast<int32_t>(bits >> 8)) + 0.5) * 0x1p-24;
+        }
+    };
+}
+
+#endif //HIGHPERFOMANCECOMPUTINGHOMEWORKS_XOSHIROLANES_H
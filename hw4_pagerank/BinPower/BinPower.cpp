@@ -1,7 +1,5 @@
 #include <cassert>
 #include <iostream>
-#include <iomanip>
-#include <chrono>
 #include <omp.h>
 
 namespace Eigen {
@@ -18,6 +16,8 @@ namespace Eigen {
 
 #include "Matrix.h"
 #include "MatrixMultiplier.h"
+#include "Scaling.h"
+#include "Tracing.h"
 
 
 /**
@@ -111,40 +111,15 @@ gmm::row_matrix<gmm::wsvector<float>> convert_my_matrix_to_gmm_csc_matrix(const
     return res;
 }
 
-/**
- * @brief Конвертирует количество микросекунд в человекопонятный формат.
- * @param duration_us Длительность в микросекундах.
- * @return Строка с человекопонятной записью.
- */
-std::string convert_us_to_human_readable(uint64_t duration_us){
-    if (duration_us < 1e3) {
-        return std::to_string(duration_us) + " us";
-    }
-
-    std::stringstream ss;
-    ss << std::fixed;
-    ss << std::setprecision(2);
-    if (duration_us < 1e6) {
-        ss << static_cast<double>(duration_us) / 1e3 << " ms";
-        return ss.str();
-    }
-    if (duration_us < 1e9) {
-        ss << static_cast<double>(duration_us) / 1e6 << " s";
-        return ss.str();
-    }
-    if (duration_us < 1e9 * 60) {
-        ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
-        return ss.str();
-    }
-
-    return std::to_string(duration_us) + " us";
-}
-
 int main(int argc, char *argv[]) {
     size_t nodes_count = 8;
     uint64_t steps_count = 4;
     float edge_probability = 0.2f;
     bool need_print = false;
+
+    std::vector<size_t> threads_counts;
+    bool scaling = benchmark_library::handle_scaling_option(argc, argv, threads_counts);
+
     for(int i = 1; i < argc; ++i) {
         std::string parameter_name(argv[i]);
         if (parameter_name == "-h") {
@@ -152,11 +127,13 @@ int main(int argc, char *argv[]) {
 Возводит случайную матрицу смежности направленного неориентированного графа в указанную степень.
 Может использоваться для поиска количества путей заданной длины в графе.
 Использование:
-BinPower [-n <количество_узлов>] [-s <длина_пути>] [-p <вероятность_ребра>] [-v]
+BinPower [-n <количество_узлов>] [-s <длина_пути>] [-p <вероятность_ребра>] [-v] [--scaling[=<потоки>]]
 Параметр -n - это количество узлов в графе.
 Парамет -s - это количество шагов по графу, которое мы сделаем из каждой вершины.
 Параметр -p - это вероятность того, что между двумя узлами появляется ребро.
 Параметр -v - если нужно напечатать матрицы на экран.
+Параметр --scaling - исследование масштабируемости: перебор количества потоков (по умолчанию от 1 до количества ядер)
+  с привязкой потоков к ядрам, печатаются ускорение, эффективность и метрика Карпа-Флэтта.
 Все параметры необязательные.
 Параметры по умолчанию:
 BinPower -n 8 -s 4 -p 0.2
@@ -183,21 +160,35 @@ BinPower -n 8 -s 4 -p 0.2
         graph.print();
     }
 
-    std::cout << "Умножаем с помощью openblas." << std::endl;
+    if (scaling) {
+        omp_set_dynamic(0);
+        Eigen::setNbThreads(0);
+        auto graph_eigen = convert_my_matrix_to_eigen_sparse_matrix(graph);
+        benchmark_library::ScalingStudy study(matrix_library::set_threads_count, threads_counts);
+        study.run("binpow_cblas", nodes_count, 0.0, 0.0, [&]() {
+            auto after_several_steps = binpow_cblas(graph, steps_count);
+        });
+        study.run("binpow_eigen", nodes_count, 0.0, 0.0, [&]() {
+            auto after_several_steps_eigen = binpow_sparse_eigen(graph_eigen, steps_count);
+        });
+        study.write();
+        return 0;
+    }
+
+    std::cout << "Умножаем с помощью BLAS (" << matrix_library::BlasBackend::instance().get_name() << ")." << std::endl;
 
-    std::cout << "Количество используемых ядер: " << openblas_get_num_procs() << std::endl;
-    openblas_set_num_threads(openblas_get_num_procs());
+    std::cout << "Количество используемых ядер: " << omp_get_num_procs() << std::endl;
+    matrix_library::set_threads_count(omp_get_num_procs());
 
-    auto begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer binpow_cblas_timer("binpow_cblas");
     auto after_several_steps = binpow_cblas(graph, steps_count);
-    auto end = std::chrono::steady_clock::now();
-    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+    auto elapsed_us = binpow_cblas_timer.stop();
 
     if (need_print) {
         after_several_steps.print();
     }
 
-    std::cout << "Возведение матрицы в степень заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl << std::endl;
+    std::cout << "Возведение матрицы в степень заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl << std::endl;
 
     std::cout << "Умножаем с помощью eigen (для разреженных матриц)." << std::endl;
     std::cout << "Количество используемых ядер: " << omp_get_num_procs() << std::endl;
@@ -205,30 +196,28 @@ BinPower -n 8 -s 4 -p 0.2
     Eigen::setNbThreads(0);
 
     auto graph_eigen = convert_my_matrix_to_eigen_sparse_matrix(graph);
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer binpow_sparse_eigen_timer("binpow_sparse_eigen");
     auto after_several_steps_eigen = binpow_sparse_eigen(graph_eigen, steps_count);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+    elapsed_us = binpow_sparse_eigen_timer.stop();
 
     if (need_print) {
         std::cout << after_several_steps_eigen << std::endl;
     }
 
-    std::cout << "Возведение матрицы в степень заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl << std::endl;
+    std::cout << "Возведение матрицы в степень заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl << std::endl;
 
     std::cout << "Умножаем с помощью GMM++ (для разреженных матриц)." << std::endl;
 
     auto graph_gmm = convert_my_matrix_to_gmm_csc_matrix(graph);
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer binpow_sparse_gmm_timer("binpow_sparse_gmm");
     auto after_several_steps_gmm = binpow_sparse_gmm(graph_gmm, steps_count);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+    elapsed_us = binpow_sparse_gmm_timer.stop();
 
     if (need_print) {
         std::cout << after_several_steps_gmm << std::endl;
     }
 
-    std::cout << "Возведение матрицы в степень заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl << std::endl;
+    std::cout << "Возведение матрицы в степень заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl << std::endl;
 
     return 0;
 }
\ No newline at end of file
@@ -1,7 +1,5 @@
 #include <cassert>
 #include <iostream>
-#include <iomanip>
-#include <chrono>
 #include <omp.h>
 
 /**
@@ -22,6 +20,8 @@ namespace Eigen {
 
 #include "Matrix.h"
 #include "MatrixMultiplier.h"
+#include "Scaling.h"
+#include "Tracing.h"
 
 /**
  * @brief Подготовка матрицы для метода простых итераций.
@@ -260,50 +260,26 @@ std::vector<float> damping_pagerank_gmm(const gmm::dense_matrix<float>& prepared
     return pr;
 }
 
-/**
- * @brief Конвертирует количество микросекунд в человекопонятный формат.
- * @param duration_us Длительность в микросекундах.
- * @return Строка с человекопонятной записью.
- */
-std::string convert_us_to_human_readable(uint64_t duration_us){
-    if (duration_us < 1e3) {
-        return std::to_string(duration_us) + " us";
-    }
-
-    std::stringstream ss;
-    ss << std::fixed;
-    ss << std::setprecision(2);
-    if (duration_us < 1e6) {
-        ss << static_cast<double>(duration_us) / 1e3 << " ms";
-        return ss.str();
-    }
-    if (duration_us < 1e9) {
-        ss << static_cast<double>(duration_us) / 1e6 << " s";
-        return ss.str();
-    }
-    if (duration_us < 1e9 * 60) {
-        ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
-        return ss.str();
-    }
-
-    return std::to_string(duration_us) + " us";
-}
-
 int main(int argc, char *argv[]) {
     size_t nodes_count = 8;
     float edge_probability = 0.3f;
     bool need_print = false;
 
+    std::vector<size_t> threads_counts;
+    bool scaling = benchmark_library::handle_scaling_option(argc, argv, threads_counts);
+
     for(int i = 1; i < argc; ++i) {
         std::string parameter_name(argv[i]);
         if (parameter_name == "-h") {
             std::cout << R"str(
 Генерирует случайный граф связей между страницами и рассчитывает PageRank разными способами.
 Использование:
-PageRank [-n <количество_узлов>] [-p <вероятность_ребра>] [-v]
+PageRank [-n <количество_узлов>] [-p <вероятность_ребра>] [-v] [--scaling[=<потоки>]]
 Параметр -n - это количество узлов в графе.
 Параметр -p - это вероятность того, что между двумя узлами появляется ребро.
 Параметр -v - если нужно напечатать матрицы на экран.
+Параметр --scaling - исследование масштабируемости: перебор количества потоков (по умолчанию от 1 до количества ядер)
+  с привязкой потоков к ядрам, печатаются ускорение, эффективность и метрика Карпа-Флэтта.
 Все параметры необязательные.
 Параметры по умолчанию:
 PageRank -n 8 -p 0.3
@@ -324,11 +300,10 @@ PageRank -n 8 -p 0.3
         }
     }
 
-    std::cout << "Устанавливаем количество потоков для omp и openblas." << std::endl;
+    std::cout << "Устанавливаем количество потоков для omp и BLAS (" << matrix_library::BlasBackend::instance().get_name() << ")." << std::endl;
     std::cout << "Количество используемых ядер: " << omp_get_num_procs() << std::endl << std::endl;
-    openblas_set_num_threads(openblas_get_num_procs());
     omp_set_dynamic(0);
-    omp_set_num_threads(omp_get_num_procs());
+    matrix_library::set_threads_count(omp_get_num_procs());
     Eigen::setNbThreads(0);
 
     std::cout << "Везде далее коэффициент демпфирования равен 0.85." << std::endl;
@@ -340,51 +315,59 @@ PageRank -n 8 -p 0.3
         graph.print();
     }
 
+    if (scaling) {
+        auto prepared_graph_iterations = prepare_graph_for_iterations(graph);
+        benchmark_library::ScalingStudy study(matrix_library::set_threads_count, threads_counts);
+        study.run("naive_pr", nodes_count, 0.0, 0.0, [&]() {
+            auto naive_pr_iterations = naive_pagerank_iterations(prepared_graph_iterations);
+        });
+        study.run("damping_pr", nodes_count, 0.0, 0.0, [&]() {
+            auto damping_pr_iterations = damping_pagerank_iterations(prepared_graph_iterations);
+        });
+        study.write();
+        return 0;
+    }
+
     std::cout << "Численное решение СЛАУ(метод простых итераций)." << std::endl;
 
-    auto begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer prepare_graph_for_iterations_timer("prepare_graph_for_iterations");
     auto prepared_graph_iterations = prepare_graph_for_iterations(graph);
-    auto end = std::chrono::steady_clock::now();
-    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Подготовка матрицы для метода простых итераций заняла " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    auto elapsed_us = prepare_graph_for_iterations_timer.stop();
+    std::cout << "Подготовка матрицы для метода простых итераций заняла " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Матрица для метода простых итераций: " << std::endl;
         prepared_graph_iterations.print();
     }
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer naive_pagerank_iterations_timer("naive_pagerank_iterations");
     auto naive_pr_iterations = naive_pagerank_iterations(prepared_graph_iterations);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Решение методом простых итераций для упрощённого pr заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = naive_pagerank_iterations_timer.stop();
+    std::cout << "Решение методом простых итераций для упрощённого pr заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Результат метода простых итераций для упрощённого pr: " << std::endl;
         naive_pr_iterations.print();
     }
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer damping_pagerank_iterations_timer("damping_pagerank_iterations");
     auto damping_pr_iterations = damping_pagerank_iterations(prepared_graph_iterations);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Решение методом простых итераций для демпингованного pr заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = damping_pagerank_iterations_timer.stop();
+    std::cout << "Решение методом простых итераций для демпингованного pr заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Результат метода простых итераций для демпингованного pr: " << std::endl;
         damping_pr_iterations.print();
     }
 
     std::cout << "Строгое решение СЛАУ." << std::endl;
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer prepare_graph_for_eigen_naive_timer("prepare_graph_for_eigen_naive");
     auto prepared_graph_eigen = prepare_graph_for_eigen_naive(graph);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Подготовка матрицы для строгого решения СЛАУ упрощённого pr заняла " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = prepare_graph_for_eigen_naive_timer.stop();
+    std::cout << "Подготовка матрицы для строгого решения СЛАУ упрощённого pr заняла " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Матрица коэффициентов линейной системы для упрощённого PR: " << std::endl;
         std::cout << prepared_graph_eigen << std::endl << std::endl;
     }
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer naive_pagerank_eigen_timer("naive_pagerank_eigen");
     auto naive_pr_eigen = naive_pagerank_eigen(prepared_graph_eigen);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Решение СЛАУ для упрощённого pr с помощью eigen заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = naive_pagerank_eigen_timer.stop();
+    std::cout << "Решение СЛАУ для упрощённого pr с помощью eigen заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Результат решения СЛАУ eigen для упрощённого pr: " << std::endl;
         std::cout << naive_pr_eigen << std::endl << std::endl;
@@ -392,30 +375,27 @@ PageRank -n 8 -p 0.3
                      "В демпингованном pr для обхода этой проблемы даже страницы, на которые никто не ссылается, имеют ненулевой pr. " << std::endl;
     }
 
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer prepare_graph_for_eigen_damping_timer("prepare_graph_for_eigen_damping");
     auto prepared_graph_eigen_damping = prepare_graph_for_eigen_damping(graph);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Подготовка матрицы для строгого решения СЛАУ демпингованного pr заняла " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = prepare_graph_for_eigen_damping_timer.stop();
+    std::cout << "Подготовка матрицы для строгого решения СЛАУ демпингованного pr заняла " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Матрица коэффициентов линейной системы для демпингованного PR: " << std::endl;
         std::cout << prepared_graph_eigen_damping << std::endl << std::endl;
     }
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer damping_pagerank_eigen_timer("damping_pagerank_eigen");
     auto damping_pr_eigen = damping_pagerank_eigen(prepared_graph_eigen_damping);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Решение СЛАУ для демпингованного pr с помощью eigen заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = damping_pagerank_eigen_timer.stop();
+    std::cout << "Решение СЛАУ для демпингованного pr с помощью eigen заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Результат решения СЛАУ eigen для демпингованного pr: " << std::endl;
         std::cout << damping_pr_eigen << std::endl << std::endl;
     }
     auto prepared_graph_gmm = prepare_graph_for_gmm_damping(graph);
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer damping_pagerank_gmm_timer("damping_pagerank_gmm");
     auto damping_pr_gmm = damping_pagerank_gmm(prepared_graph_gmm);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Решение СЛАУ для демпингованного pr с помощью gmm++ заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = damping_pagerank_gmm_timer.stop();
+    std::cout << "Решение СЛАУ для демпингованного pr с помощью gmm++ заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Результат решения СЛАУ gmm для демпингованного pr: " << std::endl;
         for(auto num: damping_pr_gmm) {
@@ -1,12 +1,12 @@
 #include <cassert>
 #include <iostream>
-#include <iomanip>
-#include <chrono>
 #include <functional>
 #include <omp.h>
 
 #include "Matrix.h"
 #include "MatrixMultiplier.h"
+#include "Scaling.h"
+#include "Tracing.h"
 
 /**
  * @brief Подготовка матрицы для метода простых итераций.
@@ -49,50 +49,26 @@ matrix_library::Matrix simrank_iterations(const matrix_library::Matrix& prepared
     return sr_current;
 }
 
-/**
- * @brief Конвертирует количество микросекунд в человекопонятный формат.
- * @param duration_us Длительность в микросекундах.
- * @return Строка с человекопонятной записью.
- */
-std::string convert_us_to_human_readable(uint64_t duration_us){
-    if (duration_us < 1e3) {
-        return std::to_string(duration_us) + " us";
-    }
-
-    std::stringstream ss;
-    ss << std::fixed;
-    ss << std::setprecision(2);
-    if (duration_us < 1e6) {
-        ss << static_cast<double>(duration_us) / 1e3 << " ms";
-        return ss.str();
-    }
-    if (duration_us < 1e9) {
-        ss << static_cast<double>(duration_us) / 1e6 << " s";
-        return ss.str();
-    }
-    if (duration_us < 1e9 * 60) {
-        ss << static_cast<double>(duration_us) / 1e6 / 60 << " min";
-        return ss.str();
-    }
-
-    return std::to_string(duration_us) + " us";
-}
-
 int main(int argc, char *argv[]) {
     size_t nodes_count = 8;
     float edge_probability = 0.3f;
     bool need_print = false;
 
+    std::vector<size_t> threads_counts;
+    bool scaling = benchmark_library::handle_scaling_option(argc, argv, threads_counts);
+
     for(int i = 1; i < argc; ++i) {
         std::string parameter_name(argv[i]);
         if (parameter_name == "-h") {
             std::cout << R"str(
 Генерирует случайный граф связей между объектами и рассчитывает SimRank итерационным методом.
 Использование:
-SimRank [-n <количество_узлов>] [-p <вероятность_ребра>] [-v]
+SimRank [-n <количество_узлов>] [-p <вероятность_ребра>] [-v] [--scaling[=<потоки>]]
 Параметр -n - это количество узлов в графе.
 Параметр -p - это вероятность того, что между двумя узлами появляется ребро.
 Параметр -v - если нужно напечатать матрицы на экран.
+Параметр --scaling - исследование масштабируемости: перебор количества потоков (по умолчанию от 1 до количества ядер)
+  с привязкой потоков к ядрам, печатаются ускорение, эффективность и метрика Карпа-Флэтта.
 Все параметры необязательные.
 Параметры по умолчанию:
 SimRank -n 8 -p 0.3
@@ -113,11 +89,10 @@ SimRank -n 8 -p 0.3
         }
     }
 
-    std::cout << "Устанавливаем количество потоков для omp и openblas." << std::endl;
+    std::cout << "Устанавливаем количество потоков для omp и BLAS (" << matrix_library::BlasBackend::instance().get_name() << ")." << std::endl;
     std::cout << "Количество используемых ядер: " << omp_get_num_procs() << std::endl << std::endl;
-    openblas_set_num_threads(openblas_get_num_procs());
     omp_set_dynamic(0);
-    omp_set_num_threads(omp_get_num_procs());
+    matrix_library::set_threads_count(omp_get_num_procs());
 
     matrix_library::Matrix graph(nodes_count, nodes_count);
     graph.initialize_random_directed_unweighted_graph(edge_probability);
@@ -126,22 +101,30 @@ SimRank -n 8 -p 0.3
         graph.print();
     }
 
+    if (scaling) {
+        auto prepared_graph_iterations = prepare_graph_for_iterations(graph);
+        benchmark_library::ScalingStudy study(matrix_library::set_threads_count, threads_counts);
+        study.run("simrank_iterations", nodes_count, 0.0, 0.0, [&]() {
+            auto simrank = simrank_iterations(prepared_graph_iterations);
+        });
+        study.write();
+        return 0;
+    }
+
     std::cout << "Численное решение (метод простых итераций)." << std::endl;
 
-    auto begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer prepare_graph_for_iterations_timer("prepare_graph_for_iterations");
     auto prepared_graph_iterations = prepare_graph_for_iterations(graph);
-    auto end = std::chrono::steady_clock::now();
-    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Подготовка матрицы для метода простых итераций заняла " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    auto elapsed_us = prepare_graph_for_iterations_timer.stop();
+    std::cout << "Подготовка матрицы для метода простых итераций заняла " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Матрица для метода простых итераций: " << std::endl;
         prepared_graph_iterations.print();
     }
-    begin = std::chrono::steady_clock::now();
+    tracing_library::ScopedTimer simrank_iterations_timer("simrank_iterations");
     auto simrank = simrank_iterations(prepared_graph_iterations);
-    end = std::chrono::steady_clock::now();
-    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    std::cout << "Решение методом простых итераций заняло " << convert_us_to_human_readable(elapsed_us.count()) << "." << std::endl;
+    elapsed_us = simrank_iterations_timer.stop();
+    std::cout << "Решение методом простых итераций заняло " << tracing_library::convert_us_to_human_readable(elapsed_us) << "." << std::endl;
     if (need_print) {
         std::cout << "Результат метода простых итераций: " << std::endl;
         simrank.print();